@@ -0,0 +1,188 @@
+# Performance benchmark of the bundled examples (data/*.a2d) and test scripts (data/scripts/test).
+#
+# Every model is solved at several numbers of refinements and polynomial orders. Wall time,
+# phases of the solve, DOFs, peak memory and norm of the solution (checksum) are written to JSON
+# and compared with the baseline.
+#
+# run from the root directory of Agros2D:
+#   agros2d -run data/scripts/benchmark/benchmark.py
+#
+# settings (environment variables):
+#   BENCHMARK_DATA        - directory with *.a2d files (data)
+#   BENCHMARK_TESTS       - directory with test scripts (data/scripts/test)
+#   BENCHMARK_REFINEMENTS - numbers of refinements (0,1)
+#   BENCHMARK_ORDERS      - polynomial orders (1,2,3)
+#   BENCHMARK_REPEAT      - number of repeated solves, the fastest one is taken (3)
+#   BENCHMARK_OUTPUT      - output file (benchmark.json)
+#   BENCHMARK_BASELINE    - baseline file (none)
+#   BENCHMARK_TOLERANCE   - relative tolerance of the time (0.1)
+#   BENCHMARK_QUIT        - quit Agros2D after the benchmark (0)
+#
+# memory is the high water mark of the case (the peak is reset before every case on Linux,
+# elsewhere the case is recorded without the memory)
+
+import os
+import glob
+import time
+import json
+
+def env(name, default):
+	return os.environ.get(name, default)
+
+def envlist(name, default):
+	return [int(item) for item in env(name, default).split(",")]
+
+dataDir = env("BENCHMARK_DATA", "data")
+testsDir = env("BENCHMARK_TESTS", os.path.join("data", "scripts", "test"))
+refinements = envlist("BENCHMARK_REFINEMENTS", "0,1")
+orders = envlist("BENCHMARK_ORDERS", "1,2,3")
+repeat = int(env("BENCHMARK_REPEAT", "3"))
+outputFile = env("BENCHMARK_OUTPUT", "benchmark.json")
+baselineFile = env("BENCHMARK_BASELINE", "")
+tolerance = float(env("BENCHMARK_TOLERANCE", "0.1"))
+
+# differences below this time (s) are considered to be noise
+timeMin = 0.02
+# relative tolerance of the norm of the solution
+normTolerance = 1e-6
+
+solveAgros = solve
+
+def resetMemoryPeak():
+	# high water mark of the process (VmHWM) is reset by "5" written to clear_refs
+	try:
+		file = open("/proc/self/clear_refs", "w")
+		file.write("5")
+		file.close()
+		return True
+	except IOError:
+		return False
+
+def measure():
+	isReset = resetMemoryPeak()
+
+	best = None
+	for i in range(repeat):
+		start = time.time()
+		solveAgros()
+		wall = time.time() - start
+
+		info = solveinfo()
+		if (best == None or wall < best["time"]):
+			best = { "time" : wall, "info" : info }
+
+	# peak of all repeated solves of the case
+	if (isReset and "memory peak [MB]" in info):
+		best["memory"] = info["memory peak [MB]"]
+
+	return best
+
+def record(results, key, refinement, order):
+	try:
+		result = measure()
+	except Exception, e:
+		result = { "error" : str(e) }
+
+	result["refinements"] = refinement
+	result["order"] = order
+	results[key] = result
+
+	if ("error" in result):
+		print(key + ": " + result["error"])
+	else:
+		print("%s: %.3f s, %i DOFs, %.1f MB" % (key, result["time"], result["info"].get("dofs", 0), result.get("memory", 0.0)))
+
+def benchmarkDocument(results, fileName, refinement, order):
+	opendocument(fileName)
+	discretization(refinement, order)
+	record(results, "%s/r%i/p%i" % (os.path.basename(fileName), refinement, order), refinement, order)
+
+def benchmarkScript(results, fileName, refinement, order):
+	# every solve() of the script is measured
+	solves = [0]
+	def solveScript():
+		solves[0] += 1
+		discretization(refinement, order)
+		record(results, "%s#%i/r%i/p%i" % (os.path.basename(fileName), solves[0], refinement, order), refinement, order)
+
+	# accuracy is not tested at other discretizations
+	def testScript(text, value, normal, error = 0.03):
+		return True
+
+	namespace = dict(globals())
+	namespace["solve"] = solveScript
+	namespace["test"] = testScript
+	namespace["__file__"] = fileName
+	try:
+		execfile(fileName, namespace)
+	except Exception, e:
+		print(os.path.basename(fileName) + ": " + str(e))
+
+def compare(results, baseline):
+	comparison = []
+	for key in sorted(results.keys()):
+		result = results[key]
+		if ("error" in result):
+			comparison.append({ "case" : key, "status" : "error" })
+			continue
+		if (not key in baseline or "error" in baseline[key]):
+			comparison.append({ "case" : key, "status" : "new" })
+			continue
+
+		reference = baseline[key]
+		status = "ok"
+		if (result["info"].get("dofs") != reference["info"].get("dofs")):
+			status = "dofs"
+		elif (abs(result["info"]["norm"] - reference["info"]["norm"]) > normTolerance * abs(reference["info"]["norm"])):
+			status = "norm"
+		elif (result["time"] - reference["time"] > max(tolerance * reference["time"], timeMin)):
+			status = "slower"
+		elif (reference["time"] - result["time"] > max(tolerance * reference["time"], timeMin)):
+			status = "faster"
+
+		ratio = 0.0
+		if (reference["time"] > 0.0):
+			ratio = result["time"] / reference["time"]
+		item = { "case" : key, "status" : status, "time" : result["time"], "baseline" : reference["time"], "ratio" : ratio }
+		if ("memory" in result and "memory" in reference):
+			item["memory"] = result["memory"]
+			item["memoryBaseline"] = reference["memory"]
+		comparison.append(item)
+
+	return comparison
+
+# run
+results = {}
+for refinement in refinements:
+	for order in orders:
+		for fileName in sorted(glob.glob(os.path.join(dataDir, "*.a2d"))):
+			benchmarkDocument(results, fileName, refinement, order)
+		for fileName in sorted(glob.glob(os.path.join(testsDir, "test_*.py"))):
+			benchmarkScript(results, fileName, refinement, order)
+
+output = { "version" : version(), "date" : time.strftime("%Y-%m-%d %H:%M:%S"), "repeat" : repeat, "cases" : results }
+
+# baseline
+isOk = True
+if (baselineFile != ""):
+	baseline = json.load(open(baselineFile))["cases"]
+	comparison = compare(results, baseline)
+	output["comparison"] = comparison
+
+	for item in comparison:
+		if (item["status"] in ["ok", "new"]):
+			continue
+		if (item["status"] in ["error", "dofs", "norm", "slower"]):
+			isOk = False
+		if ("ratio" in item):
+			print("%s: %s (%.3f s / %.3f s = %.2f)" % (item["case"], item["status"], item["time"], item["baseline"], item["ratio"]))
+		else:
+			print("%s: %s" % (item["case"], item["status"]))
+
+output["ok"] = isOk
+json.dump(output, open(outputFile, "w"), indent = 1, sort_keys = True)
+
+print("Benchmark: " + str(isOk) + " (" + outputFile + ")")
+
+if (env("BENCHMARK_QUIT", "0") == "1"):
+	quit()
@@ -10,6 +10,7 @@ execfile("test_current_axisymmetric.py")
 execfile("test_magnetic_steady_planar.py")
 execfile("test_magnetic_steady_axisymmetric.py")
 execfile("test_magnetic_transient_planar.py")
+execfile("test_magnetic_virtual_work.py")
 
 # harmonic magnetic
 execfile("test_magnetic_harmonic_planar.py")
@@ -20,5 +21,14 @@ execfile("test_heat_transfer_steady_planar.py")
 execfile("test_heat_transfer_steady_axisymmetric.py")
 execfile("test_heat_transfer_transient_axisymmetric.py")
 
+# incompressible flow
+execfile("test_flow_planar.py")
+
+# time stepping
+execfile("test_time_stepping.py")
+
+# matrix solvers
+execfile("test_matrix_solver.py")
+
 # scripting
 execfile("test_scripting.py")
\ No newline at end of file
@@ -0,0 +1,36 @@
+# model
+newdocument("Channel", "planar", "flow", 1, 2)
+
+# boundaries
+addboundary("Inlet", "flow_velocity", 0.01, 0, 0)
+addboundary("Outlet", "flow_outlet", 0, 0, 0)
+addboundary("Wall", "flow_wall", 0, 0, 0)
+
+# materials
+addmaterial("Water", 1e-3, 1000)
+
+# edges
+addedge(0, 0, 0.1, 0, 0, "Wall")
+addedge(0.1, 0, 0.1, 0.01, 0, "Outlet")
+addedge(0.1, 0.01, 0, 0.01, 0, "Wall")
+addedge(0, 0.01, 0, 0, 0, "Inlet")
+
+# labels
+addlabel(0.05, 0.005, 1e-6, 0, "Water")
+
+# solve
+zoombestfit()
+solve()
+
+# point value (Poiseuille flow: v = 1.5 * v_inlet on the axis, dp/dx = - 12 * mu * v_inlet / h^2, p = 0 on the outlet)
+point = pointresult(0.075, 0.005)
+testv = test("Velocity", point["v"], 0.015, 0.05)
+testvx = test("Velocity - x", point["vx"], 0.015, 0.05)
+
+point = pointresult(0.075, 0.0025)
+testvxq = test("Velocity - x (quarter)", point["vx"], 0.01125, 0.05)
+
+point = pointresult(0.05, 0.005)
+testp = test("Pressure", point["p"], 0.06, 0.1)
+
+print("Test: Flow - planar: " + str(testv and testvx and testvxq and testp))
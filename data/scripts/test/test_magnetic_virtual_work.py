@@ -0,0 +1,48 @@
+# torque of the motor example by the virtual work (air gap volume) and by the Maxwell stress in the points of the air gap
+import os
+import math
+
+# the tests are next to this script (benchmark) or in the working directory (test.py)
+testDir = os.path.dirname(__file__) if ("__file__" in globals()) else ""
+
+def torqueMotor(numberofrefinements, polynomialorder):
+	opendocument(os.path.abspath(os.path.join(testDir, "..", "..", "magnetic_steadystate_planar_motor.a2d")))
+
+	# magnetization turned against the stator teeth (nonzero torque)
+	modifymaterial("Magnet N", 0, 0, 1.045, 0, 1.15995, 90 + 15, 0, 0, 0)
+	modifymaterial("Magnet E", 0, 0, 1.045, 0, 1.15995, 0 + 15, 0, 0, 0)
+	modifymaterial("Magnet W", 0, 0, 1.045, 0, 1.15995, 180 + 15, 0, 0, 0)
+	modifymaterial("Magnet S", 0, 0, 1.045, 0, 1.15995, -90 + 15, 0, 0, 0)
+
+	discretization(numberofrefinements, polynomialorder)
+	solve()
+
+	# virtual work - air gap between the magnets (r = 0.0585 m) and the stator (r = 0.0606 m)
+	volume = volumeintegral(3)
+
+	# Maxwell stress on the circle in the middle of the air gap
+	mu0 = 4 * math.pi * 1e-7
+	r = 0.05955
+	n = 360
+	torque = 0.0
+	for k in range(n):
+		phi = 2 * math.pi * k / n
+		point = pointresult(r * math.cos(phi), r * math.sin(phi))
+		Br = point["Bx_real"] * math.cos(phi) + point["By_real"] * math.sin(phi)
+		Bt = - point["Bx_real"] * math.sin(phi) + point["By_real"] * math.cos(phi)
+		torque += r**2 / mu0 * Br * Bt * 2 * math.pi / n
+
+	return volume["T_w"], torque
+
+torqueWeightedCoarse, torqueStressCoarse = torqueMotor(0, 2)
+torqueWeightedFine, torqueStressFine = torqueMotor(2, 2)
+
+changeWeighted = abs(torqueWeightedCoarse - torqueWeightedFine) / abs(torqueWeightedFine)
+changeStress = abs(torqueStressCoarse - torqueStressFine) / abs(torqueStressFine)
+print("Torque - virtual work: " + str(torqueWeightedCoarse) + " (coarse), " + str(torqueWeightedFine) + " (fine), change " + str(changeWeighted))
+print("Torque - Maxwell stress: " + str(torqueStressCoarse) + " (coarse), " + str(torqueStressFine) + " (fine), change " + str(changeStress))
+
+testTw = test("Torque - virtual work (coarse mesh)", torqueWeightedCoarse, torqueWeightedFine, 0.02)
+testChange = (changeWeighted < changeStress)
+
+print("Test: Magnetic virtual work - mesh insensitivity: " + str(testTw and testChange))
@@ -0,0 +1,46 @@
+# matrix solvers of the same discrete problem agree with the LU factorization of the real system (UMFPACK)
+import os
+
+# the tests are next to this script (benchmark) or in the working directory (test.py)
+testDir = os.path.dirname(__file__) if ("__file__" in globals()) else ""
+
+def matrixSolverResults(fileName, solver):
+	results = []
+	def solveSolver():
+		if (solver != ""):
+			matrixsolver(solver)
+		solve()
+
+	# the expected values are tested as well
+	def testResult(text, value, normal, error = 0.03):
+		results.append(value)
+		return test(text, value, normal, error)
+
+	namespace = dict(globals())
+	namespace["solve"] = solveSolver
+	namespace["test"] = testResult
+	execfile(os.path.join(testDir, fileName), namespace)
+	return results
+
+def testMatrixSolver(name, fileName, solver, error = 1e-6):
+	results = matrixSolverResults(fileName, solver)
+	resultsReference = matrixSolverResults(fileName, "umfpack")
+
+	ok = (len(results) > 0) and (len(results) == len(resultsReference))
+	for i in range(min(len(results), len(resultsReference))):
+		ok = test(name + " - value " + str(i), results[i], resultsReference[i], error) and ok
+
+	print("Test: Matrix solver - " + name + ": " + str(ok))
+
+# complex system of the harmonic analysis (default solver) and the real block system
+testMatrixSolver("complex block", "test_magnetic_harmonic_planar.py", "")
+testMatrixSolver("complex block (axisymmetric)", "test_magnetic_harmonic_axisymmetric.py", "")
+
+# symmetric linear problems (default solver is the sparse Cholesky factorization)
+testMatrixSolver("Cholesky - electrostatic", "test_electrostatic_planar.py", "")
+testMatrixSolver("Cholesky - electrostatic (axisymmetric)", "test_electrostatic_axisymmetric.py", "")
+testMatrixSolver("Cholesky - heat transfer", "test_heat_transfer_steady_planar.py", "")
+testMatrixSolver("Cholesky - heat transfer (axisymmetric)", "test_heat_transfer_steady_axisymmetric.py", "")
+
+# saddle point problem of the incompressible flow (block preconditioned GMRES)
+testMatrixSolver("saddle point", "test_flow_planar.py", "saddlepoint", 1e-4)
@@ -0,0 +1,19 @@
+# transient tests with the BDF2 time stepping (the expected values of the implicit Euler are kept)
+import os
+
+# the tests are next to this script (benchmark) or in the working directory (test.py)
+testDir = os.path.dirname(__file__) if ("__file__" in globals()) else ""
+
+def testTimeStepping(fileName, method, tolerance = 1.0):
+	def solveMethod():
+		timestepmethod(method, tolerance)
+		solve()
+
+	namespace = dict(globals())
+	namespace["solve"] = solveMethod
+	print("Time step method: " + method)
+	execfile(os.path.join(testDir, fileName), namespace)
+
+for method in ["bdf2", "bdf2adaptive"]:
+	testTimeStepping("test_magnetic_transient_planar.py", method, 0.1)
+	testTimeStepping("test_heat_transfer_transient_axisymmetric.py", method, 0.1)
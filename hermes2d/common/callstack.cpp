@@ -21,8 +21,22 @@
 #include "callstack.h"
 #include <signal.h>
 #include <stdlib.h>
-
-// global instance of the call stack object
+#include <map>
+#include <vector>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#define CALLSTACK_MAX_SIZE			32
+
+// call stack of the thread
+static H2D_THREAD CallStackObj *stack[CALLSTACK_MAX_SIZE];
+static H2D_THREAD int stack_size = 0;
+
+// global instance of the call stack object (installs the signal handlers)
 static CallStack callstack;
 
 // Call Stack Object ////
@@ -33,20 +47,90 @@ CallStackObj::CallStackObj(int ln, const char *func, const char *file) {
 	this->file = file;
 
 	// add this object to the call stack
-	if (callstack.size < callstack.max_size) {
-		callstack.stack[callstack.size] = this;
-		callstack.size++;
+	if (stack_size < CALLSTACK_MAX_SIZE) {
+		stack[stack_size] = this;
+		stack_size++;
 	}
 }
 
 CallStackObj::~CallStackObj() {
 	// remove the object only if it is on the top of the call stack
-	if (callstack.size > 0 && callstack.stack[callstack.size - 1] == this) {
-		callstack.size--;
-		callstack.stack[callstack.size] = NULL;
+	if (stack_size > 0 && stack[stack_size - 1] == this) {
+		stack_size--;
+		stack[stack_size] = NULL;
+	}
+}
+
+// Profile ////
+
+struct ProfileEntry {
+	const char *func;
+	int calls;
+	int depth;					// recursion depth, time is accumulated in the outermost call only
+	double time;				// inclusive time (s)
+};
+
+typedef std::map<const char *, ProfileEntry> ProfileMap;
+
+// profile of the thread (functions are identified by the address of the name)
+static H2D_THREAD ProfileMap *profile = NULL;
+
+static double profile_time() {
+#ifdef _MSC_VER
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+#endif
+}
+
+ProfileObj::ProfileObj(int ln, const char *func, const char *file) : CallStackObj(ln, func, file) {
+	if (profile == NULL) profile = new ProfileMap();
+
+	ProfileEntry &entry = (*profile)[func];
+	entry.func = func;
+	entry.calls++;
+	entry.depth++;
+
+	this->start = profile_time();
+}
+
+ProfileObj::~ProfileObj() {
+	double time = profile_time() - this->start;
+
+	ProfileEntry &entry = (*profile)[func];
+	if (entry.depth > 0) {
+		entry.depth--;
+		if (entry.depth == 0) entry.time += time;
 	}
 }
 
+static bool profile_compare(const ProfileEntry &a, const ProfileEntry &b) {
+	return a.time > b.time;
+}
+
+void profile_dump(FILE *file) {
+	if (profile == NULL || profile->empty()) return;
+
+	std::vector<ProfileEntry> entries;
+	for (ProfileMap::const_iterator it = profile->begin(); it != profile->end(); it++)
+		entries.push_back(it->second);
+	std::sort(entries.begin(), entries.end(), profile_compare);
+
+	fprintf(file, "Profile (inclusive time):\n");
+	fprintf(file, "  %12s %10s  %s\n", "time [s]", "calls", "function");
+	for (unsigned int i = 0; i < entries.size(); i++)
+		fprintf(file, "  %12.6lf %10d  %s\n", entries[i].time, entries[i].calls, entries[i].func);
+}
+
+void profile_reset() {
+	if (profile != NULL) profile->clear();
+}
+
 // Signals ////
 
 static
@@ -74,23 +158,15 @@ void callstack_finalize() {
 
 CallStack &get_callstack() { return callstack; }
 
-CallStack::CallStack(int max_size) {
-	this->max_size = max_size;
-	this->size = 0;
-	this->stack = new CallStackObj *[max_size];
-
+CallStack::CallStack() {
 	// initialize signals
 	callstack_initialize();
 }
 
-CallStack::~CallStack() {
-	delete [] stack;
-}
-
 void CallStack::dump() {
-	if (size > 0) {
+	if (stack_size > 0) {
 		fprintf(stderr, "Call stack:\n");
-		for (int i = size - 1; i >= 0; i--)
+		for (int i = stack_size - 1; i >= 0; i--)
 			fprintf(stderr, "  %s:%d: %s\n", stack[i]->file, stack[i]->line, stack[i]->func);
 	}
 	else {
@@ -22,11 +22,26 @@
 
 #include <stdio.h>
 
+// Function tracing (_F_) is compiled in only with
+//   H2D_CALLSTACK - call stack of the thread is dumped on errors and signals,
+//   H2D_PROFILE - call stack and inclusive times of the functions (flat profile).
+// Without them _F_ is empty. The data are kept per thread.
+
 // __PRETTY_FUNCTION__ missing on MSVC
 #ifdef _MSC_VER
-#define _F_ CallStackObj __call_stack_obj(__LINE__, __FUNCTION__, __FILE__);
+#define H2D_FUNCTION __FUNCTION__
+#define H2D_THREAD __declspec(thread)
 #else
-#define _F_ CallStackObj __call_stack_obj(__LINE__, __PRETTY_FUNCTION__, __FILE__);
+#define H2D_FUNCTION __PRETTY_FUNCTION__
+#define H2D_THREAD __thread
+#endif
+
+#if defined(H2D_PROFILE)
+#define _F_ ProfileObj __call_stack_obj(__LINE__, H2D_FUNCTION, __FILE__);
+#elif defined(H2D_CALLSTACK)
+#define _F_ CallStackObj __call_stack_obj(__LINE__, H2D_FUNCTION, __FILE__);
+#else
+#define _F_
 #endif
 
 /// Holds data for one call stack object
@@ -40,25 +55,30 @@ struct CallStackObj {
 	const char *func;			// function name
 };
 
-/// Call stack object
+/// Call stack object with the timer (inclusive time of the function)
+///
+struct ProfileObj : public CallStackObj {
+	ProfileObj(int ln, const char *func, const char *file);
+	~ProfileObj();
+
+	double start;				// time of the call (s)
+};
+
+/// Call stack of the calling thread
 ///
 class CallStack {
 public:
-	CallStack(int max_size = 32);
-	~CallStack();
+	CallStack();
 
-	// dump the call stack objects to standard error
+	// dump the call stack objects of the calling thread to standard error
 	void dump();
-
-protected:
-	CallStackObj **stack;
-	int size;
-	int max_size;
-
-	friend class CallStackObj;
 };
 
 CallStack &get_callstack();
 
+/// Flat profile of the calling thread sorted by the inclusive time (H2D_PROFILE only)
+void profile_dump(FILE *file = stderr);
+/// Clear the profile of the calling thread
+void profile_reset();
 
 #endif
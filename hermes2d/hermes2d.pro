@@ -5,6 +5,9 @@ OBJECTS_DIR = build
 CONFIG = += staticlib
 DEFINES += NOGLUT
 DEFINES += WITH_UMFPACK
+# call stack tracing (_F_), H2D_PROFILE adds the flat profile of the solver
+DEFINES += H2D_CALLSTACK
+# DEFINES += H2D_PROFILE
 
 linux-g++ {
     INCLUDEPATH += /usr/include/suitesparse
@@ -44,6 +47,8 @@ SOURCES += src/compat/fmemopen.cpp \
         src/solver/precond_ifpack.cpp \
         src/solver/precond_ml.cpp \
         src/solver/umfpack_solver.cpp \
+        src/solver/cholesky.cpp \
+        src/solver/saddle_point.cpp \
         src/common.cpp \
         src/data_table.cpp \
         src/hash.cpp \
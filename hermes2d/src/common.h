@@ -93,11 +93,14 @@ inline void blas_copy(int n, complex *x, int incx, complex *y, int incy) { zcopy
 enum MatrixSolverType 
 {
    SOLVER_UMFPACK, 
+   SOLVER_UMFPACK_COMPLEX_BLOCK,
    SOLVER_PETSC, 
    SOLVER_MUMPS,
    SOLVER_PARDISO,
    SOLVER_NOX,
-   SOLVER_AMESOS
+   SOLVER_AMESOS,
+   SOLVER_CHOLESKY,
+   SOLVER_SADDLE_POINT
 };
 
 // STL stuff
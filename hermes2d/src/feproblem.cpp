@@ -22,6 +22,8 @@
 #include "matrix.h"
 #include "solver/solver.h"
 #include "solver/umfpack_solver.h"
+#include "solver/cholesky.h"
+#include "solver/saddle_point.h"
 #include "refmap.h"
 #include "solution.h"
 #include "config.h"
@@ -56,11 +58,23 @@ FeProblem::FeProblem(WeakForm* wf, Tuple<Space *> spaces, bool is_linear)
   matrix_buffer = NULL;
   matrix_buffer_dim = 0;
 
+  coef_buffer = NULL;
+  coef_buffer_size = 0;
+
   values_changed = true;
   struct_changed = true;
 
   have_matrix = false;
 
+  fn_cache = NULL;
+  fn_cache_stamp = 0;
+  for (int i = 0; i < FN_CACHE_ORDERS; i++)
+  {
+    cache_e[i] = NULL;
+    cache_jwt[i] = NULL;
+    cache_jwt_np[i] = 0;
+  }
+
   this->spaces = Tuple<Space *>();
   for (int i = 0; i < wf->neq; i++) this->spaces.push_back(spaces[i]);
   have_spaces = true;
@@ -86,6 +100,7 @@ FeProblem::~FeProblem()
 {
   _F_
   free();
+  free_cache();
   if (sp_seq != NULL) delete [] sp_seq;
   if (pss != NULL) delete [] pss;
 }
@@ -115,6 +130,14 @@ scalar** FeProblem::get_matrix_buffer(int n)
   return (matrix_buffer = new_matrix<scalar>(matrix_buffer_dim = n));
 }
 
+double* FeProblem::get_coef_buffer(int n)
+{
+  _F_
+  if (n <= coef_buffer_size) return coef_buffer;
+  if (coef_buffer != NULL) delete [] coef_buffer;
+  return (coef_buffer = new double[coef_buffer_size = n]);
+}
+
 //// matrix structure precalculation ///////////////////////////////////////////////////////////////
 
 // This functions is identical in H2D and H3D.
@@ -352,6 +375,12 @@ void FeProblem::assemble(scalar* coeff_vec, SparseMatrix* mat, Vector* rhs, bool
 
           // assemble the local stiffness matrix for the form mfv
           scalar **local_stiffness_matrix = get_matrix_buffer(std::max(am->cnt, an->cnt));
+
+          // batched form - all entries (including the coefficients) are evaluated at once
+          bool batch = (mfv->coef != NULL);
+          if (batch)
+            eval_form_coef(mfv, u_ext, fu, fv, refmap + n, refmap + m, an, am, local_stiffness_matrix, sym);
+
           for (int i = 0; i < am->cnt; i++)
           {
             if (!tra && am->dof[i] < 0) continue;
@@ -367,13 +396,13 @@ void FeProblem::assemble(scalar* coeff_vec, SparseMatrix* mat, Vector* rhs, bool
                   // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
                   if (rhs != NULL && this->is_linear) 
                   {
-                    scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
+                    scalar val = batch ? local_stiffness_matrix[i][j] : eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
                     rhs->add(am->dof[i], -val);
                   } 
                 }
                 else if (rhsonly == false) 
                 {
-                  scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
+                  scalar val = batch ? local_stiffness_matrix[i][j] : eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
                   local_stiffness_matrix[i][j] = val;
                 }
               }
@@ -389,13 +418,13 @@ void FeProblem::assemble(scalar* coeff_vec, SparseMatrix* mat, Vector* rhs, bool
                   // Linear problems only: Subtracting Dirichlet lift contribution from the RHS:
                   if (rhs != NULL && this->is_linear) 
                   {
-                    scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
+                    scalar val = batch ? local_stiffness_matrix[i][j] : eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
                     rhs->add(am->dof[i], -val);
                   }
                 } 
                 else if (rhsonly == false) 
                 {
-                  scalar val = eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
+                  scalar val = batch ? local_stiffness_matrix[i][j] : eval_form(mfv, u_ext, fu, fv, refmap + n, refmap + m) * an->coef[j] * am->coef[i];
                   local_stiffness_matrix[i][j] = local_stiffness_matrix[j][i] = val;
                 }
               }
@@ -563,6 +592,7 @@ void FeProblem::assemble(scalar* coeff_vec, SparseMatrix* mat, Vector* rhs, bool
   }
 
   for (int i = 0; i < wf->neq; i++) delete spss[i];  // This is different from H3D.
+  free_cache();
 
   // Cleaning up.
   delete [] matrix_buffer;
@@ -627,10 +657,74 @@ ExtData<Ord>* FeProblem::init_ext_fns_ord(std::vector<MeshFunction *> &ext, int
   return fake_ext;
 }
 
+// Recalculate shape function values and derivatives into the buffers of a cached Func,
+// affine elements scale the reference derivatives by the constant inverse reference map
+static Func<double>* update_fn(Func<double>* u, PrecalcShapeset *fu, RefMap *rm, const int order)
+{
+#ifndef H2D_SECOND_DERIVATIVES_ENABLED
+  int space_type = fu->get_type();
+  int np = fu->get_quad_2d()->get_num_points(order);
+  // the number of points of the same order differs for triangles and quads
+  if (u != NULL && u->nc == 1 && u->num_gip == np && (space_type == 0 || space_type == 3))
+  {
+    fu->set_quad_order(order, H2D_FN_ALL);
+
+    double *fn = fu->get_fn_values();
+    double *dx = fu->get_dx_values();
+    double *dy = fu->get_dy_values();
+    memcpy(u->val, fn, np * sizeof(double));
+
+    // the constant map is not updated by push_transform(), use it for whole elements only
+    if (rm->is_jacobian_const() && rm->get_transform() == 0)
+    {
+      double2x2 *m = rm->get_const_inv_ref_map();
+      double m00 = (*m)[0][0], m01 = (*m)[0][1], m10 = (*m)[1][0], m11 = (*m)[1][1];
+      for (int i = 0; i < np; i++)
+      {
+        u->dx[i] = (dx[i] * m00 + dy[i] * m01);
+        u->dy[i] = (dx[i] * m10 + dy[i] * m11);
+      }
+    }
+    else
+    {
+      double2x2 *m = rm->get_inv_ref_map(order);
+      for (int i = 0; i < np; i++, m++)
+      {
+        u->dx[i] = (dx[i] * (*m)[0][0] + dy[i] * (*m)[0][1]);
+        u->dy[i] = (dx[i] * (*m)[1][0] + dy[i] * (*m)[1][1]);
+      }
+    }
+    return u;
+  }
+#endif
+
+  if (u != NULL) { u->free_fn(); delete u; }
+  return init_fn(fu, rm, order);
+}
+
 // Initialize shape function values and derivatives (fill in the cache)
 Func<double>* FeProblem::get_fn(PrecalcShapeset *fu, RefMap *rm, const int order)
 {
   _F_
+  int index = fu->get_active_shape();
+  if (index >= 0 && index < FN_CACHE_INDICES && order < FN_CACHE_ORDERS)
+  {
+    FnCacheSlot* slot = fn_cache + index * FN_CACHE_ORDERS + order;
+    int sub_idx = fu->get_transform();
+    int shapeset_id = fu->get_shapeset()->get_id();
+
+    if (slot->stamp != fn_cache_stamp)
+    {
+      slot->fn = update_fn(slot->fn, fu, rm, order);
+      slot->stamp = fn_cache_stamp;
+      slot->sub_idx = sub_idx;
+      slot->shapeset_id = shapeset_id;
+      return slot->fn;
+    }
+    if (slot->sub_idx == sub_idx && slot->shapeset_id == shapeset_id)
+      return slot->fn;
+  }
+
   PrecalcShapeset::Key key(256 - fu->get_active_shape(), order, fu->get_transform(), fu->get_shapeset()->get_id());
   if (cache_fn[key] == NULL)
     cache_fn[key] = init_fn(fu, rm, order);
@@ -642,22 +736,29 @@ Func<double>* FeProblem::get_fn(PrecalcShapeset *fu, RefMap *rm, const int order
 void FeProblem::init_cache()
 {
   _F_
-  for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
+  if (fn_cache == NULL)
   {
-    cache_e[i] = NULL;
-    cache_jwt[i] = NULL;
+    fn_cache = new FnCacheSlot[FN_CACHE_INDICES * FN_CACHE_ORDERS];
+    MEM_CHECK(fn_cache);
+    memset(fn_cache, 0, sizeof(FnCacheSlot) * FN_CACHE_INDICES * FN_CACHE_ORDERS);
+    fn_cache_stamp = 0;
   }
+  // invalidates all slots of the previous element
+  fn_cache_stamp++;
+
+  for (int i = 0; i < FN_CACHE_ORDERS; i++)
+    cache_e[i] = NULL;
 }
 
 void FeProblem::delete_cache()
 {
   _F_
-  for (int i = 0; i < g_max_quad + 1 + 4 * g_max_quad + 4; i++)
+  for (int i = 0; i < FN_CACHE_ORDERS; i++)
   {
     if (cache_e[i] != NULL)
     {
       cache_e[i]->free(); delete cache_e[i];
-      delete [] cache_jwt[i];
+      cache_e[i] = NULL;
     }
   }
   for (std::map<PrecalcShapeset::Key, Func<double>*, PrecalcShapeset::Compare>::const_iterator it = cache_fn.begin(); it != cache_fn.end(); it++)
@@ -667,6 +768,45 @@ void FeProblem::delete_cache()
   cache_fn.clear();
 }
 
+// Free the buffers kept across elements
+void FeProblem::free_cache()
+{
+  _F_
+  delete_cache();
+  for (int i = 0; i < FN_CACHE_ORDERS; i++)
+  {
+    if (cache_jwt[i] != NULL)
+    {
+      delete [] cache_jwt[i];
+      cache_jwt[i] = NULL;
+      cache_jwt_np[i] = 0;
+    }
+  }
+  if (fn_cache != NULL)
+  {
+    for (int i = 0; i < FN_CACHE_INDICES * FN_CACHE_ORDERS; i++)
+      if (fn_cache[i].fn != NULL) { fn_cache[i].fn->free_fn(); delete fn_cache[i].fn; }
+    delete [] fn_cache;
+    fn_cache = NULL;
+  }
+  if (coef_buffer != NULL)
+  {
+    delete [] coef_buffer;
+    coef_buffer = NULL;
+    coef_buffer_size = 0;
+  }
+}
+
+// Jacobian*weights buffer for at least np points (triangles and quads
+// of the same order have a different number of points)
+double* FeProblem::get_cache_jwt(int order, int np)
+{
+  _F_
+  if (np <= cache_jwt_np[order]) return cache_jwt[order];
+  if (cache_jwt[order] != NULL) delete [] cache_jwt[order];
+  return (cache_jwt[order] = new double[cache_jwt_np[order] = np]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Actual evaluation of volume matrix form (calculates integral)
@@ -731,10 +871,19 @@ scalar FeProblem::eval_form(WeakForm::MatrixFormVol *mfv, Tuple<Solution *> u_ex
   if (cache_e[order] == NULL)
   {
     cache_e[order] = init_geom_vol(ru, order);
-    double* jac = ru->get_jacobian(order);
-    cache_jwt[order] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[order][i] = pt[i][2] * jac[i];
+    get_cache_jwt(order, np);
+    if (ru->is_jacobian_const() && ru->get_transform() == 0)
+    {
+      double jac = ru->get_const_jacobian();
+      for(int i = 0; i < np; i++)
+        cache_jwt[order][i] = pt[i][2] * jac;
+    }
+    else
+    {
+      double* jac = ru->get_jacobian(order);
+      for(int i = 0; i < np; i++)
+        cache_jwt[order][i] = pt[i][2] * jac[i];
+    }
   }
   Geom<double>* e = cache_e[order];
   double* jwt = cache_jwt[order];
@@ -766,6 +915,207 @@ scalar FeProblem::eval_form(WeakForm::MatrixFormVol *mfv, Tuple<Solution *> u_ex
   return res;
 }
 
+// Batched evaluation of volume matrix form (the whole local matrix of the element).
+// The form supplies coefficients in the integration points, the local matrix is
+// K = W * G^T, where the rows of G hold derivatives and values of the basis functions
+// (dx | dy | val) and the rows of W are the test functions weighted by the coefficients.
+// For the symmetric block only the upper triangle and the Dirichlet columns are evaluated.
+void FeProblem::eval_form_coef(WeakForm::MatrixFormVol *mfv, Tuple<Solution *> u_ext,
+                               PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+                               AsmList *an, AsmList *am, scalar **local, bool sym)
+{
+  _F_
+  if (fu->get_num_components() != 1 || fv->get_num_components() != 1)
+    error("Batched matrix forms are available for scalar spaces only.");
+
+  // Determine the integration order (the highest shape functions of the element).
+  int fu_order = 0, fv_order = 0;
+  for (int j = 0; j < an->cnt; j++)
+  {
+    fu->set_active_shape(an->idx[j]);
+    fu_order = std::max(fu_order, fu->get_fn_order());
+  }
+  for (int i = 0; i < am->cnt; i++)
+  {
+    fv->set_active_shape(am->idx[i]);
+    fv_order = std::max(fv_order, fv->get_fn_order());
+  }
+
+  // Order of solutions from the previous Newton iteration.
+  AUTOLA_OR(Func<Ord>*, oi, wf->neq);
+  if (u_ext != Tuple<Solution *>()) {
+    for (int i = 0; i < wf->neq; i++) {
+      if (u_ext[i] != NULL) oi[i] = init_fn_ord(u_ext[i]->get_fn_order());
+      else oi[i] = init_fn_ord(0);
+    }
+  }
+  else {
+    for (int i = 0; i < wf->neq; i++) oi[i] = init_fn_ord(0);
+  }
+
+  // Order of shape functions.
+  Func<Ord>* ou = init_fn_ord(fu_order);
+  Func<Ord>* ov = init_fn_ord(fv_order);
+
+  // Order of additional external functions.
+  ExtData<Ord>* fake_ext = init_ext_fns_ord(mfv->ext);
+
+  // Order of geometric attributes (eg. for multiplication of a solution with coordinates, normals, etc.).
+  double fake_wt = 1.0;
+  Geom<Ord>* fake_e = init_geom_ord();
+
+  // Total order of the matrix form.
+  Ord o = mfv->ord(1, &fake_wt, oi, ou, ov, fake_e, fake_ext);
+
+  // Increase due to reference map.
+  int order = ru->get_inv_ref_order();
+  order += o.get_order();
+  limit_order_nowarn(order);
+
+  // Clean up.
+  for (int i = 0; i < wf->neq; i++) {
+    if (oi[i] != NULL) { oi[i]->free_ord(); delete oi[i]; }
+  }
+  if (ou != NULL) {
+    ou->free_ord(); delete ou;
+  }
+  if (ov != NULL) {
+    ov->free_ord(); delete ov;
+  }
+  if (fake_e != NULL) delete fake_e;
+  if (fake_ext != NULL) {fake_ext->free_ord(); delete fake_ext;}
+
+  // Evaluate the form using the quadrature of the just calculated order.
+  Quad2D* quad = fu->get_quad_2d();
+  double3* pt = quad->get_points(order);
+  int np = quad->get_num_points(order);
+
+  // Init geometry and jacobian*weights.
+  if (cache_e[order] == NULL)
+  {
+    cache_e[order] = init_geom_vol(ru, order);
+    get_cache_jwt(order, np);
+    if (ru->is_jacobian_const() && ru->get_transform() == 0)
+    {
+      double jac = ru->get_const_jacobian();
+      for(int i = 0; i < np; i++)
+        cache_jwt[order][i] = pt[i][2] * jac;
+    }
+    else
+    {
+      double* jac = ru->get_jacobian(order);
+      for(int i = 0; i < np; i++)
+        cache_jwt[order][i] = pt[i][2] * jac[i];
+    }
+  }
+  Geom<double>* e = cache_e[order];
+  double* jwt = cache_jwt[order];
+
+  // Values of the previous Newton iteration and external functions in quadrature points.
+  AUTOLA_OR(Func<scalar>*, prev, wf->neq);
+  if (u_ext != Tuple<Solution *>()) {
+    for (int i = 0; i < wf->neq; i++) {
+      if (u_ext[i] != NULL) prev[i] = init_fn(u_ext[i], rv, order);
+      else prev[i] = NULL;
+    }
+  }
+  else {
+    for (int i = 0; i < wf->neq; i++) prev[i] = NULL;
+  }
+  ExtData<scalar>* ext = init_ext_fns(mfv->ext, rv, order);
+
+  // Buffers: coefficients (4 np), basis functions G (3 np per function), weighted test functions W (3 np per function).
+  int ng = 3 * np;
+  double* buffer = get_coef_buffer(4 * np + (an->cnt + am->cnt) * ng);
+  memset(buffer, 0, sizeof(double) * 4 * np);
+  MatrixFormCoef coef = { buffer, buffer + np, buffer + 2*np, buffer + 3*np };
+  double* g = buffer + 4 * np;
+  double* w = g + an->cnt * ng;
+
+  mfv->coef(np, prev, e, ext, &coef);
+
+  // Clean up.
+  for (int i = 0; i < wf->neq; i++) {
+    if (prev[i] != NULL) prev[i]->free_fn(); delete prev[i];
+  }
+  if (ext != NULL) {ext->free(); delete ext;}
+
+  // Terms present in the form (the other part of the rows is skipped).
+  bool has_grad = false, has_val = false;
+  for (int k = 0; k < np; k++)
+  {
+    if (coef.gg[k] != 0.0) has_grad = true;
+    if (coef.uv[k] != 0.0 || coef.udvdx[k] != 0.0 || coef.udvdy[k] != 0.0) has_val = true;
+  }
+  int k0 = has_grad ? 0 : 2*np;
+  int k1 = has_val ? ng : 2*np;
+
+  // Basis functions.
+  for (int j = 0; j < an->cnt; j++)
+  {
+    fu->set_active_shape(an->idx[j]);
+    Func<double>* u = get_fn(fu, ru, order);
+    double* gj = g + j * ng;
+    memcpy(gj, u->dx, sizeof(double) * np);
+    memcpy(gj + np, u->dy, sizeof(double) * np);
+    memcpy(gj + 2*np, u->val, sizeof(double) * np);
+  }
+
+  // Weighted test functions.
+  for (int i = 0; i < am->cnt; i++)
+  {
+    fv->set_active_shape(am->idx[i]);
+    Func<double>* v = get_fn(fv, rv, order);
+    double* wi = w + i * ng;
+    for (int k = 0; k < np; k++)
+    {
+      wi[k]        = jwt[k] * coef.gg[k] * v->dx[k];
+      wi[np + k]   = jwt[k] * coef.gg[k] * v->dy[k];
+      wi[2*np + k] = jwt[k] * (coef.uv[k] * v->val[k] + coef.udvdx[k] * v->dx[k] + coef.udvdy[k] * v->dy[k]);
+    }
+  }
+
+  // Local matrix, blocks of four test functions share the loads of the basis function.
+  int i = 0;
+  for (; i + 3 < am->cnt; i += 4)
+  {
+    double* w0 = w + i * ng;
+    double* w1 = w0 + ng;
+    double* w2 = w1 + ng;
+    double* w3 = w2 + ng;
+    for (int j = 0; j < an->cnt; j++)
+    {
+      if (sym && j < i && an->dof[j] >= 0) continue;
+      double* gj = g + j * ng;
+      double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+      for (int k = k0; k < k1; k++)
+      {
+        s0 += w0[k] * gj[k];
+        s1 += w1[k] * gj[k];
+        s2 += w2[k] * gj[k];
+        s3 += w3[k] * gj[k];
+      }
+      local[i    ][j] = s0 * an->coef[j] * am->coef[i];
+      local[i + 1][j] = s1 * an->coef[j] * am->coef[i + 1];
+      local[i + 2][j] = s2 * an->coef[j] * am->coef[i + 2];
+      local[i + 3][j] = s3 * an->coef[j] * am->coef[i + 3];
+    }
+  }
+  for (; i < am->cnt; i++)
+  {
+    double* wi = w + i * ng;
+    for (int j = 0; j < an->cnt; j++)
+    {
+      if (sym && j < i && an->dof[j] >= 0) continue;
+      double* gj = g + j * ng;
+      double s = 0.0;
+      for (int k = k0; k < k1; k++)
+        s += wi[k] * gj[k];
+      local[i][j] = s * an->coef[j] * am->coef[i];
+    }
+  }
+}
+
 // Actual evaluation of volume vector form (calculates integral)
 scalar FeProblem::eval_form(WeakForm::VectorFormVol *vfv, Tuple<Solution *> u_ext, PrecalcShapeset *fv, RefMap *rv)
 {
@@ -823,10 +1173,19 @@ scalar FeProblem::eval_form(WeakForm::VectorFormVol *vfv, Tuple<Solution *> u_ex
   if (cache_e[order] == NULL)
   {
     cache_e[order] = init_geom_vol(rv, order);
-    double* jac = rv->get_jacobian(order);
-    cache_jwt[order] = new double[np];
-    for(int i = 0; i < np; i++)
-      cache_jwt[order][i] = pt[i][2] * jac[i];
+    get_cache_jwt(order, np);
+    if (rv->is_jacobian_const() && rv->get_transform() == 0)
+    {
+      double jac = rv->get_const_jacobian();
+      for(int i = 0; i < np; i++)
+        cache_jwt[order][i] = pt[i][2] * jac;
+    }
+    else
+    {
+      double* jac = rv->get_jacobian(order);
+      for(int i = 0; i < np; i++)
+        cache_jwt[order][i] = pt[i][2] * jac[i];
+    }
   }
   Geom<double>* e = cache_e[order];
   double* jwt = cache_jwt[order];
@@ -926,7 +1285,7 @@ scalar FeProblem::eval_form(WeakForm::MatrixFormSurf *mfs, Tuple<Solution *> u_e
   {
     cache_e[eo] = init_geom_surf(ru, surf_pos, eo);
     double3* tan = ru->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
+    get_cache_jwt(eo, np);
     for(int i = 0; i < np; i++)
       cache_jwt[eo][i] = pt[i][2] * tan[i][2];
   }
@@ -1027,7 +1386,7 @@ scalar FeProblem::eval_form(WeakForm::VectorFormSurf *vfs, Tuple<Solution *> u_e
   {
     cache_e[eo] = init_geom_surf(rv, surf_pos, eo);
     double3* tan = rv->get_tangent(surf_pos->surf_num, eo);
-    cache_jwt[eo] = new double[np];
+    get_cache_jwt(eo, np);
     for(int i = 0; i < np; i++)
       cache_jwt[eo][i] = pt[i][2] * tan[i][2];
   }
@@ -1092,6 +1451,9 @@ Vector* create_vector(MatrixSolverType matrix_solver)
         break;
       }
     case SOLVER_UMFPACK: 
+    case SOLVER_UMFPACK_COMPLEX_BLOCK: 
+    case SOLVER_SADDLE_POINT: 
+    case SOLVER_CHOLESKY: 
       {
         return new UMFPackVector;
         break;
@@ -1128,10 +1490,17 @@ SparseMatrix* create_matrix(MatrixSolverType matrix_solver)
         break;
       }
     case SOLVER_UMFPACK: 
+    case SOLVER_UMFPACK_COMPLEX_BLOCK: 
+    case SOLVER_SADDLE_POINT: 
       {
         return new UMFPackMatrix;
         break;
       }
+    case SOLVER_CHOLESKY: 
+      {
+        return new CholeskyMatrix;
+        break;
+      }
     default: 
       error("Unknown matrix solver requested.");
   }
@@ -1173,6 +1542,24 @@ Solver* create_solver(MatrixSolverType matrix_solver, Matrix* matrix, Vector* rh
         info("Using UMFPack."); 
         break;
       }
+    case SOLVER_UMFPACK_COMPLEX_BLOCK: 
+      {
+        return new UMFPackComplexBlockSolver(static_cast<UMFPackMatrix*>(matrix), static_cast<UMFPackVector*>(rhs)); 
+        info("Using UMFPack (complex block)."); 
+        break;
+      }
+    case SOLVER_CHOLESKY: 
+      {
+        return new CholeskyLinearSolver(static_cast<CholeskyMatrix*>(matrix), static_cast<UMFPackVector*>(rhs)); 
+        info("Using Cholesky."); 
+        break;
+      }
+    case SOLVER_SADDLE_POINT: 
+      {
+        return new SaddlePointSolver(static_cast<UMFPackMatrix*>(matrix), static_cast<UMFPackVector*>(rhs)); 
+        info("Using block preconditioned GMRES (saddle point)."); 
+        break;
+      }
     default: 
       error("Unknown matrix solver requested.");
   }
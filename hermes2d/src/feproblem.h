@@ -39,6 +39,7 @@ class Matrix;
 class SparseMatrix;
 class Vector;
 class Solver;
+class AsmList;
 
 // Default H2D projection norm in H1 norm.
 extern int H2D_DEFAULT_PROJ_NORM;
@@ -104,6 +105,10 @@ protected:
   int matrix_buffer_dim;                 /// dimension of the matrix held by 'matrix_buffer'
   inline scalar** get_matrix_buffer(int n);
 
+  double* coef_buffer;                   /// buffer for batched matrix forms (coefficients and shape functions)
+  int coef_buffer_size;
+  inline double* get_coef_buffer(int n);
+
   bool have_spaces;
   bool have_matrix;
 
@@ -119,16 +124,38 @@ protected:
   ExtData<scalar>* init_ext_fns(std::vector<MeshFunction *> &ext, RefMap *rm, const int order);
   Func<double>* get_fn(PrecalcShapeset *fu, RefMap *rm, const int order);
 
-  // Caching transformed values for element
+  // Caching transformed values for element.
+  // Shape functions with a non-negative index are kept in a flat table indexed by
+  // (index, order); a slot is valid for the element whose stamp it carries, its buffers
+  // are reused by the following elements. Constrained (negative) indices and shapes
+  // differing only in shapeset or sub-element transform go to the map.
+  struct FnCacheSlot
+  {
+    Func<double>* fn;
+    int stamp;
+    int sub_idx;
+    int shapeset_id;
+  };
+  static const int FN_CACHE_INDICES = 257;
+  static const int FN_CACHE_ORDERS = g_max_quad + 1 + 4 * g_max_quad + 4;
+  FnCacheSlot* fn_cache;
+  int fn_cache_stamp;
+
   std::map<PrecalcShapeset::Key, Func<double>*, PrecalcShapeset::Compare> cache_fn;
-  Geom<double>* cache_e[g_max_quad + 1 + 4 * g_max_quad + 4];
-  double* cache_jwt[g_max_quad + 1 + 4 * g_max_quad + 4];
+  Geom<double>* cache_e[FN_CACHE_ORDERS];
+  double* cache_jwt[FN_CACHE_ORDERS];   // kept across elements
+  int cache_jwt_np[FN_CACHE_ORDERS];    // capacity (number of points depends on the element mode)
 
   void init_cache();
   void delete_cache();
+  void free_cache();
+  double* get_cache_jwt(int order, int np);
 
   scalar eval_form(WeakForm::MatrixFormVol *mfv, Tuple<Solution *> u_ext, 
          PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv);
+  void eval_form_coef(WeakForm::MatrixFormVol *mfv, Tuple<Solution *> u_ext,
+         PrecalcShapeset *fu, PrecalcShapeset *fv, RefMap *ru, RefMap *rv,
+         AsmList *an, AsmList *am, scalar **local, bool sym);
   scalar eval_form(WeakForm::VectorFormVol *vfv, Tuple<Solution *> u_ext, 
          PrecalcShapeset *fv, RefMap *rv);
   scalar eval_form(WeakForm::MatrixFormSurf *mfv, Tuple<Solution *> u_ext, 
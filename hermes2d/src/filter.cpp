@@ -21,6 +21,7 @@
 //// Filter ////////////////////////////////////////////////////////////////////////////////////////
 Filter::Filter(Tuple<MeshFunction*> solutions) : MeshFunction()
 {
+  own_sln = false;
 	this->num = solutions.size();
 	if(num > 10)
 		error("Attempt to create an instance of Filter with more than 10 MeshFunctions."); 
@@ -90,6 +91,27 @@ Filter::~Filter()
       delete [] unidata[i];
     delete [] unidata;
   }
+  if (own_sln)
+    for (int i = 0; i < num; i++)
+      delete sln[i];
+}
+
+
+bool Filter::clone_sln(Tuple<MeshFunction*>& clones)
+{
+  for (int i = 0; i < num; i++)
+  {
+    MeshFunction* fn = sln[i]->clone();
+    if (fn == NULL)
+    {
+      for (unsigned int j = 0; j < clones.size(); j++)
+        delete clones[j];
+      clones = Tuple<MeshFunction*>();
+      return false;
+    }
+    clones.push_back(fn);
+  }
+  return true;
 }
 
 
@@ -31,10 +31,13 @@ class H2D_API Filter : public MeshFunction
 {
 public:
 
-  Filter() {};
+  Filter() { own_sln = false; };
 
   Filter(Tuple<MeshFunction*> solutions);
   virtual ~Filter();
+
+  /// The filter deletes its input functions when destroyed (used for clones).
+  void set_own_sln(bool own) { own_sln = own; }
 	
 	void init(Tuple<MeshFunction*> solutions);
   
@@ -58,8 +61,14 @@ protected:
   bool unimesh;
   UniData** unidata;
 
+  bool own_sln;
+
   void copy_base(Filter* flt);
 
+  /// Clones all input functions (see MeshFunction::clone()). Returns false and
+  /// no clones if any of them cannot be cloned.
+  bool clone_sln(Tuple<MeshFunction*>& clones);
+
 };
 
 
@@ -473,14 +473,28 @@ Nurbs* H2DReader::load_nurbs(Mesh *mesh, MItem* curve, int id, Node** en, int &p
 
 bool H2DReader::load(const char *filename, Mesh *mesh)
 {
-  int i, j, k, n;
-  Node* en;
-  bool debug = false;
-
   // open the mesh file
   FILE* f = fopen(filename, "r");
   if (f == NULL) error("Could not open the mesh file %s", filename);
 
+  return load_file(f, filename, mesh);
+}
+
+bool H2DReader::load_string(const char* mesh_str, Mesh *mesh)
+{
+  // the same format as load(), read from memory
+  FILE* f = fmemopen(const_cast<char*>(mesh_str), strlen(mesh_str), "r");
+  if (f == NULL) error("Could not create the read buffer");
+
+  return load_file(f, "(memory)", mesh);
+}
+
+bool H2DReader::load_file(FILE* f, const char *filename, Mesh *mesh)
+{
+  int i, j, k, n;
+  Node* en;
+  bool debug = false;
+
   mesh->free();
 
   // parse the file
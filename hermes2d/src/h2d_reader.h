@@ -34,7 +34,12 @@ public:
   void load_str(char* mesh_str, Mesh *mesh);
   void load_stream(FILE *f, Mesh *mesh);
 
+  /// Loads the mesh in the format of load() from a string
+  bool load_string(const char* mesh_str, Mesh *mesh);
+
 protected:
+  bool load_file(FILE* f, const char *filename, Mesh *mesh);
+
 	Nurbs* load_nurbs_old(Mesh *mesh, FILE* f, Node** en, int &p1, int &p2);
   Nurbs* load_nurbs(Mesh *mesh, MItem* curve, int id, Node** en, int &p1, int &p2);
 
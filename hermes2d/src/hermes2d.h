@@ -60,6 +60,8 @@
 #include "solver/pardiso.h"
 #include "solver/petsc.h"
 #include "solver/umfpack_solver.h"
+#include "solver/cholesky.h"
+#include "solver/saddle_point.h"
 
 // preconditioners
 #include "solver/precond.h"
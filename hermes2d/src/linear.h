@@ -25,6 +25,17 @@ const double H2D_EPS_NORMAL = 0.0008;
 const double H2D_EPS_HIGH   = 0.0003;
 
 
+/// Active elements shared by the prefetching threads of a Linearizer, taken in chunks.
+struct LinPrefetchQueue
+{
+  int* elems;
+  int num, next;
+  pthread_mutex_t mutex;
+
+  bool next_range(int& first, int& last);
+};
+
+
 /// Linearizer is a utility class which converts a higher-order FEM solution defined on
 /// a curvilinear, irregular mesh to a linear FEM solution defined on a straight-edged,
 /// regular mesh. This is done by adaptive refinement of the higher-order mesh and its
@@ -38,13 +49,18 @@ class H2D_API Linearizer // (implemented in linear1.cpp)
 public:
 
   Linearizer();
-  ~Linearizer();
+  virtual ~Linearizer();
 
   void process_solution(MeshFunction* sln, int item = H2D_FN_VAL_0,
                         double eps = H2D_EPS_NORMAL, double max_abs = -1.0,
                         MeshFunction* xdisp = NULL, MeshFunction* ydisp = NULL,
                         double dmult = 1.0);
 
+  /// Sets the number of threads used to evaluate the function (default 1). The threads
+  /// prefetch the values on clones of the function (MeshFunction::clone()), the
+  /// linearized mesh itself is built serially and does not depend on this setting.
+  void set_num_threads(int num_threads) { this->num_threads = (num_threads > 1) ? num_threads : 1; }
+
   void lock_data() const { pthread_mutex_lock(&data_mutex); }
   void unlock_data() const { pthread_mutex_unlock(&data_mutex); }
 
@@ -57,6 +73,22 @@ public:
   int3* get_edges() const { return edges; }
   int get_num_edges() const { return ne; }
 
+  /// Id of the mesh element each triangle was created from (NULL after load_data()).
+  int* get_triangle_elements() const { return tri_elem; }
+
+  /// Linearizes only the elements e with mask[e->id] set (NULL = all elements).
+  /// The mask is indexed by element id and must stay valid during process_solution().
+  void set_element_mask(const bool* mask) { elem_mask = mask; }
+
+  /// Groups of the elements linearized separately (e.g. with element masks), indexed by
+  /// element id (NULL = no groups). The triangles on the edges between two groups are
+  /// subdivided with the tolerance border_eps and the values of their own element, the
+  /// masked linearization also subdivides the edges of the neighbouring groups. The
+  /// linearizations of the neighbouring groups with the same border_eps and max_abs then
+  /// match without cracks. Straight triangles only.
+  void set_element_groups(const int* groups, double border_eps)
+    { elem_group = groups; this->border_eps = border_eps; }
+
   double get_min_value() const { return min_val; }
   double get_max_value() const { return max_val; }
   virtual void calc_vertices_aabb(double* min_x, double* max_x, double* min_y, double* max_y) const; ///< Returns axis aligned bounding box (AABB) of vertices. Assumes lock.
@@ -82,6 +114,13 @@ protected:
   int3* tris;      ///< triangles: vertex index triplets
   int3* edges;     ///< edges: pairs of vertex indices
   int* hash_table; ///< hash table
+  int* tri_elem;   ///< element ids of triangles
+  int cte;         ///< capacity of tri_elem
+  int cur_elem;    ///< element id of the triangles being added
+  const bool* elem_mask;
+  const int* elem_group;
+  double border_eps;
+  bool border_only; ///< only the vertices on the group edges are created (neighbours of the mask)
 
   int nv, nt, ne; ///< numbers of vertices, triangles and edges
   int cv, ct, ce; ///< capacities of vertex, triangle and edge arrays
@@ -132,18 +171,46 @@ protected:
   }
 
   void process_triangle(int iv0, int iv1, int iv2, int level,
-                        scalar* val, double* phx, double* phy, int* indices);
+                        scalar* val, double* phx, double* phy, int* indices,
+                        int border, double* cval);
 
   void process_quad(int iv0, int iv1, int iv2, int iv3, int level,
                     scalar* val, double* phx, double* phy, int* indices);
 
   void process_edge(int iv1, int iv2, int marker);
+  int get_group_border(Element* e);
   void regularize_triangle(int iv0, int iv1, int iv2, int mid0, int mid1, int mid2);
   void find_min_max();
   void print_hash_stats();
 
   mutable pthread_mutex_t data_mutex;
 
+  /// Function values prefetched by the worker threads.
+  struct LinValues
+  {
+    uint64_t sub_idx;
+    int order;
+    scalar* val[2];
+  };
+
+  int num_threads;
+  std::vector<LinValues>* lin_cache; ///< prefetched values, indexed by element id
+  int lin_cache_size;
+  bool lin_record;                   ///< worker: store the evaluated values to lin_cache
+  LinPrefetchQueue* lin_queue;       ///< worker: elements to process
+
+  scalar* get_lin_values(int order);
+  LinValues* find_lin_values(Element* e, uint64_t sub_idx, int order);
+  void store_lin_values(Element* e, uint64_t sub_idx, int order, int np, scalar* val0, scalar* val1);
+  bool can_prefetch(Mesh* mesh);
+  bool prefetch(Mesh* mesh);
+  void free_lin_cache();
+
+  static void* prefetch_thread(void* data);
+  virtual Linearizer* create_worker();
+  virtual void free_worker();
+  virtual void prefetch_elements();
+
   static void calc_aabb(double* x, double* y, int stride, int num, double* min_x, double* max_x, double* min_y, double* max_y); ///< Calculates AABB from an array of X-axis and Y-axis coordinates. The distance between values in the array is stride bytes.
 };
 
@@ -189,7 +256,7 @@ class H2D_API Vectorizer : public Linearizer // (implemented in linear3.cpp)
 public:
 
   Vectorizer();
-  ~Vectorizer();
+  virtual ~Vectorizer();
 
   void process_solution(MeshFunction* xsln, int xitem, MeshFunction* ysln, int yitem, double eps);
 
@@ -259,6 +326,11 @@ protected:
   void process_quad(int iv0, int iv1, int iv2, int iv3, int level,
                     scalar* xval, scalar* yval, double* phx, double* phy, int* indices);
 
+  void get_lin_values(int order, scalar*& xval, scalar*& yval);
+  virtual Linearizer* create_worker();
+  virtual void free_worker();
+  virtual void prefetch_elements();
+
   void find_min_max();
 
 };
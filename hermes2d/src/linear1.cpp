@@ -132,6 +132,21 @@ Linearizer::Linearizer()
   verts = NULL;
   tris = NULL;
   edges = NULL;
+  info = NULL;
+  hash_table = NULL;
+  tri_elem = NULL;
+  cte = 0;
+  cur_elem = -1;
+  elem_mask = NULL;
+  elem_group = NULL;
+  border_eps = 0.0;
+  border_only = false;
+
+  num_threads = 1;
+  lin_cache = NULL;
+  lin_cache_size = 0;
+  lin_record = false;
+  lin_queue = NULL;
 
   pthread_mutexattr_t attr;
   pthread_mutexattr_init(&attr);
@@ -211,6 +226,9 @@ void Linearizer::add_triangle(int iv0, int iv1, int iv2)
   tris[index][0] = iv0;
   tris[index][1] = iv1;
   tris[index][2] = iv2;
+
+  if (cte < ct) tri_elem = (int*) realloc(tri_elem, sizeof(int) * (cte = ct));
+  tri_elem[index] = cur_elem;
 }
 
 
@@ -243,18 +261,21 @@ void Linearizer::print_hash_stats()
 
 
 void Linearizer::process_triangle(int iv0, int iv1, int iv2, int level,
-                                  scalar* val, double* phx, double* phy, int* idx)
+                                  scalar* val, double* phx, double* phy, int* idx,
+                                  int border, double* cval)
 {
   double midval[3][3];
 
+  // the neighbours of the mask only create the vertices on the group edges
+  if (border_only && !border) return;
+
   if (level < LIN_MAX_LEVEL)
   {
     int i;
     if (!(level & 1))
     {
       // obtain solution values
-      sln->set_quad_order(1, item);
-      val = sln->get_values(ia, ib);
+      val = get_lin_values(1);
       if (auto_max)
         for (i = 0; i < lin_np_tri[1]; i++) {
           double v = getval(i);
@@ -293,16 +314,30 @@ void Linearizer::process_triangle(int iv0, int iv1, int iv2, int level,
       midval[i][2] = (verts[iv2][i] + verts[iv0][i])*0.5;
     };
 
+    // the triangles on the edges between the groups (bit i = edge iv_i, iv_i+1) are tested
+    // with border_eps and the values of their own element (not of the shared vertices),
+    // so all linearizers subdivide them equally
+    double cv[3] = { verts[iv0][2], verts[iv1][2], verts[iv2][2] };
+    double teps = eps;
+    if (border)
+    {
+      for (i = 0; i < 3; i++) cv[i] = cval[i];
+      midval[2][0] = (cv[0] + cv[1])*0.5;
+      midval[2][1] = (cv[1] + cv[2])*0.5;
+      midval[2][2] = (cv[2] + cv[0])*0.5;
+      teps = border_eps;
+    }
+
     // determine whether or not to split the element
     bool split;
-    if (eps >= 1.0)
+    if (teps >= 1.0)
     {
       // if eps > 1, the user wants a fixed number of refinements (no adaptivity)
-      split = (level < eps);
+      split = (level < teps);
     }
     else
     {
-      if (!auto_max && fabs(verts[iv0][2]) > max && fabs(verts[iv1][2]) > max && fabs(verts[iv2][2]) > max)
+      if (!auto_max && fabs(cv[0]) > max && fabs(cv[1]) > max && fabs(cv[2]) > max)
       {
         // do not split if the whole triangle is above the specified maximum value
         split = false;
@@ -313,7 +348,7 @@ void Linearizer::process_triangle(int iv0, int iv1, int iv2, int level,
         double err = fabs(getval(idx[0]) - midval[2][0]) +
                      fabs(getval(idx[1]) - midval[2][1]) +
                      fabs(getval(idx[2]) - midval[2][2]);
-        split = !finite(err) || err > max*3*eps;
+        split = !finite(err) || err > max*3*teps;
       }
 
       // do the same for the curvature
@@ -329,7 +364,7 @@ void Linearizer::process_triangle(int iv0, int iv1, int iv2, int level,
       {
         split = (fabs(getval(8) - 0.5*(midval[2][0] + midval[2][1])) +
                  fabs(getval(9) - 0.5*(midval[2][1] + midval[2][2])) +
-                 fabs(getval(4) - 0.5*(midval[2][2] + midval[2][0]))) > max*3*eps;
+                 fabs(getval(4) - 0.5*(midval[2][2] + midval[2][0]))) > max*3*teps;
       }
     }
 
@@ -347,17 +382,24 @@ void Linearizer::process_triangle(int iv0, int iv1, int iv2, int level,
       int mid1 = get_vertex(iv1, iv2, midval[0][1], midval[1][1], getval(idx[1]));
       int mid2 = get_vertex(iv2, iv0, midval[0][2], midval[1][2], getval(idx[2]));
 
+      // values of the element in the vertices of the sub-elements
+      double cv0[3] = { cv[0], getval(idx[0]), getval(idx[2]) };
+      double cv1[3] = { getval(idx[0]), cv[1], getval(idx[1]) };
+      double cv2[3] = { getval(idx[2]), getval(idx[1]), cv[2] };
+      double cv3[3] = { getval(idx[1]), getval(idx[2]), getval(idx[0]) };
+
       // recur to sub-elements
-      sln->push_transform(0);  process_triangle(iv0, mid0, mid2,  level+1, val, phx, phy, tri_indices[1]);  sln->pop_transform();
-      sln->push_transform(1);  process_triangle(mid0, iv1, mid1,  level+1, val, phx, phy, tri_indices[2]);  sln->pop_transform();
-      sln->push_transform(2);  process_triangle(mid2, mid1, iv2,  level+1, val, phx, phy, tri_indices[3]);  sln->pop_transform();
-      sln->push_transform(3);  process_triangle(mid1, mid2, mid0, level+1, val, phx, phy, tri_indices[4]);  sln->pop_transform();
+      sln->push_transform(0);  process_triangle(iv0, mid0, mid2,  level+1, val, phx, phy, tri_indices[1], border & 5, cv0);  sln->pop_transform();
+      sln->push_transform(1);  process_triangle(mid0, iv1, mid1,  level+1, val, phx, phy, tri_indices[2], border & 3, cv1);  sln->pop_transform();
+      sln->push_transform(2);  process_triangle(mid2, mid1, iv2,  level+1, val, phx, phy, tri_indices[3], border & 6, cv2);  sln->pop_transform();
+      sln->push_transform(3);  process_triangle(mid1, mid2, mid0, level+1, val, phx, phy, tri_indices[4], 0, cv3);  sln->pop_transform();
       return;
     }
   }
 
   // no splitting: output a linear triangle
-  add_triangle(iv0, iv1, iv2);
+  if (!border_only)
+    add_triangle(iv0, iv1, iv2);
 }
 
 
@@ -378,8 +420,7 @@ void Linearizer::process_quad(int iv0, int iv1, int iv2, int iv3, int level,
     if (!(level & 1)) // this is an optimization: do the following only every other time
     {
       // obtain solution values
-      sln->set_quad_order(1, item);
-      val = sln->get_values(ia, ib);
+      val = get_lin_values(1);
       if (auto_max)
         for (i = 0; i < lin_np_quad[1]; i++) {
           double v = getval(i);
@@ -545,6 +586,29 @@ void Linearizer::process_edge(int iv1, int iv2, int marker)
 }
 
 
+//// element groups ////////////////////////////////////////////////////////////////////////////////
+
+int Linearizer::get_group_border(Element* e)
+{
+  // bit i is set if the edge i is not shared with an active element of the same group
+  // (the irregular edges are included, the neighbour is not known); the neighbours of
+  // the mask only need the edges shared with the masked elements
+  if (elem_group == NULL || !e->is_triangle()) return 0;
+  bool outside = (elem_mask != NULL && !elem_mask[e->id]);
+
+  int border = 0;
+  for (unsigned int i = 0; i < e->nvert; i++)
+  {
+    if (e->en[i]->bnd) continue;
+    Element* n = e->get_neighbor(i);
+    bool known = (n != NULL && n->active);
+    if (known && (elem_group[n->id] == elem_group[e->id] || (outside && !elem_mask[n->id]))) continue;
+    border |= (1 << i);
+  }
+  return border;
+}
+
+
 //// regularization ////////////////////////////////////////////////////////////////////////////////
 
 void Linearizer::regularize_triangle(int iv0, int iv1, int iv2, int mid0, int mid1, int mid2)
@@ -703,31 +767,75 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
   nn = mesh->get_max_node_id();
   int* id2id = new int[nn];
   memset(id2id, 0xff, sizeof(int) * nn);
-  bool finished;
+  Element* e;
+  Node* node;
+
+  // with the mask, only the vertices of the masked elements and their parents,
+  // the hanging vertices on their edges are created below from the parents
+  bool* used = NULL;
+  if (elem_mask != NULL)
+  {
+    used = new bool[nn];
+    memset(used, 0, sizeof(bool) * nn);
+    for_all_active_elements(e, mesh)
+      if (elem_mask[e->id])
+        for (unsigned int i = 0; i < e->nvert; i++)
+          used[e->vn[i]->id] = true;
+
+    bool changed;
+    do
+    {
+      changed = false;
+      for_all_vertex_nodes(node, mesh)
+        if (used[node->id] && node->p1 >= 0 && (!used[node->p1] || !used[node->p2]))
+        {
+          used[node->p1] = used[node->p2] = true;
+          changed = true;
+        }
+    }
+    while (changed);
+  }
+
+  bool created;
   do
   {
-    finished = true;
-    Node* node;
+    created = false;
     for_all_vertex_nodes(node, mesh)
     {
       if (id2id[node->id] < 0 && node->ref != TOP_LEVEL_REF)
         if (node->p1 < 0)
-          id2id[node->id] = get_vertex(node->id, node->id, node->x, node->y, 0);
+        {
+          if (used == NULL || used[node->id])
+          {
+            id2id[node->id] = get_vertex(node->id, node->id, node->x, node->y, 0);
+            created = true;
+          }
+        }
         else if (id2id[node->p1] >= 0 && id2id[node->p2] >= 0)
+        {
           id2id[node->id] = get_vertex(id2id[node->p1], id2id[node->p2], node->x, node->y, 0);
-        else
-          finished = false;
+          created = true;
+        }
     }
   }
-  while (!finished);
+  while (created);
+  delete [] used;
 
   auto_max = (max_abs < 0.0);
   max = auto_max ? 0.0 : max_abs;
 
   // obtain the solution in vertices, estimate the maximum solution value
-  Element* e;
+  // (the unmasked neighbours give the values of the hanging vertices)
   for_all_active_elements(e, mesh)
   {
+    if (elem_mask != NULL && !elem_mask[e->id])
+    {
+      bool touches = false;
+      for (unsigned int i = 0; i < e->nvert; i++)
+        if (id2id[e->vn[i]->id] >= 0) touches = true;
+      if (!touches) continue;
+    }
+
     sln->set_active_element(e);
     sln->set_quad_order(0, item);
     scalar* val = sln->get_values(ia, ib);
@@ -746,9 +854,10 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
 
     for (unsigned int i = 0; i < e->nvert; i++)
     {
+      int id = id2id[e->vn[i]->id];
+      if (id < 0) continue;
       double f = getval(i);
       if (auto_max && finite(f) && fabs(f) > max) max = fabs(f);
-      int id = id2id[e->vn[i]->id];
       verts[id][2] = f;
 
       if (disp)
@@ -759,9 +868,24 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
     }
   }
 
+  // evaluate the subdivision in worker threads, the values are taken from lin_cache below
+  if (num_threads > 1 && !disp && can_prefetch(mesh))
+    prefetch(mesh);
+
   // process all elements of the mesh
   for_all_active_elements(e, mesh)
   {
+    // the neighbours of the mask subdivide the group edges shared with the masked elements
+    border_only = (elem_mask != NULL && !elem_mask[e->id]);
+    if (border_only)
+    {
+      bool touches = false;
+      for (unsigned int i = 0; i < e->nvert; i++)
+        if (id2id[e->vn[i]->id] >= 0) touches = true;
+      if (!touches || !get_group_border(e)) continue;
+    }
+    cur_elem = e->id;
+
     sln->set_active_element(e);
     sln->set_quad_order(0, item);
     scalar* val = sln->get_values(ia, ib);
@@ -772,8 +896,12 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
     }
 
     int iv[4];
+    double cval[4];
     for (unsigned int i = 0; i < e->nvert; i++)
+    {
       iv[i] = get_top_vertex(id2id[e->vn[i]->id], getval(i));
+      cval[i] = getval(i);
+    }
 
     // we won't bother calculating physical coordinates from the refmap if this is not a curved element
     curved = e->is_curved();
@@ -781,15 +909,18 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
 
     // recur to sub-elements
     if (e->is_triangle())
-      process_triangle(iv[0], iv[1], iv[2], 0, NULL, NULL, NULL, NULL);
+      process_triangle(iv[0], iv[1], iv[2], 0, NULL, NULL, NULL, NULL, get_group_border(e), cval);
     else
       process_quad(iv[0], iv[1], iv[2], iv[3], 0, NULL, NULL, NULL, NULL);
 
+    if (border_only) continue;
     for (unsigned int i = 0; i < e->nvert; i++)
       process_edge(iv[i], iv[e->next_vert(i)], e->en[i]->marker);
   }
+  border_only = false;
 
   delete [] id2id;
+  free_lin_cache();
 
   // regularize the linear mesh
   int num = nt;
@@ -801,11 +932,14 @@ void Linearizer::process_solution(MeshFunction* sln, int item, double eps, doubl
     int mid2 = peek_vertex(iv2, iv0);
     if (mid0 >= 0 || mid1 >= 0 || mid2 >= 0)
     {
+      cur_elem = tri_elem[i];
       del_triangle(i);
       regularize_triangle(iv0, iv1, iv2, mid0, mid1, mid2);
     }
   }
 
+  cur_elem = -1;
+
   find_min_max();
   //verbose("Linearizer: %d verts, %d tris in %0.3g sec", nv, nt, time_period.tick().last());
   //if (verbose_mode) print_hash_stats();
@@ -827,6 +961,7 @@ void Linearizer::free()
   lin_free_array(verts, nv, cv);
   lin_free_array(tris, nt, ct);
   lin_free_array(edges, ne, ce);
+  if (tri_elem != NULL) { ::free(tri_elem); tri_elem = NULL; cte = 0; }
 }
 
 
@@ -837,6 +972,245 @@ Linearizer::~Linearizer()
 }
 
 
+//// parallel evaluation /////////////////////////////////////////////////////////////////////////
+
+// The worker threads run the same adaptive subdivision as process_solution() on clones
+// of the function, element by element, and store all values they evaluate. The serial
+// pass then takes the values from lin_cache instead of evaluating them again. Where
+// the serial pass subdivides differently (shared vertices, growing maximum), the values
+// are not found and are evaluated as usual, so the result is the same as without workers.
+
+// minimal number of active elements worth the cloning of the function
+static const int LIN_PREFETCH_MIN_ELEMS = 1000;
+
+// number of elements taken by a worker at once
+static const int LIN_PREFETCH_CHUNK = 64;
+
+
+bool LinPrefetchQueue::next_range(int& first, int& last)
+{
+  pthread_mutex_lock(&mutex);
+  first = next;
+  last = next = std::min(next + LIN_PREFETCH_CHUNK, num);
+  pthread_mutex_unlock(&mutex);
+  return first < last;
+}
+
+
+scalar* Linearizer::get_lin_values(int order)
+{
+  if (lin_cache != NULL && !lin_record)
+  {
+    LinValues* lv = find_lin_values(sln->get_active_element(), sln->get_transform(), order);
+    if (lv != NULL && lv->val[0] != NULL) return lv->val[0];
+  }
+
+  sln->set_quad_order(order, item);
+  scalar* val = sln->get_values(ia, ib);
+  if (lin_record)
+    store_lin_values(sln->get_active_element(), sln->get_transform(), order,
+                     sln->get_quad_2d()->get_num_points(order), val, NULL);
+  return val;
+}
+
+
+Linearizer::LinValues* Linearizer::find_lin_values(Element* e, uint64_t sub_idx, int order)
+{
+  if (e == NULL || e->id >= lin_cache_size) return NULL;
+
+  std::vector<LinValues>& values = lin_cache[e->id];
+  for (unsigned int i = 0; i < values.size(); i++)
+    if (values[i].sub_idx == sub_idx && values[i].order == order)
+      return &values[i];
+  return NULL;
+}
+
+
+void Linearizer::store_lin_values(Element* e, uint64_t sub_idx, int order, int np, scalar* val0, scalar* val1)
+{
+  if (e == NULL || e->id >= lin_cache_size || find_lin_values(e, sub_idx, order) != NULL) return;
+
+  LinValues lv;
+  lv.sub_idx = sub_idx;
+  lv.order = order;
+  scalar* val[2] = { val0, val1 };
+  for (int i = 0; i < 2; i++)
+  {
+    lv.val[i] = NULL;
+    if (val[i] == NULL) continue;
+    lv.val[i] = new scalar[np];
+    memcpy(lv.val[i], val[i], sizeof(scalar) * np);
+  }
+  lin_cache[e->id].push_back(lv);
+}
+
+
+bool Linearizer::can_prefetch(Mesh* mesh)
+{
+  if (mesh->get_num_active_elements() < LIN_PREFETCH_MIN_ELEMS) return false;
+
+  // shapesets and quadratures keep the element mode globally and curved
+  // elements use the shared reference map shapeset (curved.cpp)
+  Element* e;
+  for_all_active_elements(e, mesh)
+    if (!e->is_triangle() || e->is_curved()) return false;
+  return true;
+}
+
+
+bool Linearizer::prefetch(Mesh* mesh)
+{
+  // clones are created here, the workers only read the original
+  Linearizer** workers = new Linearizer*[num_threads];
+  int nw;
+  for (nw = 0; nw < num_threads; nw++)
+    if ((workers[nw] = create_worker()) == NULL) break;
+
+  if (nw == num_threads)
+  {
+    LinPrefetchQueue queue;
+    queue.num = 0;
+    queue.next = 0;
+    queue.elems = new int[mesh->get_num_active_elements()];
+    pthread_mutex_init(&queue.mutex, NULL);
+    Element* e;
+    for_all_active_elements(e, mesh)
+      if (elem_mask == NULL || elem_mask[e->id])
+        queue.elems[queue.num++] = e->id;
+
+    lin_cache_size = mesh->get_max_element_id();
+    lin_cache = new std::vector<LinValues>[lin_cache_size];
+
+    pthread_t* threads = new pthread_t[num_threads];
+    for (int i = 0; i < num_threads; i++)
+    {
+      workers[i]->lin_cache = lin_cache;
+      workers[i]->lin_cache_size = lin_cache_size;
+      workers[i]->lin_record = true;
+      workers[i]->lin_queue = &queue;
+      if (pthread_create(&threads[i], NULL, prefetch_thread, workers[i]) != 0)
+        error("Could not create a linearizer thread.");
+    }
+    for (int i = 0; i < num_threads; i++)
+      pthread_join(threads[i], NULL);
+
+    delete [] threads;
+    pthread_mutex_destroy(&queue.mutex);
+    delete [] queue.elems;
+  }
+
+  for (int i = 0; i < nw; i++)
+  {
+    workers[i]->lin_cache = NULL;
+    workers[i]->free_worker();
+    delete workers[i];
+  }
+  delete [] workers;
+
+  return (lin_cache != NULL);
+}
+
+
+void Linearizer::free_lin_cache()
+{
+  if (lin_cache == NULL) return;
+
+  for (int i = 0; i < lin_cache_size; i++)
+    for (unsigned int j = 0; j < lin_cache[i].size(); j++)
+    {
+      delete [] lin_cache[i][j].val[0];
+      delete [] lin_cache[i][j].val[1];
+    }
+  delete [] lin_cache;
+  lin_cache = NULL;
+  lin_cache_size = 0;
+}
+
+
+void* Linearizer::prefetch_thread(void* data)
+{
+  ((Linearizer*) data)->prefetch_elements();
+  return NULL;
+}
+
+
+Linearizer* Linearizer::create_worker()
+{
+  MeshFunction* fn = sln->clone();
+  if (fn == NULL) return NULL;
+
+  Linearizer* lin = new Linearizer();
+  lin->sln = fn;
+  lin->item = item;
+  lin->ia = ia;
+  lin->ib = ib;
+  lin->eps = eps;
+  lin->max = max;
+  lin->auto_max = auto_max;
+  lin->elem_group = elem_group;
+  lin->border_eps = border_eps;
+  lin->xdisp = lin->ydisp = NULL;
+  lin->curved = lin->disp = false;
+  return lin;
+}
+
+
+void Linearizer::free_worker()
+{
+  delete sln;
+  sln = NULL;
+}
+
+
+void Linearizer::prefetch_elements()
+{
+  Mesh* mesh = sln->get_mesh();
+  sln->set_quad_2d(&quad_lin);
+
+  // local vertices and triangles, only the recorded values are used
+  lin_init_array(verts, double3, cv, 4096);
+  lin_init_array(tris, int3, ct, 8192);
+  info = (int4*) malloc(sizeof(int4) * cv);
+  int size = 0x1000;
+  hash_table = (int*) malloc(sizeof(int) * size);
+  mask = size-1;
+
+  int first, last;
+  while (lin_queue->next_range(first, last))
+  {
+    for (int k = first; k < last; k++)
+    {
+      Element* e = mesh->get_element(lin_queue->elems[k]);
+      nv = nt = 0;
+      del_slot = -1;
+      memset(hash_table, 0xff, sizeof(int) * size);
+
+      sln->set_active_element(e);
+      sln->set_quad_order(0, item);
+      scalar* val = sln->get_values(ia, ib);
+
+      int iv[4];
+      double cval[4];
+      for (unsigned int i = 0; i < e->nvert; i++)
+      {
+        iv[i] = get_vertex(-1 - i, -1 - i, e->vn[i]->x, e->vn[i]->y, getval(i));
+        cval[i] = getval(i);
+      }
+
+      if (e->is_triangle())
+        process_triangle(iv[0], iv[1], iv[2], 0, NULL, NULL, NULL, NULL, get_group_border(e), cval);
+      else
+        process_quad(iv[0], iv[1], iv[2], iv[3], 0, NULL, NULL, NULL, NULL);
+    }
+  }
+
+  ::free(hash_table);
+  ::free(info);
+  hash_table = NULL;
+  info = NULL;
+}
+
+
 //// save & load ///////////////////////////////////////////////////////////////////////////////////
 
 void Linearizer::save_data(const char* filename)
@@ -886,6 +1260,7 @@ void Linearizer::load_data(const char* filename)
   read_array(verts, double3, nv, cv, "vertices");
   read_array(tris,  int3,    nt, ct, "triangles");
   read_array(edges, int3,    ne, ce, "edges");
+  if (tri_elem != NULL) { ::free(tri_elem); tri_elem = NULL; cte = 0; }
 
   find_min_max();
   unlock_data();
@@ -105,10 +105,7 @@ void Vectorizer::process_triangle(int iv0, int iv1, int iv2, int level,
     if (!(level & 1))
     {
       // obtain solution values and physical element coordinates
-      xsln->set_quad_order(1, xitem);
-      ysln->set_quad_order(1, yitem);
-      xval = xsln->get_values(xia, xib);
-      yval = ysln->get_values(yia, yib);
+      get_lin_values(1, xval, yval);
       for (i = 0; i < lin_np_tri[1]; i++) {
         double m = getmag(i);
         if (finite(m) && fabs(m) > max) max = fabs(m);
@@ -212,10 +209,7 @@ void Vectorizer::process_quad(int iv0, int iv1, int iv2, int iv3, int level,
     if (!(level & 1))
     {
       // obtain solution values and physical element coordinates
-      xsln->set_quad_order(1, xitem);
-      ysln->set_quad_order(1, yitem);
-      xval = xsln->get_values(xia, xib);
-      yval = ysln->get_values(yia, yib);
+      get_lin_values(1, xval, yval);
       for (i = 0; i < lin_np_quad[1]; i++) {
         double m = getmag(i);
         if (finite(m) && fabs(m) > max) max = fabs(m);
@@ -441,6 +435,10 @@ void Vectorizer::process_solution(MeshFunction* xsln, int xitem, MeshFunction* y
   }
   trav.finish();
 
+  // evaluate the subdivision in worker threads (see Linearizer::prefetch())
+  if (num_threads > 1 && meshes[0]->get_seq() == meshes[1]->get_seq() && can_prefetch(meshes[0]))
+    prefetch(meshes[0]);
+
   trav.begin(2, meshes, fns);
   // process all elements of the mesh
   while ((e = trav.get_next_state(NULL, NULL)) != NULL)
@@ -504,6 +502,7 @@ void Vectorizer::process_solution(MeshFunction* xsln, int xitem, MeshFunction* y
     }
   }
   trav.finish();
+  free_lin_cache();
 
   find_min_max();
 
@@ -522,6 +521,111 @@ void Vectorizer::process_solution(MeshFunction* xsln, int xitem, MeshFunction* y
 }
 
 
+//// parallel evaluation /////////////////////////////////////////////////////////////////////////
+
+void Vectorizer::get_lin_values(int order, scalar*& xval, scalar*& yval)
+{
+  if (lin_cache != NULL && !lin_record)
+  {
+    LinValues* lv = find_lin_values(xsln->get_active_element(), xsln->get_transform(), order);
+    if (lv != NULL && lv->val[0] != NULL && lv->val[1] != NULL)
+    {
+      xval = lv->val[0];
+      yval = lv->val[1];
+      return;
+    }
+  }
+
+  xsln->set_quad_order(order, xitem);
+  ysln->set_quad_order(order, yitem);
+  xval = xsln->get_values(xia, xib);
+  yval = ysln->get_values(yia, yib);
+  if (lin_record)
+    store_lin_values(xsln->get_active_element(), xsln->get_transform(), order,
+                     xsln->get_quad_2d()->get_num_points(order), xval, yval);
+}
+
+
+Linearizer* Vectorizer::create_worker()
+{
+  MeshFunction* xfn = xsln->clone();
+  if (xfn == NULL) return NULL;
+  MeshFunction* yfn = (ysln == xsln) ? xfn : ysln->clone();
+  if (yfn == NULL) { delete xfn; return NULL; }
+
+  Vectorizer* vec = new Vectorizer();
+  vec->xsln = xfn;
+  vec->ysln = yfn;
+  vec->xitem = xitem;
+  vec->yitem = yitem;
+  vec->xia = xia;
+  vec->xib = xib;
+  vec->yia = yia;
+  vec->yib = yib;
+  vec->eps = eps;
+  vec->max = max;
+  vec->curved = false;
+  return vec;
+}
+
+
+void Vectorizer::free_worker()
+{
+  if (ysln != xsln) delete ysln;
+  delete xsln;
+  xsln = ysln = NULL;
+}
+
+
+void Vectorizer::prefetch_elements()
+{
+  Mesh* mesh = xsln->get_mesh();
+  xsln->set_quad_2d((Quad2D*) &quad_lin);
+  ysln->set_quad_2d((Quad2D*) &quad_lin);
+
+  // local vertices and triangles, only the recorded values are used
+  lin_init_array(verts, double4, cv, 4096);
+  lin_init_array(tris, int3, ct, 8192);
+  info = (int4*) malloc(sizeof(int4) * cv);
+  int size = 0x1000;
+  hash_table = (int*) malloc(sizeof(int) * size);
+  mask = size-1;
+
+  int first, last;
+  while (lin_queue->next_range(first, last))
+  {
+    for (int k = first; k < last; k++)
+    {
+      Element* e = mesh->get_element(lin_queue->elems[k]);
+      nv = nt = 0;
+      del_slot = -1;
+      memset(hash_table, 0xff, sizeof(int) * size);
+
+      xsln->set_active_element(e);
+      if (ysln != xsln) ysln->set_active_element(ysln->get_mesh()->get_element(e->id));
+      xsln->set_quad_order(0, xitem);
+      ysln->set_quad_order(0, yitem);
+      scalar* xval = xsln->get_values(xia, xib);
+      scalar* yval = ysln->get_values(yia, yib);
+
+      int iv[4];
+      for (unsigned int i = 0; i < e->nvert; i++)
+        iv[i] = create_vertex(e->vn[i]->x, e->vn[i]->y, getvalx(i), getvaly(i));
+
+      if (e->is_triangle())
+        process_triangle(iv[0], iv[1], iv[2], 0, NULL, NULL, NULL, NULL, NULL);
+      else
+        process_quad(iv[0], iv[1], iv[2], iv[3], 0, NULL, NULL, NULL, NULL, NULL);
+    }
+  }
+
+  ::free(hash_table);
+  ::free(info);
+  hash_table = NULL;
+  info = NULL;
+}
+
+
 //// save & load ///////////////////////////////////////////////////////////////////////////////////
 
 void Vectorizer::save_data(const char* filename)
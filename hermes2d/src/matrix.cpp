@@ -149,7 +149,6 @@ void SparseMatrix::prealloc(int n)
 
 void SparseMatrix::pre_add_ij(int row, int col)
 {
-	_F_
 	if (pages[col] == NULL || pages[col]->count >= PAGE_SIZE) {
 		Page *new_page = new Page;
 		MEM_CHECK(new_page);
@@ -331,6 +331,8 @@ public:
 	virtual void extract_col_copy(int col, int len, int &n_entries, double *vals, int *idxs) { }
 
 	virtual double get_fill_in() const = 0;
+	/// Return the number of nonzero entries of the (full) matrix
+	virtual int get_nnz() const { return (int) (get_fill_in() * size * (double) size + 0.5); }
 
 	unsigned row_storage:1;
 	unsigned col_storage:1;
@@ -23,6 +23,30 @@ H1ShapesetJacobi ref_map_shapeset;
 PrecalcShapeset ref_map_pss(&ref_map_shapeset);
 
 
+// Worker threads (e.g. parallel Linearizer) must not share the precalculated
+// shapeset of the reference map, each of them gets its own instance.
+static pthread_t ref_map_thread = pthread_self();
+static pthread_key_t ref_map_key;
+static pthread_once_t ref_map_key_once = PTHREAD_ONCE_INIT;
+
+static void ref_map_pss_free(void* pss) { delete (PrecalcShapeset*) pss; }
+static void ref_map_key_create() { pthread_key_create(&ref_map_key, ref_map_pss_free); }
+
+static PrecalcShapeset& get_ref_map_pss()
+{
+  if (pthread_equal(pthread_self(), ref_map_thread)) return ref_map_pss;
+
+  pthread_once(&ref_map_key_once, ref_map_key_create);
+  PrecalcShapeset* pss = (PrecalcShapeset*) pthread_getspecific(ref_map_key);
+  if (pss == NULL)
+  {
+    pss = new PrecalcShapeset(&ref_map_shapeset);
+    pthread_setspecific(ref_map_key, pss);
+  }
+  return *pss;
+}
+
+
 RefMap::RefMap()
 {
   quad_2d = NULL;
@@ -37,17 +61,19 @@ RefMap::RefMap()
 
 void RefMap::set_quad_2d(Quad2D* quad_2d)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   free();
   this->quad_2d = quad_2d;
-  ref_map_pss.set_quad_2d(quad_2d);
+  pss.set_quad_2d(quad_2d);
 }
 
 
 void RefMap::set_active_element(Element* e)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   if (e != element) free();
 
-  ref_map_pss.set_active_element(e);
+  pss.set_active_element(e);
   quad_2d->set_mode(e->get_mode());
   num_tables = quad_2d->get_num_tables();
   assert(num_tables <= H2D_MAX_TABLES);
@@ -122,6 +148,7 @@ void RefMap::pop_transform()
 
 void RefMap::calc_inv_ref_map(int order)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   assert(quad_2d != NULL);
   int i, j, np = quad_2d->get_num_points(order);
 
@@ -129,13 +156,13 @@ void RefMap::calc_inv_ref_map(int order)
 
   AUTOLA_OR(double2x2, m, np);
   memset(m, 0, m.size);
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss.force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
     double *dx, *dy;
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order);
-    ref_map_pss.get_dx_dy_values(dx, dy);
+    pss.set_active_shape(indices[i]);
+    pss.set_quad_order(order);
+    pss.get_dx_dy_values(dx, dy);
     for (j = 0; j < np; j++)
     {
       m[j][0][0] += coeffs[i][0] * dx[j];
@@ -169,20 +196,21 @@ void RefMap::calc_inv_ref_map(int order)
 
 void RefMap::calc_second_ref_map(int order)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   assert(quad_2d != NULL);
   int i, j, np = quad_2d->get_num_points(order);
 
   AUTOLA_OR(double3x2, k, np);
   memset(k, 0, k.size);
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss.force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
     double *dxy, *dxx, *dyy;
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order, H2D_FN_ALL);
-    dxx = ref_map_pss.get_dxx_values();
-    dyy = ref_map_pss.get_dyy_values();
-    dxy = ref_map_pss.get_dxy_values();
+    pss.set_active_shape(indices[i]);
+    pss.set_quad_order(order, H2D_FN_ALL);
+    dxx = pss.get_dxx_values();
+    dyy = pss.get_dyy_values();
+    dxy = pss.get_dxy_values();
     for (j = 0; j < np; j++)
     {
       k[j][0][0] += coeffs[i][0] * dxx[j];
@@ -259,16 +287,17 @@ void RefMap::calc_const_inv_ref_map()
 
 void RefMap::calc_phys_x(int order)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   // transform all x coordinates of the integration points
   int i, j, np = quad_2d->get_num_points(order);
   double* x = cur_node->phys_x[order] = new double[np];
   memset(x, 0, np * sizeof(double));
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss.force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order);
-    double* fn = ref_map_pss.get_fn_values();
+    pss.set_active_shape(indices[i]);
+    pss.set_quad_order(order);
+    double* fn = pss.get_fn_values();
     for (j = 0; j < np; j++)
       x[j] += coeffs[i][0] * fn[j];
   }
@@ -277,16 +306,17 @@ void RefMap::calc_phys_x(int order)
 
 void RefMap::calc_phys_y(int order)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   // transform all y coordinates of the integration points
   int i, j, np = quad_2d->get_num_points(order);
   double* y = cur_node->phys_y[order] = new double[np];
   memset(y, 0, np * sizeof(double));
-  ref_map_pss.force_transform(sub_idx, ctm);
+  pss.force_transform(sub_idx, ctm);
   for (i = 0; i < nc; i++)
   {
-    ref_map_pss.set_active_shape(indices[i]);
-    ref_map_pss.set_quad_order(order);
-    double* fn = ref_map_pss.get_fn_values();
+    pss.set_active_shape(indices[i]);
+    pss.set_quad_order(order);
+    double* fn = pss.get_fn_values();
     for (j = 0; j < np; j++)
       y[j] += coeffs[i][1] * fn[j];
   }
@@ -295,6 +325,7 @@ void RefMap::calc_phys_y(int order)
 
 void RefMap::calc_tangent(int edge, int eo)
 {
+  PrecalcShapeset& pss = get_ref_map_pss();
   int i, j;
   int np = quad_2d->get_num_points(eo);
   double3* tan = cur_node->tan[edge] = new double3[np];
@@ -320,13 +351,13 @@ void RefMap::calc_tangent(int edge, int eo)
     static double2x2 m[15];
     assert(np <= 15);
     memset(m, 0, np*sizeof(double2x2));
-    ref_map_pss.force_transform(sub_idx, ctm);
+    pss.force_transform(sub_idx, ctm);
     for (i = 0; i < nc; i++)
     {
       double *dx, *dy;
-      ref_map_pss.set_active_shape(indices[i]);
-      ref_map_pss.set_quad_order(eo);
-      ref_map_pss.get_dx_dy_values(dx, dy);
+      pss.set_active_shape(indices[i]);
+      pss.set_quad_order(eo);
+      pss.get_dx_dy_values(dx, dy);
       for (j = 0; j < np; j++)
       {
         m[j][0][0] += coeffs[i][0] * dx[j];
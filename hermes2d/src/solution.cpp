@@ -167,6 +167,7 @@ void Solution::init()
   mono_coefs = NULL;
   elem_coefs[0] = elem_coefs[1] = NULL;
   elem_orders = NULL;
+  layout_refs = NULL;
   dxdy_buffer = NULL;
   num_coefs = num_elems = 0;
   num_dofs = -1;
@@ -226,6 +227,7 @@ void Solution::assign(Solution* sln)
   elem_coefs[0] = sln->elem_coefs[0];  sln->elem_coefs[0] = NULL;
   elem_coefs[1] = sln->elem_coefs[1];  sln->elem_coefs[1] = NULL;
   elem_orders = sln->elem_orders;      sln->elem_orders = NULL;
+  layout_refs = sln->layout_refs;      sln->layout_refs = NULL;
   dxdy_buffer = sln->dxdy_buffer;      sln->dxdy_buffer = NULL;
   num_coefs = sln->num_coefs;          sln->num_coefs = 0;
   num_elems = sln->num_elems;          sln->num_elems = 0;
@@ -283,6 +285,62 @@ void Solution::copy(const Solution* sln)
 }
 
 
+void Solution::copy_coefs(const Solution* sln, Solution* layout)
+{
+  if (sln->type == UNDEF) error("Solution being copied is uninitialized.");
+
+  // the layout has to match exactly (mono_coefs are indexed by elem_coefs)
+  bool same = (sln->type == SLN && layout != NULL && layout != this && layout->type == SLN &&
+               layout->num_components == sln->num_components && layout->num_elems == sln->num_elems &&
+               layout->space_type == sln->space_type && layout->mesh->get_seq() == sln->mesh->get_seq() &&
+               layout->mesh->get_max_element_id() == sln->mesh->get_max_element_id());
+  if (same)
+    same = !memcmp(layout->elem_orders, sln->elem_orders, sizeof(int) * sln->num_elems);
+  for (int l = 0; same && l < sln->num_components; l++)
+    same = !memcmp(layout->elem_coefs[l], sln->elem_coefs[l], sizeof(int) * sln->num_elems);
+
+  if (!same) { copy(sln); return; }
+
+  free();
+
+  if (layout->layout_refs == NULL)
+  {
+    layout->layout_refs = new int;
+    *layout->layout_refs = 1;
+  }
+  layout_refs = layout->layout_refs;
+  (*layout_refs)++;
+
+  mesh = layout->mesh;
+  own_mesh = layout->own_mesh;
+  elem_orders = layout->elem_orders;
+  for (int l = 0; l < sln->num_components; l++)
+    elem_coefs[l] = layout->elem_coefs[l];
+
+  type = SLN;
+  space_type = sln->space_type;
+  num_components = sln->num_components;
+  num_dofs = sln->num_dofs;
+  num_coefs = sln->num_coefs;
+  num_elems = sln->num_elems;
+
+  mono_coefs = new scalar[num_coefs];
+  memcpy(mono_coefs, sln->mono_coefs, sizeof(scalar) * num_coefs);
+
+  init_dxdy_buffer();
+}
+
+
+MeshFunction* Solution::clone()
+{
+  if (type == UNDEF) return NULL;
+
+  Solution* sln = new Solution();
+  sln->copy(this);
+  return sln;
+}
+
+
 void Solution::free_tables()
 {
   for (int i = 0; i < 4; i++)
@@ -294,9 +352,23 @@ void Solution::free_tables()
 void Solution::free()
 {
   if (mono_coefs  != NULL) { delete [] mono_coefs;   mono_coefs = NULL;  }
-  if (elem_orders != NULL) { delete [] elem_orders;  elem_orders = NULL; }
   if (dxdy_buffer != NULL) { delete [] dxdy_buffer;  dxdy_buffer = NULL; }
 
+  // mesh and element arrays shared by copy_coefs()
+  if (layout_refs != NULL && --(*layout_refs) > 0)
+  {
+    elem_orders = NULL;
+    elem_coefs[0] = elem_coefs[1] = NULL;
+    own_mesh = false;
+  }
+  else if (layout_refs != NULL)
+  {
+    delete layout_refs;
+  }
+  layout_refs = NULL;
+
+  if (elem_orders != NULL) { delete [] elem_orders;  elem_orders = NULL; }
+
   for (int i = 0; i < num_components; i++)
     if (elem_coefs[i] != NULL)
       { delete [] elem_coefs[i];  elem_coefs[i] = NULL; }
@@ -54,6 +54,10 @@ public:
 
   virtual scalar get_pt_value(double x, double y, int item = H2D_FN_VAL_0) = 0;
 
+  /// Returns an independent copy (including the mesh) which can be evaluated in another
+  /// thread, or NULL if the function cannot be cloned. The caller deletes the copy.
+  virtual MeshFunction* clone() { return NULL; }
+
 protected:
 
   int mode;
@@ -100,6 +104,12 @@ public:
   void assign(Solution* sln);
   Solution& operator = (Solution& sln) { assign(&sln); return *this; }
   void copy(const Solution* sln);
+  virtual MeshFunction* clone();
+
+  /// Copies the coefficients of 'sln'. If 'layout' has the same mesh and element orders
+  /// (e.g. a previous time step on the same space), the mesh and the element arrays are
+  /// shared with it (reference counted), otherwise the solution is copied.
+  void copy_coefs(const Solution* sln, Solution* layout);
 
   int* get_element_orders() { return this->elem_orders;}
 
@@ -187,6 +197,7 @@ protected:
   scalar* mono_coefs;  ///< monomial coefficient array
   int* elem_coefs[2];  ///< array of pointers into mono_coefs
   int* elem_orders;    ///< stored element orders
+  int* layout_refs;    ///< reference count of the mesh and element arrays shared by copy_coefs()
   int num_coefs, num_elems;
   int num_dofs;
 
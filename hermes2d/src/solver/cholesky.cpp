@@ -0,0 +1,313 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+extern "C" {
+#include <amd.h>
+}
+
+#include "cholesky.h"
+#include "../../common/trace.h"
+#include "../../common/error.h"
+#include "../../common/utils.h"
+#include "../../common/callstack.h"
+#include "../../common/timer.h"
+
+#include <algorithm>
+
+CholeskyMatrix::CholeskyMatrix() : UMFPackMatrix() {
+	_F_
+}
+
+CholeskyMatrix::~CholeskyMatrix() {
+	_F_
+}
+
+void CholeskyMatrix::pre_add_ij(int row, int col) {
+	// upper triangle only
+	if (row <= col) UMFPackMatrix::pre_add_ij(row, col);
+}
+
+scalar CholeskyMatrix::get(int m, int n) {
+	if (m > n) std::swap(m, n);
+	int k = find_index(Ai + Ap[n], Ap[n + 1] - Ap[n], m);
+	return (k >= 0) ? Ax[Ap[n] + k] : 0.0;
+}
+
+void CholeskyMatrix::add(int m, int n, scalar v) {
+	if (m <= n) UMFPackMatrix::add(m, n, v);
+}
+
+double CholeskyMatrix::get_fill_in() const {
+	_F_
+	return get_nnz() / ((double) size * (double) size);
+}
+
+int CholeskyMatrix::get_nnz() const {
+	_F_
+	// off-diagonal entries are stored once
+	return 2 * Ap[size] - size;
+}
+
+int CholeskyMatrix::find_value(int m, int n) {
+	_F_
+	if (m > n) return -1;		// lower triangle
+	return UMFPackMatrix::find_value(m, n);
+}
+
+// Cholesky solver //////
+
+CholeskyLinearSolver::CholeskyLinearSolver(CholeskyMatrix *m, UMFPackVector *rhs)
+	: LinearSolver(), m(m), rhs(rhs)
+{
+	_F_
+#ifdef H2D_COMPLEX
+	error("Cholesky solver is available for real matrices only.");
+#endif
+	n = 0;
+	P = NULL;
+	Lp = NULL;
+	Li = NULL;
+	Lx = NULL;
+	D = NULL;
+}
+
+CholeskyLinearSolver::~CholeskyLinearSolver() {
+	_F_
+	free_factorization();
+}
+
+void CholeskyLinearSolver::free_factorization() {
+	_F_
+	delete [] P;
+	delete [] Lp;
+	delete [] Li;
+	delete [] Lx;
+	delete [] D;
+	n = 0;
+	P = NULL;
+	Lp = NULL;
+	Li = NULL;
+	Lx = NULL;
+	D = NULL;
+}
+
+bool CholeskyLinearSolver::factorize() {
+	_F_
+#ifndef H2D_COMPLEX
+	free_factorization();
+
+	int *Ap = m->Ap;
+	int *Ai = m->Ai;
+	double *Ax = m->Ax;
+
+	n = m->size;
+
+	// fill-reducing ordering, P[k] is the k-th row (column) of the permuted matrix
+	P = new int[n];
+	MEM_CHECK(P);
+	int *Pinv = new int[n];
+	MEM_CHECK(Pinv);
+	int status = amd_order(n, Ap, Ai, P, NULL, NULL);
+	if (status != AMD_OK && status != AMD_OK_BUT_JUMBLED) {
+		warning("amd_order: ordering failed (%d)", status);
+		delete [] Pinv;
+		free_factorization();
+		return false;
+	}
+	for (int k = 0; k < n; k++) Pinv[P[k]] = k;
+
+	// upper triangle of the permuted matrix C = P A P^T
+	int nnz = Ap[n];
+	int *Cp = new int[n + 1];
+	MEM_CHECK(Cp);
+	int *Ci = new int[nnz > 0 ? nnz : 1];
+	MEM_CHECK(Ci);
+	double *Cx = new double[nnz > 0 ? nnz : 1];
+	MEM_CHECK(Cx);
+	int *W = new int[n];
+	MEM_CHECK(W);
+
+	memset(W, 0, n * sizeof(int));
+	for (int j = 0; j < n; j++)
+		for (int p = Ap[j]; p < Ap[j + 1]; p++)
+			W[std::max(Pinv[Ai[p]], Pinv[j])]++;
+	Cp[0] = 0;
+	for (int j = 0; j < n; j++) {
+		Cp[j + 1] = Cp[j] + W[j];
+		W[j] = Cp[j];
+	}
+	for (int j = 0; j < n; j++)
+		for (int p = Ap[j]; p < Ap[j + 1]; p++) {
+			int i2 = Pinv[Ai[p]], j2 = Pinv[j];
+			int q = W[std::max(i2, j2)]++;
+			Ci[q] = std::min(i2, j2);
+			Cx[q] = Ax[p];
+		}
+
+	// symbolic factorization - elimination tree and column counts of L
+	int *Parent = new int[n];
+	MEM_CHECK(Parent);
+	int *Lnz = new int[n];
+	MEM_CHECK(Lnz);
+	int *Flag = new int[n];
+	MEM_CHECK(Flag);
+	Lp = new int[n + 1];
+	MEM_CHECK(Lp);
+
+	for (int k = 0; k < n; k++) {
+		Parent[k] = -1;
+		Flag[k] = k;
+		Lnz[k] = 0;
+		for (int p = Cp[k]; p < Cp[k + 1]; p++) {
+			// follow the path from i to the root of the etree, stop at the flagged node
+			for (int i = Ci[p]; i < k && Flag[i] != k; i = Parent[i]) {
+				if (Parent[i] == -1) Parent[i] = k;
+				Lnz[i]++;
+				Flag[i] = k;
+			}
+		}
+	}
+	Lp[0] = 0;
+	for (int k = 0; k < n; k++) Lp[k + 1] = Lp[k] + Lnz[k];
+
+	// numeric factorization (up-looking), row k of L by a sparse triangular solve
+	int lnz = Lp[n];
+	Li = new int[lnz > 0 ? lnz : 1];
+	MEM_CHECK(Li);
+	Lx = new double[lnz > 0 ? lnz : 1];
+	MEM_CHECK(Lx);
+	D = new double[n];
+	MEM_CHECK(D);
+	double *Y = new double[n];
+	MEM_CHECK(Y);
+	int *Pattern = W;
+
+	memset(Y, 0, n * sizeof(double));
+	for (int k = 0; k < n; k++) Flag[k] = -1;
+	bool spd = true;
+	for (int k = 0; k < n && spd; k++) {
+		int top = n;
+		Flag[k] = k;
+		Lnz[k] = 0;
+
+		// scatter the column k of C to Y, nonzero pattern of the row k of L in topological order
+		for (int p = Cp[k]; p < Cp[k + 1]; p++) {
+			int i = Ci[p];
+			Y[i] += Cx[p];
+			int len = 0;
+			for (; Flag[i] != k; i = Parent[i]) {
+				Pattern[len++] = i;
+				Flag[i] = k;
+			}
+			while (len > 0) Pattern[--top] = Pattern[--len];
+		}
+
+		D[k] = Y[k];
+		Y[k] = 0.0;
+		for (; top < n; top++) {
+			int i = Pattern[top];
+			double yi = Y[i];
+			Y[i] = 0.0;
+
+			int p2 = Lp[i] + Lnz[i];
+			for (int p = Lp[i]; p < p2; p++)
+				Y[Li[p]] -= Lx[p] * yi;
+
+			double l_ki = yi / D[i];
+			D[k] -= l_ki * yi;
+			Li[p2] = k;
+			Lx[p2] = l_ki;
+			Lnz[i]++;
+		}
+
+		if (!(D[k] > 0.0)) {
+			warning("CholeskyLinearSolver: matrix is not positive definite (pivot %d).", k);
+			spd = false;
+		}
+	}
+
+	factor_nnz = Lp[n] + n;
+
+	delete [] Pinv;
+	delete [] Cp;
+	delete [] Ci;
+	delete [] Cx;
+	delete [] W;
+	delete [] Parent;
+	delete [] Lnz;
+	delete [] Flag;
+	delete [] Y;
+
+	if (!spd) free_factorization();
+	return spd;
+#else
+	return false;
+#endif
+}
+
+bool CholeskyLinearSolver::solve() {
+	_F_
+#ifndef H2D_COMPLEX
+	assert(m != NULL);
+	assert(rhs != NULL);
+
+	assert(m->size == rhs->size);
+
+	Timer tmr;
+	tmr.start();
+
+	if (factorization_scheme != H2D_REUSE_FACTORIZATION_COMPLETELY || P == NULL || n != m->size) {
+		if (!factorize()) return false;
+
+		tmr.stop();
+		factorization_time = tmr.get_seconds();
+		tmr.start(false);
+	}
+	else
+		factorization_time = 0.0;
+
+	delete [] sln;
+	sln = new scalar[n];
+	MEM_CHECK(sln);
+	double *Y = new double[n];
+	MEM_CHECK(Y);
+
+	// x = P^T L^-T D^-1 L^-1 P b
+	for (int k = 0; k < n; k++) Y[k] = rhs->v[P[k]];
+	for (int j = 0; j < n; j++)
+		for (int p = Lp[j]; p < Lp[j + 1]; p++)
+			Y[Li[p]] -= Lx[p] * Y[j];
+	for (int j = 0; j < n; j++)
+		Y[j] /= D[j];
+	for (int j = n - 1; j >= 0; j--)
+		for (int p = Lp[j]; p < Lp[j + 1]; p++)
+			Y[j] -= Lx[p] * Y[Li[p]];
+	for (int k = 0; k < n; k++) sln[P[k]] = Y[k];
+
+	delete [] Y;
+
+	tmr.stop();
+	time = tmr.get_seconds();
+
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,77 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef _CHOLESKY_SOLVER_H_
+#define _CHOLESKY_SOLVER_H_
+
+#include "solver.h"
+#include "umfpack_solver.h"
+
+/// Symmetric matrix, only the upper triangle (row <= col) is stored in CSC
+///
+/// Entries of the lower triangle passed to add() are ignored, the assembled
+/// matrix has to be symmetric (all matrix forms registered with H2D_SYM).
+class CholeskyMatrix : public UMFPackMatrix {
+public:
+	CholeskyMatrix();
+	virtual ~CholeskyMatrix();
+
+	virtual void pre_add_ij(int row, int col);
+	virtual scalar get(int m, int n);
+	virtual void add(int m, int n, scalar v);
+	using UMFPackMatrix::add;
+	virtual double get_fill_in() const;
+	virtual int get_nnz() const;
+
+protected:
+	virtual int find_value(int m, int n);
+
+	friend class CholeskyLinearSolver;
+};
+
+/// Sparse Cholesky (LDL^T) solver for symmetric positive definite matrices
+///
+/// Fill-reducing ordering (AMD), elimination tree and up-looking numeric
+/// factorization of the upper triangle stored in CholeskyMatrix.
+///
+/// @ingroup solvers
+class H2D_API CholeskyLinearSolver : public LinearSolver {
+public:
+	CholeskyLinearSolver(CholeskyMatrix *m, UMFPackVector *rhs);
+	virtual ~CholeskyLinearSolver();
+
+	virtual bool solve();
+
+protected:
+	CholeskyMatrix *m;
+	UMFPackVector *rhs;
+
+	// factorization P A P^T = L D L^T, kept for H2D_REUSE_FACTORIZATION_COMPLETELY
+	int n;
+	int *P;
+	int *Lp;
+	int *Li;
+	double *Lx;
+	double *D;
+	bool factorize();
+	void free_factorization();
+};
+
+#endif
@@ -223,7 +223,7 @@ double EpetraMatrix::get_fill_in() const
 {
 	_F_
 #ifdef HAVE_EPETRA
-	return mat->NumGlobalNonzeros() / (double) (size * size);
+	return mat->NumGlobalNonzeros() / ((double) size * (double) size);
 #else
 	return -1;
 #endif
@@ -174,7 +174,12 @@ int PardisoMatrix::get_matrix_size() const {
 
 double PardisoMatrix::get_fill_in() const {
 	_F_
-	return Ap[size] / (double) (size * size);
+	return get_nnz() / ((double) size * (double) size);
+}
+
+int PardisoMatrix::get_nnz() const {
+	_F_
+	return Ap[size];
 }
 
 void PardisoMatrix::insert_value(int *Ai, scalar *Ax, int Alen, int idx, scalar value) {
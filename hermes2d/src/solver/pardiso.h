@@ -39,6 +39,7 @@ public:
 	virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE);
 	virtual int get_matrix_size() const;
 	virtual double get_fill_in() const;
+	virtual int get_nnz() const;
 
 protected:
 	// PARDISO specific data structures for storing matrix, rhs
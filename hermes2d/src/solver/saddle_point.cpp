@@ -0,0 +1,382 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifdef WITH_UMFPACK
+extern "C" {
+#include <umfpack.h>
+}
+#endif
+
+#include "saddle_point.h"
+#include "../../common/trace.h"
+#include "../../common/error.h"
+#include "../../common/utils.h"
+#include "../../common/callstack.h"
+#include "../../common/timer.h"
+
+#include <algorithm>
+#include <cmath>
+
+SaddlePointSolver::SaddlePointSolver(UMFPackMatrix *m, UMFPackVector *rhs)
+	: UMFPackLinearSolver(m, rhs)
+{
+	_F_
+#ifdef H2D_COMPLEX
+	error("Saddle point solver is available for real matrices only.");
+#endif
+	tol = 1e-10;
+	restart = 50;
+	max_iter = 500;
+	max_reuse_iter = 30;
+
+	num_iters = 0;
+	num_factorizations = 0;
+
+	nv = np = nnz = 0;
+	numeric_a = numeric_s = NULL;
+}
+
+SaddlePointSolver::~SaddlePointSolver() {
+	_F_
+	free_factorization();
+}
+
+void SaddlePointSolver::free_factorization() {
+	_F_
+#ifdef WITH_UMFPACK
+	if (numeric_a != NULL) umfpack_di_free_numeric(&numeric_a);
+	if (numeric_s != NULL) umfpack_di_free_numeric(&numeric_s);
+#endif
+	numeric_a = numeric_s = NULL;
+}
+
+bool SaddlePointSolver::split() {
+	_F_
+	int n = m->size;
+	pressure.assign(n, false);
+	local.assign(n, 0);
+	nv = np = 0;
+	nnz = m->Ap[n];
+
+	// dofs with the zero diagonal belong to the constraint block
+	for (int j = 0; j < n; j++) {
+		int k = UMFPackMatrix::find_index(m->Ai + m->Ap[j], m->Ap[j + 1] - m->Ap[j], j);
+		pressure[j] = (k < 0 || m->Ax[m->Ap[j] + k] == 0.0);
+		local[j] = pressure[j] ? np++ : nv++;
+	}
+
+	return (nv > 0 && np > 0);
+}
+
+bool SaddlePointSolver::factorize() {
+	_F_
+#ifdef WITH_UMFPACK
+	int n = m->size;
+
+	// blocks of the matrix, local indices are ascending in the global ones (columns stay sorted)
+	std::vector<int> Blp(nv + 1), Bli, Cp(np + 1), Ci;
+	std::vector<double> Blx, Cx, D(nv, 0.0);
+	Ap.assign(nv + 1, 0); Ai.clear(); Ax.clear();
+	Btp.assign(np + 1, 0); Bti.clear(); Btx.clear();
+
+	for (int j = 0; j < n; j++) {
+		int lj = local[j];
+		if (!pressure[j]) { Ap[lj] = Ai.size(); Blp[lj] = Bli.size(); }
+		else { Btp[lj] = Bti.size(); Cp[lj] = Ci.size(); }
+
+		for (int p = m->Ap[j]; p < m->Ap[j + 1]; p++) {
+			int i = m->Ai[p];
+			double x = m->Ax[p];
+			if (!pressure[j] && !pressure[i]) {
+				Ai.push_back(local[i]); Ax.push_back(x);
+				if (i == j) D[lj] = x;
+			}
+			else if (!pressure[j]) { Bli.push_back(local[i]); Blx.push_back(x); }
+			else if (!pressure[i]) { Bti.push_back(local[i]); Btx.push_back(x); }
+			else { Ci.push_back(local[i]); Cx.push_back(x); }
+		}
+	}
+	Ap[nv] = Ai.size(); Blp[nv] = Bli.size();
+	Btp[np] = Bti.size(); Cp[np] = Ci.size();
+
+	// Schur complement approximation S = C - B diag(A)^-1 B^T, column by column
+	std::vector<double> w(np, 0.0);
+	std::vector<int> mark(np, -1), pattern;
+	Sp.assign(np + 1, 0); Si.clear(); Sx.clear();
+	for (int j = 0; j < np; j++) {
+		pattern.clear();
+		for (int p = Cp[j]; p < Cp[j + 1]; p++) {
+			int i = Ci[p];
+			if (mark[i] != j) { mark[i] = j; pattern.push_back(i); w[i] = 0.0; }
+			w[i] += Cx[p];
+		}
+		for (int p = Btp[j]; p < Btp[j + 1]; p++) {
+			int k = Bti[p];
+			double f = Btx[p] / ((D[k] != 0.0) ? D[k] : 1.0);
+			for (int q = Blp[k]; q < Blp[k + 1]; q++) {
+				int i = Bli[q];
+				if (mark[i] != j) { mark[i] = j; pattern.push_back(i); w[i] = 0.0; }
+				w[i] -= Blx[q] * f;
+			}
+		}
+		if (mark[j] != j) { mark[j] = j; pattern.push_back(j); w[j] = 0.0; }
+
+		std::sort(pattern.begin(), pattern.end());
+		for (unsigned int k = 0; k < pattern.size(); k++) {
+			Si.push_back(pattern[k]);
+			Sx.push_back(w[pattern[k]]);
+		}
+		Sp[j + 1] = Si.size();
+	}
+
+	// factorization of both blocks
+	void *symbolic;
+	int status = umfpack_di_symbolic(nv, nv, &Ap[0], &Ai[0], &Ax[0], &symbolic, NULL, NULL);
+	if (status != UMFPACK_OK) {
+		warning("SaddlePointSolver: umfpack_di_symbolic of the velocity block failed (%d).", status);
+		return false;
+	}
+	status = umfpack_di_numeric(&Ap[0], &Ai[0], &Ax[0], symbolic, &numeric_a, NULL, NULL);
+	umfpack_di_free_symbolic(&symbolic);
+	if (status != UMFPACK_OK) {
+		warning("SaddlePointSolver: umfpack_di_numeric of the velocity block failed (%d).", status);
+		free_factorization();
+		return false;
+	}
+
+	status = umfpack_di_symbolic(np, np, &Sp[0], &Si[0], &Sx[0], &symbolic, NULL, NULL);
+	if (status != UMFPACK_OK) {
+		warning("SaddlePointSolver: umfpack_di_symbolic of the Schur complement failed (%d).", status);
+		free_factorization();
+		return false;
+	}
+	status = umfpack_di_numeric(&Sp[0], &Si[0], &Sx[0], symbolic, &numeric_s, NULL, NULL);
+	umfpack_di_free_symbolic(&symbolic);
+	if (status != UMFPACK_OK) {
+		warning("SaddlePointSolver: umfpack_di_numeric of the Schur complement failed (%d).", status);
+		free_factorization();
+		return false;
+	}
+
+	num_factorizations++;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool SaddlePointSolver::precond(double *r, double *z) {
+	_F_
+#ifdef WITH_UMFPACK
+	int n = m->size;
+	std::vector<double> rv(nv), rp(np), zv(nv), zp(np);
+	for (int i = 0; i < n; i++) {
+		if (pressure[i]) rp[local[i]] = r[i];
+		else rv[local[i]] = r[i];
+	}
+
+	// [A B^T; 0 S] z = r, pressure first
+	if (umfpack_di_solve(UMFPACK_A, &Sp[0], &Si[0], &Sx[0], &zp[0], &rp[0], numeric_s, NULL, NULL) != UMFPACK_OK)
+		return false;
+	for (int j = 0; j < np; j++)
+		for (int p = Btp[j]; p < Btp[j + 1]; p++)
+			rv[Bti[p]] -= Btx[p] * zp[j];
+	if (umfpack_di_solve(UMFPACK_A, &Ap[0], &Ai[0], &Ax[0], &zv[0], &rv[0], numeric_a, NULL, NULL) != UMFPACK_OK)
+		return false;
+
+	for (int i = 0; i < n; i++)
+		z[i] = pressure[i] ? zp[local[i]] : zv[local[i]];
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+// restarted GMRES with the right preconditioner, x is the initial guess
+bool SaddlePointSolver::gmres(double *x, double *b, int &iters, double &res) {
+	_F_
+	int n = m->size;
+	iters = 0;
+	res = 0.0;
+
+	double bnorm = 0.0;
+	for (int i = 0; i < n; i++) bnorm += b[i] * b[i];
+	bnorm = sqrt(bnorm);
+	if (bnorm == 0.0) {
+		memset(x, 0, n * sizeof(double));
+		return true;
+	}
+
+	std::vector<double> V((restart + 1) * n), H((restart + 1) * restart), cs(restart), sn(restart), g(restart + 1), y(restart);
+	std::vector<double> w(n), z(n);
+
+	while (true) {
+		// residual r = b - K x
+		double *r = &V[0];
+		memcpy(r, b, n * sizeof(double));
+		for (int j = 0; j < n; j++)
+			for (int p = m->Ap[j]; p < m->Ap[j + 1]; p++)
+				r[m->Ai[p]] -= m->Ax[p] * x[j];
+
+		double beta = 0.0;
+		for (int i = 0; i < n; i++) beta += r[i] * r[i];
+		beta = sqrt(beta);
+		res = beta / bnorm;
+		if (res < tol) return true;
+		if (iters >= max_iter) return false;
+
+		for (int i = 0; i < n; i++) r[i] /= beta;
+		std::fill(g.begin(), g.end(), 0.0);
+		g[0] = beta;
+
+		int k = 0;
+		while (k < restart && iters < max_iter) {
+			iters++;
+			double *vk = &V[k * n];
+			double *vk1 = &V[(k + 1) * n];
+
+			// w = K P^-1 v_k
+			if (!precond(vk, &z[0])) return false;
+			std::fill(w.begin(), w.end(), 0.0);
+			for (int j = 0; j < n; j++)
+				for (int p = m->Ap[j]; p < m->Ap[j + 1]; p++)
+					w[m->Ai[p]] += m->Ax[p] * z[j];
+
+			// modified Gram-Schmidt
+			for (int i = 0; i <= k; i++) {
+				double *vi = &V[i * n];
+				double h = 0.0;
+				for (int l = 0; l < n; l++) h += w[l] * vi[l];
+				for (int l = 0; l < n; l++) w[l] -= h * vi[l];
+				H[i * restart + k] = h;
+			}
+			double h = 0.0;
+			for (int l = 0; l < n; l++) h += w[l] * w[l];
+			h = sqrt(h);
+			H[(k + 1) * restart + k] = h;
+			if (h != 0.0)
+				for (int l = 0; l < n; l++) vk1[l] = w[l] / h;
+
+			// Givens rotations of the Hessenberg matrix
+			for (int i = 0; i < k; i++) {
+				double a = H[i * restart + k], c = H[(i + 1) * restart + k];
+				H[i * restart + k] = cs[i] * a + sn[i] * c;
+				H[(i + 1) * restart + k] = -sn[i] * a + cs[i] * c;
+			}
+			double a = H[k * restart + k], c = H[(k + 1) * restart + k];
+			double d = sqrt(a * a + c * c);
+			cs[k] = (d != 0.0) ? a / d : 1.0;
+			sn[k] = (d != 0.0) ? c / d : 0.0;
+			H[k * restart + k] = d;
+			H[(k + 1) * restart + k] = 0.0;
+			g[k + 1] = -sn[k] * g[k];
+			g[k] = cs[k] * g[k];
+
+			k++;
+			if (fabs(g[k]) / bnorm < tol || h == 0.0) break;
+		}
+
+		// x = x + P^-1 V y
+		for (int i = k - 1; i >= 0; i--) {
+			double s = g[i];
+			for (int l = i + 1; l < k; l++) s -= H[i * restart + l] * y[l];
+			y[i] = (H[i * restart + i] != 0.0) ? s / H[i * restart + i] : 0.0;
+		}
+		std::fill(w.begin(), w.end(), 0.0);
+		for (int i = 0; i < k; i++)
+			for (int l = 0; l < n; l++) w[l] += y[i] * V[i * n + l];
+		if (!precond(&w[0], &z[0])) return false;
+		for (int l = 0; l < n; l++) x[l] += z[l];
+	}
+}
+
+bool SaddlePointSolver::solve() {
+	_F_
+#if defined(WITH_UMFPACK) && !defined(H2D_COMPLEX)
+	assert(m != NULL);
+	assert(rhs != NULL);
+
+	assert(m->size == rhs->size);
+
+	Timer tmr;
+	tmr.start();
+
+	int n = m->size;
+
+	// new structure of the matrix (space has changed), blocks are split again
+	bool same = (numeric_a != NULL && (int) pressure.size() == n && nnz == m->Ap[n]);
+	if (!same) {
+		free_factorization();
+		if (!split()) {
+			warning("SaddlePointSolver: matrix has no zero diagonal block, solving by UMFPACK.");
+			pressure.clear();
+			return UMFPackLinearSolver::solve();
+		}
+	}
+
+	// solution of the previous call is the initial guess
+	if (sln == NULL || !same) {
+		delete [] sln;
+		sln = new scalar[n];
+		MEM_CHECK(sln);
+		memset(sln, 0, n * sizeof(scalar));
+	}
+
+	// time of the factorizations (the reused factorization costs nothing)
+	Timer tmr_factor;
+	factorization_time = 0.0;
+
+	bool fresh = false;
+	if (numeric_a == NULL) {
+		tmr_factor.start(false);
+		if (!factorize()) return false;
+		tmr_factor.stop();
+		fresh = true;
+	}
+
+	int iters;
+	double res;
+	bool ok = gmres(sln, rhs->v, iters, res);
+	num_iters = iters;
+
+	// reused factorization does not precondition the current matrix well enough
+	if (!fresh && (!ok || iters > max_reuse_iter)) {
+		free_factorization();
+		tmr_factor.start(false);
+		if (!factorize()) return false;
+		tmr_factor.stop();
+
+		ok = gmres(sln, rhs->v, iters, res);
+		num_iters += iters;
+	}
+
+	if (!ok)
+		warning("SaddlePointSolver: GMRES did not converge (relative residual %g after %d iterations).", res, num_iters);
+
+	tmr.stop();
+	time = tmr.get_seconds();
+	factorization_time = tmr_factor.get_seconds();
+
+	return ok;
+#else
+	return UMFPackLinearSolver::solve();
+#endif
+}
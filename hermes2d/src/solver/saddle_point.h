@@ -0,0 +1,84 @@
+// This file is part of Hermes3D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://hpfem.org/.
+//
+// Hermes3D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes3D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes3D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef _SADDLE_POINT_SOLVER_H_
+#define _SADDLE_POINT_SOLVER_H_
+
+#include "solver.h"
+#include "umfpack_solver.h"
+
+#include <vector>
+
+/// Block preconditioned GMRES for saddle point systems [A B^T; B C]
+///
+/// The constraint unknowns (pressure) are the dofs with a structurally zero
+/// diagonal of the matrix. The preconditioner is the block upper triangular
+/// matrix [A B^T; 0 S] with the velocity block A and the approximation of the
+/// Schur complement S = C - B diag(A)^-1 B^T, both factorized by UMFPACK.
+///
+/// The factorizations are kept between calls of solve() and reused as long as
+/// GMRES converges in less than max_reuse_iter iterations (time steps with the
+/// same spaces), otherwise the blocks are factorized again. Matrices without
+/// the zero diagonal block are solved by UMFPACK directly.
+///
+/// @ingroup solvers
+class H2D_API SaddlePointSolver : public UMFPackLinearSolver {
+public:
+	SaddlePointSolver(UMFPackMatrix *m, UMFPackVector *rhs);
+	virtual ~SaddlePointSolver();
+
+	virtual bool solve();
+
+	void set_tolerance(double tol) { this->tol = tol; }
+	void set_max_reuse_iter(int max_reuse_iter) { this->max_reuse_iter = max_reuse_iter; }
+
+	int get_num_iters() { return num_iters; }
+	int get_num_factorizations() { return num_factorizations; }
+
+protected:
+	double tol;			// relative residual
+	int restart;
+	int max_iter;
+	int max_reuse_iter;
+
+	int num_iters;
+	int num_factorizations;
+
+	// constraint (pressure) dofs, index of the dof in its block
+	std::vector<bool> pressure;
+	std::vector<int> local;
+	int nv, np, nnz;
+
+	// velocity block and Schur complement approximation (CSC) and their factorizations
+	std::vector<int> Ap, Ai, Sp, Si;
+	std::vector<double> Ax, Sx;
+	// B^T (nv x np) for the back substitution
+	std::vector<int> Btp, Bti;
+	std::vector<double> Btx;
+	void *numeric_a, *numeric_s;
+
+	bool split();
+	bool factorize();
+	void free_factorization();
+	bool precond(double *r, double *z);
+	bool gmres(double *x, double *b, int &iters, double &res);
+};
+
+#endif
@@ -29,6 +29,15 @@
 
 class FeProblem;
 
+/// Factorization of the matrix in solve()
+///
+/// The factorization can be reused by direct solvers if the matrix has not
+/// changed since the last solve (e.g. time steps of the same length).
+enum FactorizationScheme {
+	H2D_FACTORIZE_FROM_SCRATCH,
+	H2D_REUSE_FACTORIZATION_COMPLETELY
+};
+
 /// Abstract class for defining solver interface
 ///
 ///
@@ -37,7 +46,7 @@ class FeProblem;
 /// @ingroup solvers
 class Solver {
 public:
-	Solver() { sln = NULL; time = -1.0; }
+	Solver() { sln = NULL; time = -1.0; factorization_time = 0.0; factor_nnz = -1; factorization_scheme = H2D_FACTORIZE_FROM_SCRATCH; }
 	virtual ~Solver() { if (sln != NULL) delete [] sln; }
 
 	virtual bool solve() = 0;
@@ -45,12 +54,20 @@ public:
 
 	int get_error() { return error; }
 	double get_time() { return time; }
+	double get_factorization_time() { return factorization_time; }
+	int get_factor_nnz() { return factor_nnz; }
+
+	/// solvers without the support of the reuse always factorize
+	void set_factorization_scheme(FactorizationScheme scheme) { factorization_scheme = scheme; }
         
 
 protected:
 	scalar *sln;
 	int error;
 	double time;			/// time spent on solving (in secs)
+	double factorization_time;	/// part of the time spent on the factorization (in secs)
+	int factor_nnz;			/// number of nonzeros in the factors (-1 if not known)
+	FactorizationScheme factorization_scheme;
 };
 
 
@@ -33,17 +33,27 @@ extern "C" {
 #include "../../common/callstack.h"
 #include "../../common/timer.h"
 
+#include <algorithm>
+#include <climits>
+
 UMFPackMatrix::UMFPackMatrix() {
 	_F_
 	size = 0;
 	Ap = NULL;
 	Ai = NULL;
 	Ax = NULL;
+	scatter_state = SCATTER_NONE;
+	scatter_pos = 0;
 }
 
 UMFPackMatrix::UMFPackMatrix(int size) {
 	_F_
 	this->size = size;
+	Ap = NULL;
+	Ai = NULL;
+	Ax = NULL;
+	scatter_state = SCATTER_NONE;
+	scatter_pos = 0;
         this->alloc();
 }
 
@@ -52,32 +62,51 @@ UMFPackMatrix::~UMFPackMatrix() {
 	free();
 }
 
+void UMFPackMatrix::prealloc(int n) {
+	_F_
+	this->size = n;
+	pattern.clear();
+}
+
+void UMFPackMatrix::pre_add_ij(int row, int col) {
+	pattern.push_back(((unsigned long long) col << 32) | (unsigned int) row);
+}
+
 void UMFPackMatrix::alloc() {
 	_F_
-	assert(pages != NULL);
         assert(size != 0);
 
+	// sort the (col, row) pairs and remove duplicities
+	std::sort(pattern.begin(), pattern.end());
+	pattern.erase(std::unique(pattern.begin(), pattern.end()), pattern.end());
+	int nnz = pattern.size();
+
 	// initialize the arrays Ap and Ai
 	Ap = new int [size + 1];
 	MEM_CHECK(Ap);
-	int aisize = get_num_indices();
-	Ai = new int [aisize];
+	Ai = new int [nnz > 0 ? nnz : 1];
 	MEM_CHECK(Ai);
 
-	// sort the indices and remove duplicities, insert into Ai
-	int i, pos = 0;
-	for (i = 0; i < size; i++) {
-		Ap[i] = pos;
-		pos += sort_and_store_indices(pages[i], Ai + pos, Ai + aisize);
+	int col = 0;
+	Ap[0] = 0;
+	for (int k = 0; k < nnz; k++) {
+		int c = (int) (pattern[k] >> 32);
+		while (col < c) Ap[++col] = k;
+		Ai[k] = (int) (pattern[k] & 0xffffffff);
 	}
-	Ap[i] = pos;
+	while (col < size) Ap[++col] = nnz;
 
-	delete [] pages;
-	pages = NULL;
+	// release the memory
+	std::vector<unsigned long long>().swap(pattern);
 
-	Ax = new scalar [Ap[size]];
+	Ax = new scalar [nnz > 0 ? nnz : 1];
 	MEM_CHECK(Ax);
-	memset(Ax, 0, sizeof(scalar) * Ap[size]);
+	memset(Ax, 0, sizeof(scalar) * nnz);
+
+	// the first assembly records the scatter map
+	scatter.clear();
+	scatter_state = SCATTER_RECORD;
+	scatter_pos = 0;
 }
 
 void UMFPackMatrix::free() {
@@ -85,11 +114,14 @@ void UMFPackMatrix::free() {
 	delete [] Ap; Ap = NULL;
 	delete [] Ai; Ai = NULL;
 	delete [] Ax; Ax = NULL;
+
+	std::vector<int>().swap(scatter);
+	scatter_state = SCATTER_NONE;
+	scatter_pos = 0;
 }
 
 scalar UMFPackMatrix::get(int m, int n)
 {
-	_F_
 
 	// bin search the value
 	register int lo = Ap[m], hi = Ap[m + 1], mid;
@@ -109,16 +141,59 @@ scalar UMFPackMatrix::get(int m, int n)
 void UMFPackMatrix::zero() {
 	_F_
 	memset(Ax, 0, sizeof(scalar) * Ap[size]);
+
+	// new assembly with the same pattern
+	if (scatter_state == SCATTER_RECORD && !scatter.empty())
+		scatter_state = SCATTER_REPLAY;
+	else if (scatter_state == SCATTER_NONE && Ap != NULL) {
+		scatter.clear();
+		scatter_state = SCATTER_RECORD;
+	}
+	scatter_pos = 0;
 }
 
 void UMFPackMatrix::add(int m, int n, scalar v) {
-	_F_
 	if (v != 0.0 && m >= 0 && n >= 0)		// ignore dirichlet DOFs
 		insert_value(Ai + Ap[n], Ax + Ap[n], Ap[n + 1] - Ap[n], m, v);
 }
 
 void UMFPackMatrix::add(int m, int n, scalar **mat, int *rows, int *cols) {
 	_F_
+	// record layout: m, n, rows[m], cols[n], offsets[m * n] (-1 for dirichlet DOFs)
+	unsigned int len = 2 + m + n + m * n;
+
+	if (scatter_state == SCATTER_REPLAY) {
+		int *rec = (scatter_pos + len <= scatter.size()) ? &scatter[scatter_pos] : NULL;
+		if (rec != NULL && rec[0] == m && rec[1] == n &&
+		    memcmp(rec + 2, rows, m * sizeof(int)) == 0 &&
+		    memcmp(rec + 2 + m, cols, n * sizeof(int)) == 0) {
+			int *offset = rec + 2 + m + n;
+			for (int i = 0; i < m; i++)				// rows
+				for (int j = 0; j < n; j++, offset++)	// cols
+					if (*offset >= 0) Ax[*offset] += mat[i][j];
+
+			scatter_pos += len;
+			return;
+		}
+
+		// assembly order has changed, record again in the next assembly
+		scatter_state = SCATTER_NONE;
+	}
+
+	if (scatter_state == SCATTER_RECORD) {
+		scatter.push_back(m);
+		scatter.push_back(n);
+		scatter.insert(scatter.end(), rows, rows + m);
+		scatter.insert(scatter.end(), cols, cols + n);
+		for (int i = 0; i < m; i++)				// rows
+			for (int j = 0; j < n; j++) {		// cols
+				int idx = find_value(rows[i], cols[j]);
+				scatter.push_back(idx);
+				if (idx >= 0) Ax[idx] += mat[i][j];
+			}
+		return;
+	}
+
 	for (int i = 0; i < m; i++)				// rows
 		for (int j = 0; j < n; j++)			// cols
 			add(rows[i], cols[j], mat[i][j]);
@@ -168,7 +243,36 @@ int UMFPackMatrix::get_matrix_size() const {
 
 double UMFPackMatrix::get_fill_in() const {
 	_F_
-	return Ap[size] / (double) (size * size);
+	return get_nnz() / ((double) size * (double) size);
+}
+
+int UMFPackMatrix::get_nnz() const {
+	_F_
+	return Ap[size];
+}
+
+int UMFPackMatrix::find_value(int m, int n) {
+	_F_
+	if (m < 0 || n < 0) return -1;		// dirichlet DOFs
+
+	int k = find_index(Ai + Ap[n], Ap[n + 1] - Ap[n], m);
+	if (k < 0) EXIT("Sparse matrix entry not found.");
+
+	return Ap[n] + k;
+}
+
+int UMFPackMatrix::find_index(int *Ai, int Alen, int idx) {
+	_F_
+	register int lo = 0, hi = Alen - 1, mid;
+	while (lo <= hi) {
+		mid = (lo + hi) >> 1;
+
+		if (idx < Ai[mid]) hi = mid - 1;
+		else if (idx > Ai[mid]) lo = mid + 1;
+		else return mid;
+	}
+
+	return -1;
 }
 
 void UMFPackMatrix::insert_value(int *Ai, scalar *Ax, int Alen, int idx, scalar value) {
@@ -232,12 +336,10 @@ void UMFPackVector::free() {
 }
 
 void UMFPackVector::set(int idx, scalar y) {
-	_F_
 	if (idx >= 0) v[idx] = y;
 }
 
 void UMFPackVector::add(int idx, scalar y) {
-	_F_
 	if (idx >= 0) v[idx] += y;
 }
 
@@ -300,6 +402,8 @@ UMFPackLinearSolver::UMFPackLinearSolver(UMFPackMatrix *m, UMFPackVector *rhs)
 	: LinearSolver(), m(m), rhs(rhs)
 {
 	_F_
+	symbolic = NULL;
+	numeric = NULL;
 #ifdef WITH_UMFPACK
 #else
 	error("hermes2d was not built with UMFPACK support.");
@@ -309,6 +413,17 @@ UMFPackLinearSolver::UMFPackLinearSolver(UMFPackMatrix *m, UMFPackVector *rhs)
 
 UMFPackLinearSolver::~UMFPackLinearSolver() {
 	_F_
+	free_factorization();
+}
+
+void UMFPackLinearSolver::free_factorization() {
+	_F_
+#ifdef WITH_UMFPACK
+	if (symbolic != NULL) umfpack_free_symbolic(&symbolic);
+	if (numeric != NULL) umfpack_free_numeric(&numeric);
+#endif
+	symbolic = NULL;
+	numeric = NULL;
 }
 
 #ifdef WITH_UMFPACK
@@ -344,22 +459,35 @@ bool UMFPackLinearSolver::solve() {
 	Timer tmr;
 	tmr.start();
 
-	void *symbolic, *numeric;
 	int status;
+	double info[UMFPACK_INFO];
 
-	status = umfpack_symbolic(m->size, m->size, m->Ap, m->Ai, m->Ax, &symbolic, NULL, NULL);
-	if (status != UMFPACK_OK) {
-		check_status("umfpack_di_symbolic", status);
-		return false;
-	}
-	if (symbolic == NULL) EXIT("umfpack_di_symbolic error: symbolic == NULL");
+	if (factorization_scheme != H2D_REUSE_FACTORIZATION_COMPLETELY || numeric == NULL) {
+		free_factorization();
 
-	status = umfpack_numeric(m->Ap, m->Ai, m->Ax, symbolic, &numeric, NULL, NULL);
-	if (status != UMFPACK_OK) {
-		check_status("umfpack_di_numeric", status);
-		return false;
+		status = umfpack_symbolic(m->size, m->size, m->Ap, m->Ai, m->Ax, &symbolic, NULL, NULL);
+		if (status != UMFPACK_OK) {
+			check_status("umfpack_di_symbolic", status);
+			return false;
+		}
+		if (symbolic == NULL) EXIT("umfpack_di_symbolic error: symbolic == NULL");
+
+		status = umfpack_numeric(m->Ap, m->Ai, m->Ax, symbolic, &numeric, NULL, info);
+		if (status != UMFPACK_OK) {
+			check_status("umfpack_di_numeric", status);
+			free_factorization();
+			return false;
+		}
+		if (numeric == NULL) EXIT("umfpack_di_numeric error: numeric == NULL");
+
+		tmr.stop();
+		factorization_time = tmr.get_seconds();
+		tmr.start(false);
+		// unit diagonal of L is counted in LNZ
+		factor_nnz = (int) (info[UMFPACK_LNZ] + info[UMFPACK_UNZ]) - m->size;
 	}
-	if (numeric == NULL) EXIT("umfpack_di_numeric error: numeric == NULL");
+	else
+		factorization_time = 0.0;
 
 	delete [] sln;
 	sln = new scalar[m->size];
@@ -375,11 +503,152 @@ bool UMFPackLinearSolver::solve() {
 	tmr.stop();
 	time = tmr.get_seconds();
 
-	umfpack_free_symbolic(&symbolic);
-	umfpack_free_numeric(&numeric);
-
 	return true;
 #else
 	return false;
 #endif
 }
+
+// UMFPack complex block solver //////
+
+UMFPackComplexBlockSolver::UMFPackComplexBlockSolver(UMFPackMatrix *m, UMFPackVector *rhs)
+	: UMFPackLinearSolver(m, rhs)
+{
+	_F_
+}
+
+UMFPackComplexBlockSolver::~UMFPackComplexBlockSolver() {
+	_F_
+}
+
+bool UMFPackComplexBlockSolver::is_complex_block() {
+	_F_
+	int n = m->size / 2;
+	if (n == 0 || m->size != 2 * n) return false;
+
+	// [A -B; B A] - every entry of the left block column [A; B] has its mirror in the right
+	// block column [-B; A] and vice versa (an entry missing in one of the patterns is zero)
+	for (int j = 0; j < n; j++) {
+		for (int side = 0; side < 2; side++) {
+			int col = (side == 0) ? j : n + j;
+			int mirror = (side == 0) ? n + j : j;
+
+			for (int k = m->Ap[col]; k < m->Ap[col + 1]; k++) {
+				int row = m->Ai[k];
+				scalar value = m->Ax[k];
+
+				int idx = (row >= n) ? row - n : row + n;
+				int pos = UMFPackMatrix::find_index(m->Ai + m->Ap[mirror], m->Ap[mirror + 1] - m->Ap[mirror], idx);
+				scalar expected = (pos >= 0) ? m->Ax[m->Ap[mirror] + pos] : 0.0;
+				// B and -B
+				if ((side == 0 && row >= n) || (side == 1 && row < n)) expected = -expected;
+
+				if (ABS(value - expected) > 1e-10 * (ABS(value) + ABS(expected)) + 1e-300)
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool UMFPackComplexBlockSolver::solve() {
+	_F_
+#if defined(WITH_UMFPACK) && !defined(H2D_COMPLEX)
+	assert(m != NULL);
+	assert(rhs != NULL);
+
+	assert(m->size == rhs->size);
+
+	if (!is_complex_block()) {
+		warning("UMFPackComplexBlockSolver: matrix is not a complex block matrix, solving real system.");
+		return UMFPackLinearSolver::solve();
+	}
+
+	Timer tmr;
+	tmr.start();
+
+	int n = m->size / 2;
+
+	// A + iB from the left block column, rows of A and B are merged
+	int nnz = m->Ap[n];
+	int *Cp = new int[n + 1];
+	MEM_CHECK(Cp);
+	int *Ci = new int[nnz > 0 ? nnz : 1];
+	MEM_CHECK(Ci);
+	double *Cx = new double[nnz > 0 ? nnz : 1];
+	MEM_CHECK(Cx);
+	double *Cz = new double[nnz > 0 ? nnz : 1];
+	MEM_CHECK(Cz);
+
+	int pos = 0;
+	for (int j = 0; j < n; j++) {
+		Cp[j] = pos;
+
+		int ka = m->Ap[j], end = m->Ap[j + 1];
+		int kb = ka;
+		while (kb < end && m->Ai[kb] < n) kb++;
+		int enda = kb;
+
+		while (ka < enda || kb < end) {
+			int ra = (ka < enda) ? m->Ai[ka] : INT_MAX;
+			int rb = (kb < end) ? m->Ai[kb] - n : INT_MAX;
+
+			Ci[pos] = (ra < rb) ? ra : rb;
+			Cx[pos] = (ra <= rb) ? m->Ax[ka++] : 0.0;
+			Cz[pos] = (rb <= ra) ? m->Ax[kb++] : 0.0;
+			pos++;
+		}
+	}
+	Cp[n] = pos;
+
+	void *symbolic, *numeric;
+	int status;
+	bool ok = false;
+
+	status = umfpack_zi_symbolic(n, n, Cp, Ci, Cx, Cz, &symbolic, NULL, NULL);
+	if (status != UMFPACK_OK) {
+		check_status("umfpack_zi_symbolic", status);
+	}
+	else {
+		double info[UMFPACK_INFO];
+		status = umfpack_zi_numeric(Cp, Ci, Cx, Cz, symbolic, &numeric, NULL, info);
+		if (status != UMFPACK_OK) {
+			check_status("umfpack_zi_numeric", status);
+		}
+		else {
+			tmr.stop();
+			factorization_time = tmr.get_seconds();
+			tmr.start(false);
+			factor_nnz = (int) (info[UMFPACK_LNZ] + info[UMFPACK_UNZ]) - n;
+
+			delete [] sln;
+			sln = new scalar[m->size];
+			MEM_CHECK(sln);
+			memset(sln, 0, m->size * sizeof(scalar));
+
+			// real part in [0, n), imaginary part in [n, 2n)
+			status = umfpack_zi_solve(UMFPACK_A, Cp, Ci, Cx, Cz, sln, sln + n, rhs->v, rhs->v + n, numeric, NULL, NULL);
+			if (status != UMFPACK_OK)
+				check_status("umfpack_zi_solve", status);
+			else
+				ok = true;
+
+			umfpack_zi_free_numeric(&numeric);
+		}
+		umfpack_zi_free_symbolic(&symbolic);
+	}
+
+	delete [] Cp;
+	delete [] Ci;
+	delete [] Cx;
+	delete [] Cz;
+
+	tmr.stop();
+	time = tmr.get_seconds();
+
+	return ok;
+#else
+	return UMFPackLinearSolver::solve();
+#endif
+}
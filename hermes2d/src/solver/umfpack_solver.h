@@ -23,6 +23,8 @@
 #include "solver.h"
 #include "../matrix.h"
 
+#include <vector>
+
 class FeProblem;
 
 class UMFPackMatrix : public SparseMatrix {
@@ -31,6 +33,8 @@ public:
 	UMFPackMatrix(int size);
 	virtual ~UMFPackMatrix();
 
+	virtual void prealloc(int n);
+	virtual void pre_add_ij(int row, int col);
 	virtual void alloc();
 	virtual void free();
 	virtual scalar get(int m, int n);
@@ -40,6 +44,7 @@ public:
 	virtual bool dump(FILE *file, const char *var_name, EMatrixDumpFormat fmt = DF_MATLAB_SPARSE);
 	virtual int get_matrix_size() const;
 	virtual double get_fill_in() const;
+	virtual int get_nnz() const;
 
 protected:
 	// UMFPack specific data structures for storing matrix, rhs
@@ -47,9 +52,24 @@ protected:
 	int *Ai;
 	scalar *Ax;
 
+	// nonzero pattern as (col, row) pairs, sorted and deduplicated in alloc()
+	std::vector<unsigned long long> pattern;
+
+	// Scatter map of the block adds. The first assembly after alloc() records
+	// rows, cols and the Ax offsets of every add(m, n, mat, rows, cols) call,
+	// following assemblies (zero() keeps the pattern) replay the offsets.
+	enum ScatterState { SCATTER_RECORD, SCATTER_REPLAY, SCATTER_NONE };
+	ScatterState scatter_state;
+	std::vector<int> scatter;
+	unsigned int scatter_pos;
+
+	virtual int find_value(int m, int n);
+	static int find_index(int *Ai, int Alen, int idx);
 	static void insert_value(int *Ai, scalar *Ax, int Alen, int idx, scalar value);
 
 	friend class UMFPackLinearSolver;
+	friend class UMFPackComplexBlockSolver;
+	friend class SaddlePointSolver;
 };
 
 class UMFPackVector : public Vector {
@@ -72,6 +92,9 @@ protected:
 	scalar *v;
 
 	friend class UMFPackLinearSolver;
+	friend class UMFPackComplexBlockSolver;
+	friend class CholeskyLinearSolver;
+	friend class SaddlePointSolver;
 };
 
 
@@ -88,6 +111,29 @@ public:
 protected:
 	UMFPackMatrix *m;
 	UMFPackVector *rhs;
+
+	// factorization kept for H2D_REUSE_FACTORIZATION_COMPLETELY
+	void *symbolic;
+	void *numeric;
+	void free_factorization();
+};
+
+/// UMFPACK complex solver for the real block form of a complex problem
+///
+/// The matrix [A -B; B A] and rhs [f; g] of two equal spaces (real and imaginary
+/// part) are solved as (A + iB)(x + iy) = f + ig of half the size, the solution
+/// is returned as [x; y]. Matrices of a different structure are solved in real.
+///
+/// @ingroup solvers
+class H2D_API UMFPackComplexBlockSolver : public UMFPackLinearSolver {
+public:
+	UMFPackComplexBlockSolver(UMFPackMatrix *m, UMFPackVector *rhs);
+	virtual ~UMFPackComplexBlockSolver();
+
+	virtual bool solve();
+
+protected:
+	bool is_complex_block();
 };
 
 #endif
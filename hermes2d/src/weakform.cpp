@@ -46,7 +46,7 @@ void WeakForm::add_matrix_form(int i, int j, matrix_form_val_t fn,
   if (mfvol.size() > 100)
     warn("Large number of forms (> 100). Is this the intent?");
 
-  MatrixFormVol form = { i, j, sym, area, fn, ord };
+  MatrixFormVol form = { i, j, sym, area, fn, ord, NULL };
   if (ext.size() != 0) {
     int nx = ext.size(); 
     for (int i = 0; i < nx; i++) form.ext.push_back(ext[i]);
@@ -71,7 +71,31 @@ void WeakForm::add_matrix_form(matrix_form_val_t fn, matrix_form_ord_t ord, SymF
   if (mfvol.size() > 100)
     warn("Large number of forms (> 100). Is this the intent?");
 
-  MatrixFormVol form = { i, j, sym, area, fn, ord };
+  MatrixFormVol form = { i, j, sym, area, fn, ord, NULL };
+  if (ext.size() != 0) {
+    int nx = ext.size(); 
+    for (int i = 0; i < nx; i++) form.ext.push_back(ext[i]);
+  }
+  mfvol.push_back(form);
+  seq++;
+}
+
+void WeakForm::add_matrix_form_coef(int i, int j, matrix_form_coef_t coef,
+                                    matrix_form_ord_t ord, SymFlag sym, int area, Tuple<MeshFunction*>ext)
+{
+  _F_
+  if (i < 0 || i >= neq || j < 0 || j >= neq)
+    error("Invalid equation number.");
+  if (sym < -1 || sym > 1)
+    error("\"sym\" must be -1, 0 or 1.");
+  if (sym < 0 && i == j)
+    error("Only off-diagonal forms can be antisymmetric.");
+  if (area != HERMES_ANY && area < 0 && -area > areas.size())
+    error("Invalid area number.");
+  if (coef == NULL)
+    error("Coefficient function of the batched form is NULL.");
+
+  MatrixFormVol form = { i, j, sym, area, NULL, ord, coef };
   if (ext.size() != 0) {
     int nx = ext.size(); 
     for (int i = 0; i < nx; i++) form.ext.push_back(ext[i]);
@@ -364,6 +388,30 @@ bool** WeakForm::get_blocks()
   return blocks;
 }
 
+bool WeakForm::is_sym() const
+{
+  _F_
+  for (unsigned i = 0; i < mfvol.size(); i++)
+    if (mfvol[i].sym != H2D_SYM) return false;
+
+  for (unsigned i = 0; i < mfsurf.size(); i++)
+    if (mfsurf[i].i != mfsurf[i].j) return false;
+
+  return true;
+}
+
+bool WeakForm::has_matrix_ext() const
+{
+  _F_
+  for (unsigned i = 0; i < mfvol.size(); i++)
+    if (!mfvol[i].ext.empty()) return true;
+
+  for (unsigned i = 0; i < mfsurf.size(); i++)
+    if (!mfsurf[i].ext.empty()) return true;
+
+  return false;
+}
+
 
 //// areas /////////////////////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +33,17 @@ template<typename T> class Func;
 template<typename T> class Geom;
 template<typename T> class ExtData;
 
+/// Coefficients of a batched volume matrix form in the integration points:
+///   a(u,v) = sum wt * (gg * grad u . grad v + uv * u v + udvdx * u dv/dx + udvdy * u dv/dy).
+/// Arrays are zeroed before the call, the form callback adds its terms.
+struct MatrixFormCoef
+{
+  double *gg;
+  double *uv;
+  double *udvdx;
+  double *udvdy;
+};
+
 // Bilinear form symmetry flag, see WeakForm::add_matrix_form
 enum SymFlag
 {
@@ -63,12 +74,16 @@ public:
   typedef Ord (*matrix_form_ord_t)(int n, double *wt, Func<Ord> *u[], Func<Ord> *vi, Func<Ord> *vj, Geom<Ord> *e, ExtData<Ord> *);
   typedef scalar (*vector_form_val_t)(int n, double *wt, Func<scalar> *u[], Func<double> *vi, Geom<double> *e, ExtData<scalar> *);
   typedef Ord (*vector_form_ord_t)(int n, double *wt, Func<Ord> *u[], Func<Ord> *vi, Geom<Ord> *e, ExtData<Ord> *);
+  // batched volume matrix form, the local matrix of the element is evaluated at once (scalar spaces only)
+  typedef void (*matrix_form_coef_t)(int n, Func<scalar> *u[], Geom<double> *e, ExtData<scalar> *, MatrixFormCoef *coef);
 
   // general case
   void add_matrix_form(int i, int j, matrix_form_val_t fn, matrix_form_ord_t ord, 
 		   SymFlag sym = H2D_UNSYM, int area = HERMES_ANY, Tuple<MeshFunction*>ext = Tuple<MeshFunction*>());
   void add_matrix_form(matrix_form_val_t fn, matrix_form_ord_t ord, 
 		   SymFlag sym = H2D_UNSYM, int area = HERMES_ANY, Tuple<MeshFunction*>ext = Tuple<MeshFunction*>()); // single equation case
+  void add_matrix_form_coef(int i, int j, matrix_form_coef_t coef, matrix_form_ord_t ord,
+		   SymFlag sym = H2D_UNSYM, int area = HERMES_ANY, Tuple<MeshFunction*>ext = Tuple<MeshFunction*>());
   void add_matrix_form_surf(int i, int j, matrix_form_val_t fn, matrix_form_ord_t ord, 
 			int area = HERMES_ANY, Tuple<MeshFunction*>ext = Tuple<MeshFunction*>());
   void add_matrix_form_surf(matrix_form_val_t fn, matrix_form_ord_t ord, 
@@ -110,7 +125,7 @@ protected:
     Ord evaluate_ord(int point_cnt, double *weights, Func<Ord> *values_v, Geom<Ord> *geometry, ExtData<Ord> *values_ext_fnc, Element* element, Shapeset* shape_set, int shape_inx); ///< Evaluate order of the user defined function.
 
   // general case
-  struct MatrixFormVol  {  int i, j, sym, area;  matrix_form_val_t fn;  matrix_form_ord_t ord;  std::vector<MeshFunction *> ext; };
+  struct MatrixFormVol  {  int i, j, sym, area;  matrix_form_val_t fn;  matrix_form_ord_t ord;  matrix_form_coef_t coef;  std::vector<MeshFunction *> ext; };
   struct MatrixFormSurf {  int i, j, area;       matrix_form_val_t fn;  matrix_form_ord_t ord;  std::vector<MeshFunction *> ext; };
   struct VectorFormVol  {  int i, area;          vector_form_val_t fn;  vector_form_ord_t ord;  std::vector<MeshFunction *> ext; };
   struct VectorFormSurf {  int i, area;          vector_form_val_t fn;  vector_form_ord_t ord;  std::vector<MeshFunction *> ext; };
@@ -146,7 +161,13 @@ protected:
   bool is_in_area(int marker, int area) const
     { return area >= 0 ? area == marker : is_in_area_2(marker, area); }
 
-  bool is_sym() const { return false; /* not impl. yet */ }
+  /// Symmetric global matrix: all volume forms are registered as H2D_SYM and
+  /// the surface forms are on the diagonal blocks (assumed to be symmetric, u*v type).
+  bool is_sym() const;
+
+  /// Matrix forms with external functions: the matrix changes with them
+  /// (e.g. linearized convection by the previous time step).
+  bool has_matrix_ext() const;
 
   friend class DiscreteProblem;
   friend class RefDiscreteProblem;
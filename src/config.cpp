@@ -53,6 +53,12 @@ void Config::load()
     deleteTriangleMeshFiles = settings.value("Solver/DeleteTriangleMeshFiles", true).toBool();
     deleteHermes2DMeshFile = settings.value("Solver/DeleteHermes2DMeshFile", true).toBool();
 
+    // mesh
+    curvilinearElements = settings.value("Solver/CurvilinearElements", true).toBool();
+
+    // checkpoint
+    checkpointInterval = settings.value("Solver/CheckpointInterval", 0).toInt();
+
     // colors
     colorBackground = settings.value("SceneViewSettings/ColorBackground", COLORBACKGROUND).value<QColor>();
     colorGrid = settings.value("SceneViewSettings/ColorGrid", COLORGRID).value<QColor>();
@@ -142,6 +148,12 @@ void Config::save()
     settings.setValue("Solver/DeleteTriangleMeshFiles", deleteTriangleMeshFiles);
     settings.setValue("Solver/DeleteHermes2DMeshFile", deleteHermes2DMeshFile);
 
+    // mesh
+    settings.setValue("Solver/CurvilinearElements", curvilinearElements);
+
+    // checkpoint
+    settings.setValue("Solver/CheckpointInterval", checkpointInterval);
+
     // colors
     settings.setValue("SceneViewSettings/ColorBackground", colorBackground);
     settings.setValue("SceneViewSettings/ColorGrid", colorGrid);
@@ -55,6 +55,12 @@ public:
     bool deleteTriangleMeshFiles;
     bool deleteHermes2DMeshFile;
 
+    // mesh
+    bool curvilinearElements;
+
+    // checkpoint of the transient solve (time steps, 0 - disabled)
+    int checkpointInterval;
+
     // grid
     double gridStep;
     bool snapToGrid;
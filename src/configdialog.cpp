@@ -69,6 +69,12 @@ void ConfigDialog::load()
     chkDeleteTriangleMeshFiles->setChecked(Util::config()->deleteTriangleMeshFiles);
     chkDeleteHermes2DMeshFile->setChecked(Util::config()->deleteHermes2DMeshFile);
 
+    // mesh
+    chkCurvilinearElements->setChecked(Util::config()->curvilinearElements);
+
+    // checkpoint
+    txtCheckpointInterval->setValue(Util::config()->checkpointInterval);
+
     // save problem with solution
 #ifdef BETA
     chkSaveWithSolution->setChecked(Util::config()->saveProblemWithSolution);
@@ -175,6 +181,12 @@ void ConfigDialog::save()
     Util::config()->deleteTriangleMeshFiles = chkDeleteTriangleMeshFiles->isChecked();
     Util::config()->deleteHermes2DMeshFile = chkDeleteHermes2DMeshFile->isChecked();
 
+    // mesh
+    Util::config()->curvilinearElements = chkCurvilinearElements->isChecked();
+
+    // checkpoint
+    Util::config()->checkpointInterval = txtCheckpointInterval->value();
+
     // save problem with solution
 #ifdef BETA
     Util::config()->saveProblemWithSolution = chkSaveWithSolution->isChecked();
@@ -335,16 +347,29 @@ QWidget *ConfigDialog::createMainWidget()
     // solver layout
     chkDeleteTriangleMeshFiles = new QCheckBox(tr("Delete files with initial mesh (Triangle)"));
     chkDeleteHermes2DMeshFile = new QCheckBox(tr("Delete files with solution mesh (Hermes2D)"));
+    chkCurvilinearElements = new QCheckBox(tr("Curvilinear elements on arcs"));
 #ifdef BETA
     chkSaveWithSolution = new QCheckBox(tr("Save problem with solution"));
 #endif
+    txtCheckpointInterval = new QSpinBox(this);
+    txtCheckpointInterval->setMinimum(0);
+    txtCheckpointInterval->setMaximum(10000);
+    txtCheckpointInterval->setMaximumWidth(60);
+    txtCheckpointInterval->setSpecialValueText(tr("off"));
+
+    QHBoxLayout *layoutCheckpoint = new QHBoxLayout();
+    layoutCheckpoint->addWidget(new QLabel(tr("Checkpoint of transient solve every (time steps):")));
+    layoutCheckpoint->addWidget(txtCheckpointInterval);
+    layoutCheckpoint->addStretch();
 
     QVBoxLayout *layoutSolver = new QVBoxLayout();
     layoutSolver->addWidget(chkDeleteTriangleMeshFiles);
     layoutSolver->addWidget(chkDeleteHermes2DMeshFile);
+    layoutSolver->addWidget(chkCurvilinearElements);
 #ifdef BETA
     layoutSolver->addWidget(chkSaveWithSolution);
 #endif
+    layoutSolver->addLayout(layoutCheckpoint);
 
     QGroupBox *grpSolver = new QGroupBox(tr("Solver"));
     grpSolver->setLayout(layoutSolver);
@@ -63,6 +63,12 @@ private:
     QCheckBox *chkDeleteTriangleMeshFiles;
     QCheckBox *chkDeleteHermes2DMeshFile;
 
+    // mesh
+    QCheckBox *chkCurvilinearElements;
+
+    // checkpoint
+    QSpinBox *txtCheckpointInterval;
+
     // clear command history
     QPushButton *cmdClearCommandHistory;
 
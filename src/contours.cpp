@@ -0,0 +1,311 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "contours.h"
+
+#include "scene.h"
+
+const int CONTOURS_MIN_TRIANGLES_THREAD = 10000; // smaller ranges are not worth a thread
+
+ContourPolyline::ContourPolyline()
+{
+    value = 0.0;
+    isClosed = false;
+}
+
+// range of triangles processed by one thread
+struct ContourChunk
+{
+    double3 *vert;
+    int3 *tris;
+    int from, to;
+    int nv;
+    double step;
+    double levelMin;
+};
+
+// segments of the triangles from - to (runs in a worker thread)
+static QVector<ContourSegment> contourSegments(const ContourChunk &chunk)
+{
+    double3 *vert = chunk.vert;
+    int3 *tris = chunk.tris;
+    int nv = chunk.nv;
+    double step = chunk.step;
+    double levelMin = chunk.levelMin;
+
+    QVector<ContourSegment> segments;
+
+    for (int t = chunk.from; t < chunk.to; t++)
+    {
+        if (!finite(vert[tris[t][0]][2]) || !finite(vert[tris[t][1]][2]) || !finite(vert[tris[t][2]][2]))
+            continue;
+
+        // sort the vertices by their value, keep track of the permutation sign
+        int i, idx[3], perm = 0;
+        memcpy(idx, tris[t], sizeof(idx));
+        for (i = 0; i < 2; i++)
+        {
+            if (vert[idx[0]][2] > vert[idx[1]][2]) { std::swap(idx[0], idx[1]); perm++; }
+            if (vert[idx[1]][2] > vert[idx[2]][2]) { std::swap(idx[1], idx[2]); perm++; }
+        }
+        if (fabs(vert[idx[0]][2] - vert[idx[2]][2]) < 1e-3 * fabs(step)) continue;
+
+        // the first (lowest) contour level
+        double level = ceil(vert[idx[0]][2] / step);
+        double val = level * step;
+
+        // the right edge (0 - 2) is crossed by all levels
+        qint64 right = (qint64) qMin(idx[0], idx[2]) * nv + qMax(idx[0], idx[2]);
+        while (val < vert[idx[2]][2])
+        {
+            int l1 = (val < vert[idx[1]][2]) ? 0 : 1;
+            int l2 = l1 + 1;
+            qint64 left = (qint64) qMin(idx[l1], idx[l2]) * nv + qMax(idx[l1], idx[l2]);
+
+            ContourSegment segment;
+            segment.level = int(level - levelMin);
+            segment.edge[0] = (perm & 1) ? left : right;
+            segment.edge[1] = (perm & 1) ? right : left;
+            segments.append(segment);
+
+            level += 1.0;
+            val = level * step;
+        }
+    }
+
+    return segments;
+}
+
+// crossing of the level with the edge (v1 * nv + v2)
+static Point edgePoint(double3 *vert, int nv, qint64 edge, double value)
+{
+    int v1 = edge / nv;
+    int v2 = edge % nv;
+    double t = (value - vert[v1][2]) / (vert[v2][2] - vert[v1][2]);
+
+    return Point((1.0 - t) * vert[v1][0] + t * vert[v2][0],
+                 (1.0 - t) * vert[v1][1] + t * vert[v2][1]);
+}
+
+Contours::Contours()
+{
+    clear();
+}
+
+void Contours::clear()
+{
+    m_count = 0;
+    m_rangeMin = 0.0;
+    m_rangeMax = 0.0;
+    m_step = 0.0;
+
+    m_polylines.clear();
+}
+
+void Contours::process(Linearizer *linearizer, int count)
+{
+    clear();
+    m_count = count;
+
+    linearizer->lock_data();
+
+    double3 *vert = linearizer->get_vertices();
+    int3 *tris = linearizer->get_triangles();
+    int nv = linearizer->get_num_vertices();
+    int nt = linearizer->get_num_triangles();
+
+    // value range
+    m_rangeMin =  CONST_DOUBLE;
+    m_rangeMax = -CONST_DOUBLE;
+    for (int i = 0; i < nv; i++)
+    {
+        if (vert[i][2] > m_rangeMax) m_rangeMax = vert[i][2];
+        if (vert[i][2] < m_rangeMin) m_rangeMin = vert[i][2];
+    }
+
+    m_step = (m_rangeMax - m_rangeMin) / count;
+    if (nt == 0 || count < 1 || !(m_step > 0.0) || !finite(m_step))
+    {
+        linearizer->unlock_data();
+        return;
+    }
+
+    double levelMin = ceil(m_rangeMin / m_step);
+
+    // extract segments in parallel (chunks are joined in order)
+    int threads = qBound(1, nt / CONTOURS_MIN_TRIANGLES_THREAD, QThread::idealThreadCount());
+    QList<QFuture<QVector<ContourSegment> > > futures;
+    for (int i = 0; i < threads; i++)
+    {
+        ContourChunk chunk;
+        chunk.vert = vert;
+        chunk.tris = tris;
+        chunk.from = (qint64) nt * i / threads;
+        chunk.to = (qint64) nt * (i+1) / threads;
+        chunk.nv = nv;
+        chunk.step = m_step;
+        chunk.levelMin = levelMin;
+
+        futures.append(QtConcurrent::run(contourSegments, chunk));
+    }
+
+    QVector<ContourSegment> segments;
+    for (int i = 0; i < futures.count(); i++)
+        segments += futures[i].result();
+
+    // weld the end points - slot 2*s + e is the end e of the segment s
+    int ns = segments.count();
+    QVector<int> neighbour(2*ns, -1);
+    QHash<QPair<qint64, int>, int> endPoints;
+    for (int slot = 0; slot < 2*ns; slot++)
+    {
+        QPair<qint64, int> key(segments[slot/2].edge[slot%2], segments[slot/2].level);
+
+        QHash<QPair<qint64, int>, int>::iterator it = endPoints.find(key);
+        if (it == endPoints.end())
+        {
+            endPoints.insert(key, slot);
+        }
+        else if (neighbour[it.value()] == -1)
+        {
+            // more than two segments (degenerated triangles) stay open
+            neighbour[it.value()] = slot;
+            neighbour[slot] = it.value();
+        }
+    }
+
+    // walk the chains, open polylines first
+    QVector<bool> visited(ns, false);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int start = 0; start < 2*ns; start++)
+        {
+            if (visited[start/2] || (pass == 0 && neighbour[start] != -1) || (pass == 1 && start % 2 == 1))
+                continue;
+
+            ContourPolyline polyline;
+            polyline.value = (levelMin + segments[start/2].level) * m_step;
+
+            int slot = start;
+            while (true)
+            {
+                polyline.points.append(edgePoint(vert, nv, segments[slot/2].edge[slot%2], polyline.value));
+
+                // other end of the segment
+                if (visited[slot/2])
+                    break;
+                visited[slot/2] = true;
+                slot = slot ^ 1;
+
+                int next = neighbour[slot];
+                if (next == -1)
+                {
+                    // the last point
+                    polyline.points.append(edgePoint(vert, nv, segments[slot/2].edge[slot%2], polyline.value));
+                    break;
+                }
+                if (next == start)
+                {
+                    polyline.isClosed = true;
+                    break;
+                }
+
+                slot = next;
+            }
+
+            m_polylines.append(polyline);
+        }
+    }
+
+    linearizer->unlock_data();
+}
+
+ErrorResult Contours::exportToFile(const QString &fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "dxf")
+        return writeToDxf(fileName);
+    else if (suffix == "csv")
+        return writeToCsv(fileName);
+
+    return ErrorResult(ErrorResultType_Critical, QObject::tr("Unknown format of the file '%1' (dxf, csv).").arg(fileName));
+}
+
+ErrorResult Contours::writeToDxf(const QString &fileName)
+{
+    // save current locale
+    char *plocale = setlocale (LC_NUMERIC, "");
+    setlocale (LC_NUMERIC, "C");
+
+    DL_Dxf* dxf = new DL_Dxf();
+    DL_WriterA *dw = writeDxfStart(dxf, fileName, "contours", 0.0);
+    if (dw == NULL)
+    {
+        delete dxf;
+        setlocale(LC_NUMERIC, plocale);
+        return ErrorResult(ErrorResultType_Critical, QObject::tr("File '%1' cannot be opened.").arg(fileName));
+    }
+
+    for (int i = 0; i < m_polylines.count(); i++)
+    {
+        const ContourPolyline &polyline = m_polylines[i];
+
+        dxf->writePolyline(*dw, DL_PolylineData(polyline.points.count(), 0, 0, polyline.isClosed ? 1 : 0),
+                           DL_Attributes("contours", 256, -1, "BYLAYER"));
+        for (int j = 0; j < polyline.points.count(); j++)
+            dxf->writeVertex(*dw, DL_VertexData(polyline.points[j].x, polyline.points[j].y));
+        dxf->writePolylineEnd(*dw);
+    }
+
+    writeDxfEnd(dxf, dw);
+    delete dxf;
+
+    // set system locale
+    setlocale(LC_NUMERIC, plocale);
+
+    return ErrorResult();
+}
+
+ErrorResult Contours::writeToCsv(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return ErrorResult(ErrorResultType_Critical, QObject::tr("File '%1' cannot be opened.").arg(fileName));
+
+    QTextStream out(&file);
+
+    // header
+    out << "polyline;value;x;y;" << endl;
+
+    // items
+    for (int i = 0; i < m_polylines.count(); i++)
+    {
+        const ContourPolyline &polyline = m_polylines[i];
+        for (int j = 0; j < polyline.points.count(); j++)
+            out << i << ";" << polyline.value << ";" << polyline.points[j].x << ";" << polyline.points[j].y << ";" << endl;
+
+        // closed polyline ends in the first point
+        if (polyline.isClosed && !polyline.points.isEmpty())
+            out << i << ";" << polyline.value << ";" << polyline.points[0].x << ";" << polyline.points[0].y << ";" << endl;
+    }
+
+    file.close();
+
+    return ErrorResult();
+}
@@ -0,0 +1,74 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef CONTOURS_H
+#define CONTOURS_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+// iso-line of one level
+struct ContourPolyline
+{
+    double value;
+    QVector<Point> points;
+    bool isClosed;
+
+    ContourPolyline();
+};
+
+// segment of the iso-line in one triangle (edges are indexed by the vertices)
+struct ContourSegment
+{
+    int level;
+    qint64 edge[2];
+};
+
+// Iso-lines of the linearized solution. Segments are extracted in parallel
+// over ranges of triangles and welded into polylines by (edge, level).
+class Contours
+{
+public:
+    Contours();
+
+    void clear();
+    void process(Linearizer *linearizer, int count);
+
+    inline int count() const { return m_count; }
+    inline double rangeMin() const { return m_rangeMin; }
+    inline double rangeMax() const { return m_rangeMax; }
+    inline double step() const { return m_step; }
+    inline const QList<ContourPolyline> &polylines() const { return m_polylines; }
+
+    // export (format given by the suffix - dxf, csv)
+    ErrorResult exportToFile(const QString &fileName);
+
+private:
+    int m_count;
+    double m_rangeMin;
+    double m_rangeMax;
+    double m_step;
+
+    QList<ContourPolyline> m_polylines;
+
+    ErrorResult writeToDxf(const QString &fileName);
+    ErrorResult writeToCsv(const QString &fileName);
+};
+
+#endif // CONTOURS_H
@@ -0,0 +1,330 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "checkpoint.h"
+
+#include "scene.h"
+#include "hermes_field.h"
+
+const quint32 CHECKPOINT_MAGIC = 0x41324443; // A2DC
+const quint32 CHECKPOINT_VERSION = 1;
+const quint32 CHECKPOINT_STEP = 0x53544550; // STEP
+const int CHECKPOINT_STREAM_VERSION = QDataStream::Qt_4_5;
+
+// H2DReader::save() renumbers the refined elements (the same order as in save_refinements())
+static void savedElementIds(Element *e, int id, int &seq, QMap<int, int> &ids)
+{
+    if (e->active)
+    {
+        ids[e->id] = id;
+        return;
+    }
+
+    int sid = seq;
+    if (e->bsplit())
+    {
+        seq += 4;
+        for (int i = 0; i < 4; i++)
+            savedElementIds(e->sons[i], sid + i, seq, ids);
+    }
+    else if (e->hsplit())
+    {
+        seq += 2;
+        savedElementIds(e->sons[0], sid, seq, ids);
+        savedElementIds(e->sons[1], sid + 1, seq, ids);
+    }
+    else
+    {
+        seq += 2;
+        savedElementIds(e->sons[2], sid, seq, ids);
+        savedElementIds(e->sons[3], sid + 1, seq, ids);
+    }
+}
+
+// runs in the background thread
+static bool writeCheckpointSteps(const QString &fileName, const QList<CheckpointStep> &steps)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(CHECKPOINT_STREAM_VERSION);
+    foreach (CheckpointStep step, steps)
+        stream << CHECKPOINT_STEP << step.time << step.timeStepNext << (qint32) step.rejected << step.coeffs;
+
+    bool isWritten = (stream.status() == QDataStream::Ok) && file.flush();
+    file.close();
+
+    return isWritten;
+}
+
+Checkpoint::Checkpoint(const QString &fileName)
+{
+    m_fileName = fileName;
+
+    m_adaptiveError = 100.0;
+    m_adaptiveSteps = 0;
+    m_ndof = 0;
+}
+
+Checkpoint::~Checkpoint()
+{
+    wait();
+}
+
+QString Checkpoint::checkpointFileName()
+{
+    QString fileName = Util::scene()->problemInfo()->fileName;
+    if (fileName.isEmpty())
+    {
+        // unsaved problem - user data (the temp directory is removed on exit)
+        QString location = QDesktopServices::storageLocation(QDesktopServices::DataLocation) + "/checkpoints";
+        QDir("/").mkpath(location);
+
+        return location + "/" + QString(fingerprint().toHex()) + ".chk";
+    }
+
+    QFileInfo fileInfo(fileName);
+    return fileInfo.absolutePath() + "/" + fileInfo.completeBaseName() + ".chk";
+}
+
+QByteArray Checkpoint::fingerprint()
+{
+    // the checkpoint of the different problem cannot be resumed
+    // (settings, geometry, markers and functions of the document without the solution)
+    QDomDocument doc;
+    Util::scene()->writeToDomDocument(&doc);
+
+    return QCryptographicHash::hash(doc.toByteArray(), QCryptographicHash::Md5);
+}
+
+bool Checkpoint::create(Mesh *mesh, Tuple<Space *> space, double adaptiveError, int adaptiveSteps)
+{
+    wait();
+    m_error.clear();
+
+    m_meshInitial = readScratchContent("mesh");
+
+    // solution mesh (refinements and adaptivity)
+    QString fileNameMesh = tempProblemFileName() + ".chk.mesh";
+    writeMeshFromFile(fileNameMesh, mesh);
+    m_mesh = readFileContentByteArray(fileNameMesh);
+    QFile::remove(fileNameMesh);
+
+    // element orders (ids of the saved mesh)
+    QMap<int, int> ids;
+    int seq = mesh->get_num_base_elements();
+    Element *e;
+    for_all_base_elements(e, mesh)
+        savedElementIds(e, e->id, seq, ids);
+
+    m_orders.clear();
+    for (int i = 0; i < space.size(); i++)
+    {
+        QVector<qint32> orders;
+        for_all_active_elements(e, mesh)
+        {
+            orders.append(ids.value(e->id));
+            orders.append(space.at(i)->get_element_order(e->id));
+        }
+        m_orders.append(orders);
+    }
+
+    m_adaptiveError = adaptiveError;
+    m_adaptiveSteps = adaptiveSteps;
+    m_ndof = get_num_dofs(space);
+    m_steps.clear();
+
+    // header is written to the temporary file (previous checkpoint is kept until it is complete)
+    QFile file(m_fileName + ".tmp");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        m_error = QObject::tr("Checkpoint file '%1' cannot be written.").arg(m_fileName);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(CHECKPOINT_STREAM_VERSION);
+    stream << CHECKPOINT_MAGIC << CHECKPOINT_VERSION << fingerprint() << (quint32) sizeof(scalar);
+    stream << (qint32) m_ndof << m_adaptiveError << (qint32) m_adaptiveSteps;
+    stream << m_meshInitial << m_mesh << m_orders;
+
+    bool isWritten = (stream.status() == QDataStream::Ok) && file.flush();
+    file.close();
+
+    if (!isWritten)
+    {
+        QFile::remove(m_fileName + ".tmp");
+        m_error = QObject::tr("Checkpoint file '%1' cannot be written.").arg(m_fileName);
+        return false;
+    }
+
+    QFile::remove(m_fileName);
+    QFile::rename(m_fileName + ".tmp", m_fileName);
+
+    return true;
+}
+
+void Checkpoint::append(double time, double timeStepNext, int rejected, scalar *coeffs, int ndof)
+{
+    CheckpointStep step;
+    step.time = time;
+    step.timeStepNext = timeStepNext;
+    step.rejected = rejected;
+    step.coeffs = QByteArray((const char *) coeffs, ndof * sizeof(scalar));
+
+    m_buffer.append(step);
+}
+
+void Checkpoint::flush()
+{
+    if (m_buffer.isEmpty())
+        return;
+
+    // one write at a time keeps the order of the steps
+    wait();
+
+    m_future = QtConcurrent::run(writeCheckpointSteps, m_fileName, m_buffer);
+    m_buffer.clear();
+}
+
+bool Checkpoint::wait()
+{
+    // default future is canceled (no write)
+    m_future.waitForFinished();
+    if (m_future.isCanceled())
+        return true;
+
+    bool isWritten = m_future.result();
+    m_future = QFuture<bool>();
+
+    if (!isWritten)
+        m_error = QObject::tr("Checkpoint file '%1' cannot be written.").arg(m_fileName);
+
+    return isWritten;
+}
+
+bool Checkpoint::readHeader(QDataStream &stream)
+{
+    quint32 magic, version, scalarSize;
+    QByteArray hash;
+    qint32 ndof, adaptiveSteps;
+
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION)
+    {
+        m_error = QObject::tr("File '%1' is not a checkpoint.").arg(m_fileName);
+        return false;
+    }
+
+    stream >> hash >> scalarSize;
+    if (hash != fingerprint() || scalarSize != sizeof(scalar))
+    {
+        m_error = QObject::tr("Checkpoint '%1' does not correspond to the problem.").arg(m_fileName);
+        return false;
+    }
+
+    stream >> ndof >> m_adaptiveError >> adaptiveSteps;
+    stream >> m_meshInitial >> m_mesh >> m_orders;
+    if (stream.status() != QDataStream::Ok)
+    {
+        m_error = QObject::tr("Checkpoint '%1' is corrupted.").arg(m_fileName);
+        return false;
+    }
+
+    m_ndof = ndof;
+    m_adaptiveSteps = adaptiveSteps;
+
+    return true;
+}
+
+bool Checkpoint::readHeader()
+{
+    m_error.clear();
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_error = QObject::tr("Checkpoint '%1' does not exist.").arg(m_fileName);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(CHECKPOINT_STREAM_VERSION);
+
+    return readHeader(stream);
+}
+
+bool Checkpoint::read()
+{
+    wait();
+    m_error.clear();
+    m_steps.clear();
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        m_error = QObject::tr("Checkpoint '%1' does not exist.").arg(m_fileName);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(CHECKPOINT_STREAM_VERSION);
+
+    if (!readHeader(stream))
+        return false;
+
+    // complete steps
+    qint64 validSize = file.pos();
+    while (!stream.atEnd())
+    {
+        quint32 magic;
+        qint32 rejected;
+        CheckpointStep step;
+
+        stream >> magic >> step.time >> step.timeStepNext >> rejected >> step.coeffs;
+        if (stream.status() != QDataStream::Ok || magic != CHECKPOINT_STEP ||
+                step.coeffs.size() != m_ndof * (int) sizeof(scalar))
+            break;
+
+        step.rejected = rejected;
+        m_steps.append(step);
+        validSize = file.pos();
+    }
+
+    // drop the truncated step, the resumed solve appends behind the last complete one
+    if (file.size() > validSize)
+        file.resize(validSize);
+
+    return true;
+}
+
+void Checkpoint::setElementOrders(Tuple<Space *> space) const
+{
+    for (int i = 0; i < space.size() && i < m_orders.count(); i++)
+    {
+        const QVector<qint32> &orders = m_orders.at(i);
+        for (int j = 0; j < orders.count() / 2; j++)
+            space.at(i)->set_element_order_internal(orders[2*j], orders[2*j + 1]);
+    }
+
+    // enumerate basis functions
+    assign_dofs(space);
+}
@@ -0,0 +1,93 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+// accepted time step of the transient solve
+struct CheckpointStep
+{
+    double time;
+    double timeStepNext; // length of the next step (adaptive time step)
+    int rejected; // rejected steps so far
+    QByteArray coeffs; // coefficient vector (all fields)
+};
+
+// Binary checkpoint of the transient solve.
+// The header (problem fingerprint, initial and solution mesh, element orders) is written before
+// the time loop, the accepted time steps are buffered and appended periodically by a background
+// thread. A truncated record (crash during the write) is dropped, the solve is resumed from
+// the last complete step.
+class Checkpoint
+{
+public:
+    Checkpoint(const QString &fileName);
+    ~Checkpoint();
+
+    // checkpoint of the actual problem (next to the problem file, unsaved problem in the user data by the fingerprint)
+    static QString checkpointFileName();
+
+    // writer
+    bool create(Mesh *mesh, Tuple<Space *> space, double adaptiveError, int adaptiveSteps);
+    void append(double time, double timeStepNext, int rejected, scalar *coeffs, int ndof);
+    // write the buffered steps in the background
+    void flush();
+    // wait for the pending write
+    bool wait();
+
+    // reader
+    bool readHeader();
+    bool read();
+
+    inline QByteArray meshInitial() const { return m_meshInitial; }
+    inline QByteArray mesh() const { return m_mesh; }
+    void setElementOrders(Tuple<Space *> space) const;
+    inline double adaptiveError() const { return m_adaptiveError; }
+    inline int adaptiveSteps() const { return m_adaptiveSteps; }
+    inline int ndof() const { return m_ndof; }
+    inline QList<CheckpointStep> steps() const { return m_steps; }
+
+    inline QString error() const { return m_error; }
+
+private:
+    QString m_fileName;
+    QString m_error;
+
+    QByteArray m_meshInitial;
+    QByteArray m_mesh;
+    // pairs of the element id (saved mesh) and the order for each space
+    QList<QVector<qint32> > m_orders;
+    double m_adaptiveError;
+    int m_adaptiveSteps;
+    int m_ndof;
+
+    QList<CheckpointStep> m_steps;
+
+    // pending write
+    QList<CheckpointStep> m_buffer;
+    QFuture<bool> m_future;
+
+    static QByteArray fingerprint();
+    bool readHeader(QDataStream &stream);
+};
+
+#endif // CHECKPOINT_H
@@ -76,6 +76,14 @@ Scalar current_matrix_form(int n, double *wt, Func<Real> *u_ext[], Func<Real> *u
         return currentLabel[e->marker].conductivity * 2 * M_PI * int_x_grad_u_grad_v<Real, Scalar>(n, wt, u, v, e);
 }
 
+void current_matrix_form_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    if (isPlanar)
+        coef_grad_u_grad_v(n, coef, currentLabel[e->marker].conductivity);
+    else
+        coef_x_grad_u_grad_v(n, coef, currentLabel[e->marker].conductivity * 2 * M_PI, e);
+}
+
 template<typename Real, typename Scalar>
 Scalar current_vector_form_linear(int n, double *wt, Func<Real> *u_ext[], Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
@@ -90,7 +98,7 @@ void callbackCurrentSpace(Tuple<Space *> space)
 
 void callbackCurrentWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
 {
-    wf->add_matrix_form(0, 0, callback(current_matrix_form));
+    wf->add_matrix_form_coef(0, 0, current_matrix_form_coef, current_matrix_form<Ord, Ord>, H2D_SYM);
     wf->add_vector_form(0, callback(current_vector_form_linear));
     wf->add_vector_form_surf(0, callback(current_vector_form_linear_surf));
 }
@@ -138,6 +138,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterCurrent(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeCurrentMarker : public SceneEdgeMarker {
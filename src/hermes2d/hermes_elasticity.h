@@ -123,6 +123,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterElasticity(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeElasticityMarker : public SceneEdgeMarker
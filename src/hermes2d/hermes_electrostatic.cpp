@@ -77,6 +77,14 @@ Scalar electrostatic_matrix_form_linear(int n, double *wt, Func<Real> *u_ext[],
         return electrostaticLabel[e->marker].permittivity * 2 * M_PI * int_x_grad_u_grad_v<Real, Scalar>(n, wt, u, v, e);
 }
 
+void electrostatic_matrix_form_linear_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    if (isPlanar)
+        coef_grad_u_grad_v(n, coef, electrostaticLabel[e->marker].permittivity);
+    else
+        coef_x_grad_u_grad_v(n, coef, electrostaticLabel[e->marker].permittivity * 2 * M_PI, e);
+}
+
 template<typename Real, typename Scalar>
 Scalar electrostatic_vector_form_linear(int n, double *wt, Func<Real> *u_ext[], Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
@@ -94,7 +102,7 @@ void callbackElectrostaticSpace(Tuple<Space *> space)
 
 void callbackElectrostaticWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
 {
-    wf->add_matrix_form(0, 0, callback(electrostatic_matrix_form_linear));
+    wf->add_matrix_form_coef(0, 0, electrostatic_matrix_form_linear_coef, electrostatic_matrix_form_linear<Ord, Ord>, H2D_SYM);
     wf->add_vector_form(0, callback(electrostatic_vector_form_linear));
     wf->add_vector_form_surf(0, callback(electrostatic_vector_form_linear_surf));
 }
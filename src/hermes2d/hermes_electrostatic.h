@@ -139,6 +139,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterElectrostatic(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeElectrostaticMarker : public SceneEdgeMarker
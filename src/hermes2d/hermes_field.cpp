@@ -26,8 +26,12 @@
 #include "hermes_current.h"
 #include "hermes_elasticity.h"
 #include "hermes_flow.h"
+#include "timestepping.h"
+#include "checkpoint.h"
 
 #include "scene.h"
+#include "meshsizefield.h"
+#include "movingband.h"
 #include "h2d_reader.h"
 
 // #include <InpMtx.h>
@@ -80,6 +84,23 @@ Mesh *readMeshFromFile(const QString &fileName)
     return mesh;
 }
 
+Mesh *readMeshFromString(const QByteArray &content)
+{
+    // save locale
+    char *plocale = setlocale (LC_NUMERIC, "");
+    setlocale (LC_NUMERIC, "C");
+
+    // load the mesh from memory
+    Mesh *mesh = new Mesh();
+    H2DReader meshloader;
+    meshloader.load_string(content.constData(), mesh);
+
+    // set system locale
+    setlocale(LC_NUMERIC, plocale);
+
+    return mesh;
+}
+
 void writeMeshFromFile(const QString &fileName, Mesh *mesh)
 {
     // save locale
@@ -93,20 +114,56 @@ void writeMeshFromFile(const QString &fileName, Mesh *mesh)
     setlocale(LC_NUMERIC, plocale);
 }
 
-SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptiveError = 0.0, double adaptiveSteps = 0.0, double time = 0.0)
+SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptiveError = 0.0, double adaptiveSteps = 0.0, double time = 0.0,
+                             SolutionArray *previous = NULL, const double *derivative = NULL)
 {
     SolutionArray *solution = new SolutionArray();
-    solution->order = new Orderizer();
-    if (space) solution->order->process_solution(space);
+
+    // previous time step on the same space - order view, mesh and element arrays are shared
+    if (previous)
+    {
+        solution->order = previous->order;
+    }
+    else
+    {
+        solution->order = QSharedPointer<Orderizer>(new Orderizer());
+        if (space) solution->order->process_solution(space);
+    }
+
     solution->sln = new Solution();
-    if (sln) solution->sln->copy(sln);
+    if (sln)
+    {
+        if (previous)
+            solution->sln->copy_coefs(sln, previous->sln);
+        else
+            solution->sln->copy(sln);
+    }
     solution->adaptiveError = adaptiveError;
     solution->adaptiveSteps = adaptiveSteps;
     solution->time = time;
+    if (derivative)
+        for (int i = 0; i < 3; i++)
+            solution->derivative[i] = derivative[i];
 
     return solution;
 }
 
+// matrix solver phases and counters (factorization is measured by the solver)
+static void solverInfoMatrix(SolverInfo &solverInfo, SparseMatrix *matrix, Solver *solver)
+{
+    if (solver->get_time() >= 0.0)
+    {
+        solverInfo.addPhase("factorization", solver->get_factorization_time());
+        solverInfo.addPhase("back-solve", qMax(0.0, solver->get_time() - solver->get_factorization_time()));
+    }
+
+    double nonzeros = matrix->get_nnz();
+    solverInfo.setCounter("dofs", matrix->get_size());
+    solverInfo.setCounter("nonzeros", nonzeros);
+    if ((solver->get_factor_nnz() >= 0) && (nonzeros > 0.0))
+        solverInfo.setCounter("fill-in", solver->get_factor_nnz() / nonzeros);
+}
+
     QList<SolutionArray *> *solveSolutioArray(ProgressItemSolve *progressItemSolve,
                                           void (*cbSpace)(Tuple<Space *>),
                                           void (*cbWeakForm)(WeakForm *, Tuple<Solution *>))
@@ -131,11 +188,49 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
     // solution agros array
     QList<SolutionArray *> *solutionArrayList = new QList<SolutionArray *>();
 
+    // phases of the solve
+    SolverInfo &solverInfo = Util::scene()->sceneSolution()->solverInfo();
+
+    // checkpoint of the transient solve
+    Checkpoint checkpoint(Checkpoint::checkpointFileName());
+    bool isResume = progressItemSolve->isResume();
+    if (isResume)
+    {
+        if (analysisType != AnalysisType_Transient)
+        {
+            progressItemSolve->emitMessage(QObject::tr("Only transient solve can be resumed."), true);
+            return solutionArrayList;
+        }
+        if (!checkpoint.read())
+        {
+            progressItemSolve->emitMessage(checkpoint.error(), true);
+            return solutionArrayList;
+        }
+    }
+
     // load the mesh file
-    Mesh *mesh = readMeshFromFile(tempProblemFileName() + ".mesh");
-    // refine mesh
-    for (int i = 0; i < Util::scene()->problemInfo()->numberOfRefinements; i++)
-        mesh->refine_all_elements(0);
+    solverInfo.start("mesh load");
+    Mesh *mesh;
+    if (isResume)
+    {
+        // refined and adapted mesh of the checkpoint
+        mesh = readMeshFromString(checkpoint.mesh());
+    }
+    else
+    {
+        mesh = readMeshFromString(readScratchContent("mesh"));
+        // refine mesh
+        for (int i = 0; i < Util::scene()->problemInfo()->numberOfRefinements; i++)
+            mesh->refine_all_elements(0);
+        // local refinement (mesh size of the edges), the rotor edges follow the moving band
+        MeshSizeField meshSizeField(Util::scene()->edges, Util::scene()->problemInfo()->meshGradation);
+        if (MovingBand *movingBand = Util::scene()->sceneSolution()->movingBand())
+            meshSizeField.setRotor(movingBand->center(), movingBand->radiusInner(), movingBand->angle());
+        meshSizeField.refine(mesh, MESHSIZEFIELD_MAX_STEPS);
+    }
+    solverInfo.stop();
+
+    solverInfo.start("space");
 
     // initialize the shapeset
     H1Shapeset shapeset;
@@ -166,7 +261,12 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
     // callback space
     cbSpace(space);
 
+    // element orders of the checkpoint (adaptivity)
+    if (isResume)
+        checkpoint.setElementOrders(space);
+
     int ndof = get_num_dofs(space);
+    solverInfo.stop();
     if (analysisType == AnalysisType_Transient)
     {
         for (int i = 0; i < numberOfSolution; i++)
@@ -204,9 +304,21 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
 
     // Set up the solver, matrix, and rhs according to the solver selection.
     MatrixSolverType matrix_solver = SOLVER_UMFPACK;
+    // block preconditioned GMRES for the saddle point problem (flow)
+    if (Util::scene()->problemInfo()->matrixCommonSolverType == MatrixCommonSolverType_SaddlePoint)
+        matrix_solver = SOLVER_SADDLE_POINT;
+    // UMFPACK selected explicitly solves the real system (reference of the other solvers)
+    else if (Util::scene()->problemInfo()->matrixCommonSolverType == MatrixCommonSolverType_Umfpack)
+        matrix_solver = SOLVER_UMFPACK;
+    // harmonic problem (real and imaginary part) is solved as a complex system
+    else if ((analysisType == AnalysisType_Harmonic) && (numberOfSolution == 2))
+        matrix_solver = SOLVER_UMFPACK_COMPLEX_BLOCK;
+    // symmetric linear problem is solved by the sparse Cholesky factorization
+    else if ((linearity == Linearity_Linear) && wf.is_sym())
+        matrix_solver = SOLVER_CHOLESKY;
 
     // assemble the stiffness matrix and solve the system
-    double error;
+    double error = isResume ? checkpoint.adaptiveError() : 0.0;
 
     // set actual time
     actualTime = 0;
@@ -217,6 +329,12 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
     // solution
     int maxAdaptivitySteps = (adaptivityType == AdaptivityType_None) ? 1 : adaptivitySteps;
     int actualAdaptivitySteps = -1;
+    // space of the checkpoint is already adapted
+    if (isResume)
+    {
+        maxAdaptivitySteps = 0;
+        actualAdaptivitySteps = checkpoint.adaptiveSteps();
+    }
     for (int i = 0; i<maxAdaptivitySteps; i++)
     {
         // initialize the FE problem
@@ -230,10 +348,13 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
         // assemble stiffness matrix and rhs.
         if (linearity == Linearity_Linear)
         {
-            QTime time;
-            time.start();
+            solverInfo.start("sparsity");
+            fep.create(matrix, rhs);
+            solverInfo.stop();
+
+            solverInfo.start("assembly");
             fep.assemble(matrix, rhs, false);
-            qDebug() << "solveSolutioArray: FeProblem::assemble: " << milisecondsToTime(time.elapsed()).toString("mm:ss.zzz");
+            solverInfo.stop();
 
             if (fep.get_num_dofs() == 0)
             {
@@ -248,8 +369,12 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
             }
 
             // solve the matrix problem.
-            time.start();
-            if (!solver->solve())
+            solverInfo.start("matrix solver");
+            bool isSolved = solver->solve();
+            solverInfoMatrix(solverInfo, matrix, solver);
+            solverInfo.stop();
+
+            if (!isSolved)
             {
                 progressItemSolve->emitMessage(QObject::tr("Matrix solver failed."), true);
                 isError = true;
@@ -260,7 +385,6 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
 
                 break;
             }
-            qDebug() << "solveSolutioArray: CommonSolver::solve: " << milisecondsToTime(time.elapsed()).toString("mm:ss.zzz");
         }
         else
         {
@@ -333,18 +457,34 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
         // calculate errors and adapt the solution
         if (adaptivityType != AdaptivityType_None)
         {
+            solverInfo.start("adaptivity");
+
             // Construct globally refined reference mesh and setup reference space.
+            solverInfo.start("reference space");
             Tuple<Space *> *spaceRef = construct_refined_spaces(space);
+            solverInfo.stop();
 
             // initialize the FE problem
             FeProblem fepRef(&wf, *spaceRef, (linearity == Linearity_Linear));
 
             // assemble ref stiffness matrix and rhs.
+            solverInfo.start("sparsity");
+            fepRef.create(matrix, rhs);
+            solverInfo.stop();
+
+            solverInfo.start("assembly");
             fepRef.assemble(matrix, rhs, false);
+            solverInfo.stop();
 
             // solve the matrix problem.
-            if (!solver->solve())
+            solverInfo.start("matrix solver");
+            bool isSolved = solver->solve();
+            solverInfoMatrix(solverInfo, matrix, solver);
+            solverInfo.stop();
+
+            if (!isSolved)
             {
+                solverInfo.stop();
                 progressItemSolve->emitMessage(QObject::tr("Matrix solver for reference solution failed."), true);
                 isError = true;
                 delete spaceRef;
@@ -355,12 +495,16 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
             vector_to_solutions(solver->get_solution(), *spaceRef, solutionReference);
 
             // project the reference solution on the coarse mesh.
+            solverInfo.start("projection");
             project_global(space, H2D_H1_NORM, solutionReference, solution);
+            solverInfo.stop();
 
             // adaptivity
+            solverInfo.start("error calculation");
             Adapt hp(space, H2D_H1_NORM);
             hp.set_solutions(solution, solutionReference);
             error = hp.calc_elem_errors(H2D_TOTAL_ERROR_REL | H2D_ELEMENT_ERROR_REL) * 100;
+            solverInfo.stop();
 
             // emit signal
             progressItemSolve->emitMessage(QObject::tr("Relative error: %1 %").
@@ -373,18 +517,29 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
 
             if (progressItemSolve->isCanceled())
             {
+                solverInfo.stop();
                 isError = true;
                 break;
             }
 
             if (error < adaptivityTolerance || get_num_dofs(space) >= NDOF_STOP)
+            {
+                solverInfo.stop();
                 break;
+            }
 
-            if (i != maxAdaptivitySteps-1) hp.adapt(selector,
-                                                    Util::config()->threshold,
-                                                    Util::config()->strategy,
-                                                    Util::config()->meshRegularity);
+            if (i != maxAdaptivitySteps-1)
+            {
+                solverInfo.start("selector");
+                hp.adapt(selector,
+                         Util::config()->threshold,
+                         Util::config()->strategy,
+                         Util::config()->meshRegularity);
+                solverInfo.stop();
+            }
             actualAdaptivitySteps = i+1;
+
+            solverInfo.stop();
         }
 
         delete rhs;
@@ -398,72 +553,211 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
     // timesteps
     if (!isError)
     {
-        int timesteps = (analysisType == AnalysisType_Transient) ? floor(timeTotal/timeStep) : 1;
-        for (int n = 0; n < timesteps; n++)
+        // initialize matrix, vector and solver
+        // space does not change during the time steps, the solver keeps its state (factorization)
+        SparseMatrix *matrix = create_matrix(matrix_solver);
+        Vector *rhs = create_vector(matrix_solver);
+        Solver *solver = create_solver(matrix_solver, matrix, rhs);
+
+        if (analysisType == AnalysisType_Transient)
         {
-            // set actual time
-            actualTime = (n+1)*timeStep;
+            TimeStepMethod timeStepMethod = Util::scene()->problemInfo()->timeStepMethod;
+            int timeStepsEstimate = floor(timeTotal/Util::scene()->problemInfo()->timeStep.number);
+
+            // the adaptivity solves with the initial condition, the time steps start from it again
+            for (int i = 0; i < numberOfSolution; i++)
+                solution.at(i)->set_const(mesh, initialCondition);
+
+            ndof = get_num_dofs(space);
+            TimeStepping timeStepping(timeStepMethod,
+                                      Util::scene()->problemInfo()->timeStep.number,
+                                      timeTotal,
+                                      Util::scene()->problemInfo()->timeStepTolerance,
+                                      ndof);
+            scalar *history = new scalar[ndof];
+
+            // BDF2 needs the coefficients of the initial condition
+            if (timeStepMethod != TimeStepMethod_Fixed)
+            {
+                Tuple<MeshFunction *> initial;
+                for (int i = 0; i < numberOfSolution; i++)
+                    initial.push_back(solution.at(i));
+
+                project_global(space, Tuple<int>(), initial, history);
+                timeStepping.setInitialCondition(history);
+            }
+
+            // checkpoint (steps are written in the background)
+            int checkpointInterval = Util::config()->checkpointInterval;
+            if (isResume)
+            {
+                if (checkpoint.ndof() == ndof)
+                {
+                    // accepted steps of the checkpoint
+                    foreach (CheckpointStep step, checkpoint.steps())
+                    {
+                        scalar *coeffs = (scalar *) step.coeffs.constData();
+
+                        timeStepping.restore(coeffs, step.time, step.timeStepNext, step.rejected);
+                        vector_to_solutions(coeffs, space, solution);
+
+                        for (int i = 0; i < numberOfSolution; i++)
+                        {
+                            SolutionArray *previous = (timeStepping.steps() > 1) ? solutionArrayList->at(solutionArrayList->count() - numberOfSolution) : NULL;
+                            solutionArrayList->append(solutionArray(solution.at(i), space.at(i), error, actualAdaptivitySteps, step.time, previous,
+                                                                    timeStepping.derivative()));
+                        }
+                    }
+
+                    progressItemSolve->emitMessage(QObject::tr("Solve resumed from the checkpoint: %1 time steps (%2 s)").
+                                                   arg(timeStepping.steps()).
+                                                   arg(timeStepping.steps() > 0 ? checkpoint.steps().last().time : 0.0, 0, 'e', 3), false);
+                }
+                else
+                {
+                    progressItemSolve->emitMessage(QObject::tr("Checkpoint does not correspond to the space (DOFs: %1, %2).").
+                                                   arg(checkpoint.ndof()).
+                                                   arg(ndof), true);
+                    isError = true;
+                }
+            }
+            else if (checkpointInterval > 0)
+            {
+                if (!checkpoint.create(mesh, space, error, actualAdaptivitySteps))
+                {
+                    progressItemSolve->emitMessage(checkpoint.error(), false);
+                    checkpointInterval = 0;
+                }
+            }
 
             // initialize the FE problem
             FeProblem fep(&wf, space, (linearity == Linearity_Linear));
 
-            // initialize matrix, vector and solver
-            SparseMatrix *matrix = create_matrix(matrix_solver);
-            Vector *rhs = create_vector(matrix_solver);
-            Solver *solver = create_solver(matrix_solver, matrix, rhs);
+            // the matrix depends on the effective time step only (except matrix forms with the external functions - flow)
+            double assembledTimeStep = 0.0;
+            bool isMatrixExt = wf.has_matrix_ext();
 
-            if (timesteps > 1)
+            while (!isError && !timeStepping.isFinished())
             {
-                // transient - assemble stiffness matrix and rhs.
-                QTime time;
-                time.start();
-                fep.assemble(matrix, rhs, false);
-                qDebug() << "solveSolutioArray: FeProblem::assemble"; time.elapsed();
+                // set actual time and the effective time step of the weak forms
+                timeStep = timeStepping.effectiveStep();
+                actualTime = timeStepping.time();
+
+                solverInfo.start("time step");
+
+                // history of the time step
+                if (timeStepping.history(history))
+                    vector_to_solutions(history, space, solution);
+
+                // the unchanged matrix keeps its factorization
+                bool isRhsOnly = (!isMatrixExt && timeStep == assembledTimeStep);
+                solver->set_factorization_scheme(isRhsOnly ? H2D_REUSE_FACTORIZATION_COMPLETELY : H2D_FACTORIZE_FROM_SCRATCH);
+
+                solverInfo.start("sparsity");
+                fep.create(matrix, rhs, isRhsOnly);
+                solverInfo.stop();
+
+                solverInfo.start("assembly");
+                fep.assemble(matrix, rhs, isRhsOnly);
+                solverInfo.stop();
+
+                assembledTimeStep = timeStep;
 
                 if (fep.get_num_dofs() == 0)
                 {
+                    solverInfo.stop();
                     progressItemSolve->emitMessage(QObject::tr("Number of DOFs is zero"), true);
                     isError = true;
                     break;
                 }
 
                 // solve the matrix problem.
-                if (!solver->solve())
+                solverInfo.start("matrix solver");
+                bool isSolved = solver->solve();
+                solverInfoMatrix(solverInfo, matrix, solver);
+                solverInfo.stop();
+
+                solverInfo.stop();
+
+                if (!isSolved)
                 {
                     progressItemSolve->emitMessage(QObject::tr("Matrix solver failed."), true);
                     isError = true;
                     break;
                 }
 
+                // adaptive time step - the rejected step is repeated with the shorter step
+                double timeStepLength = timeStepping.step();
+                if (!timeStepping.accept(solver->get_solution()))
+                {
+                    progressItemSolve->emitMessage(QObject::tr("Time step rejected: %1 s (error: %2 %)").
+                                                   arg(timeStepLength, 0, 'e', 3).
+                                                   arg(timeStepping.error(), 0, 'f', 5), false);
+
+                    if (progressItemSolve->isCanceled())
+                    {
+                        isError = true;
+                        break;
+                    }
+                    continue;
+                }
+
                 // convert coefficient vector into a Solution.
                 vector_to_solutions(solver->get_solution(), space, solution);
-            }
-            else if (n > 0)
-            {
-                fep.assemble(matrix, rhs, true);
-            }
 
-            // output
-            for (int i = 0; i < numberOfSolution; i++)
-            {
-                solutionArrayList->append(solutionArray(solution.at(i), space.at(i), error, actualAdaptivitySteps, (n+1)*timeStep));
-            }
+                // output
+                for (int i = 0; i < numberOfSolution; i++)
+                {
+                    // space does not change during the time steps
+                    SolutionArray *previous = (timeStepping.steps() > 1) ? solutionArrayList->at(solutionArrayList->count() - numberOfSolution) : NULL;
+                    solutionArrayList->append(solutionArray(solution.at(i), space.at(i), error, actualAdaptivitySteps, actualTime, previous,
+                                                            timeStepping.derivative()));
+                }
 
-            if (analysisType == AnalysisType_Transient)
-                progressItemSolve->emitMessage(QObject::tr("Time step: %1/%2").
-                                               arg(n+1).
-                                               arg(timesteps), false, n+2);
+                // checkpoint
+                if (checkpointInterval > 0)
+                {
+                    checkpoint.append(actualTime, timeStepping.step(), timeStepping.rejected(), solver->get_solution(), ndof);
+                    if (timeStepping.steps() % checkpointInterval == 0)
+                        checkpoint.flush();
+                }
 
-            delete rhs;
-            delete matrix;
-            delete solver;
+                progressItemSolve->emitMessage(QObject::tr("Time step: %1 (%2 s, step %3 s)").
+                                               arg(timeStepping.steps()).
+                                               arg(actualTime, 0, 'e', 3).
+                                               arg(timeStepLength, 0, 'e', 3), false,
+                                               1 + qMin(timeStepsEstimate, (int) ceil(timeStepsEstimate * actualTime / timeTotal)));
 
-            if (progressItemSolve->isCanceled())
+                if (progressItemSolve->isCanceled())
+                {
+                    isError = true;
+                    break;
+                }
+            }
+
+            // the rest of the steps (canceled solve can be resumed)
+            if (checkpointInterval > 0)
             {
-                isError = true;
-                break;
+                checkpoint.flush();
+                if (!checkpoint.wait())
+                    progressItemSolve->emitMessage(checkpoint.error(), false);
             }
+
+            solverInfo.setCounter("time steps", timeStepping.steps());
+            solverInfo.setCounter("rejected time steps", timeStepping.rejected());
+
+            delete [] history;
+        }
+        else
+        {
+            // output
+            for (int i = 0; i < numberOfSolution; i++)
+                solutionArrayList->append(solutionArray(solution.at(i), space.at(i), error, actualAdaptivitySteps, 0.0));
         }
+
+        delete rhs;
+        delete matrix;
+        delete solver;
     }
 
     // delete mesh
@@ -491,6 +785,10 @@ SolutionArray *solutionArray(Solution *sln, Space *space = NULL, double adaptive
         solutionArrayList->clear();
     }
 
+    // flat profile of the solver (hermes2d with H2D_PROFILE)
+    profile_dump();
+    profile_reset();
+
     return solutionArrayList;
 }
 
@@ -508,6 +806,17 @@ double ViewScalarFilter::get_pt_value(double x, double y, int item)
     error("Not implemented");
 }
 
+MeshFunction *ViewScalarFilter::clone()
+{
+    Tuple<MeshFunction *> slns;
+    if (!clone_sln(slns))
+        return NULL;
+
+    ViewScalarFilter *filter = newFilter(slns);
+    filter->set_own_sln(true);
+    return filter;
+}
+
 void ViewScalarFilter::precalculate(int order, int mask)
 {
     Quad2D* quad = quads[cur_quad];
@@ -37,7 +37,7 @@ extern bool isPlanar;
 extern AnalysisType analysisType;
 extern double frequency;
 extern double actualTime;
-extern double timeStep;
+extern double timeStep; // effective time step of the weak forms (time step / alpha0 of BDF2)
 
 class LocalPointValue;
 class VolumeIntegralValue;
@@ -110,6 +110,9 @@ public:
 
     double get_pt_value(double x, double y, int item = H2D_FN_VAL);
 
+    // copy with cloned solutions (parallel linearizer)
+    MeshFunction *clone();
+
 protected:
     PhysicFieldVariable m_physicFieldVariable;
     PhysicFieldVariableComp m_physicFieldVariableComp;
@@ -124,10 +127,12 @@ protected:
 
     void precalculate(int order, int mask);
     virtual void calculateVariable(int i) = 0;
+    virtual ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) = 0;
 };
 
 // read mesh
 Mesh *readMeshFromFile(const QString &fileName);
+Mesh *readMeshFromString(const QByteArray &content);
 void writeMeshFromFile(const QString &fileName, Mesh *mesh);
 
 // solve
@@ -210,4 +215,45 @@ Scalar int_magnet(int n, double *wt, Func<Real> *v, double angle)
     return result;
 }
 
+// batched forms (coefficients in the integration points, see WeakForm::add_matrix_form_coef) ***************************************
+
+inline void coef_grad_u_grad_v(int n, MatrixFormCoef *coef, double c)
+{
+    for (int i = 0; i < n; i++)
+        coef->gg[i] += c;
+}
+
+inline void coef_x_grad_u_grad_v(int n, MatrixFormCoef *coef, double c, Geom<double> *e)
+{
+    for (int i = 0; i < n; i++)
+        coef->gg[i] += c * e->x[i];
+}
+
+inline void coef_u_v(int n, MatrixFormCoef *coef, double c)
+{
+    for (int i = 0; i < n; i++)
+        coef->uv[i] += c;
+}
+
+inline void coef_x_u_v(int n, MatrixFormCoef *coef, double c, Geom<double> *e)
+{
+    for (int i = 0; i < n; i++)
+        coef->uv[i] += c * e->x[i];
+}
+
+inline void coef_u_dvdx_over_x(int n, MatrixFormCoef *coef, double c, Geom<double> *e)
+{
+    for (int i = 0; i < n; i++)
+        coef->udvdx[i] += c / e->x[i];
+}
+
+inline void coef_velocity(int n, MatrixFormCoef *coef, double c, Geom<double> *e, double vx, double vy, double omega)
+{
+    for (int i = 0; i < n; i++)
+    {
+        coef->udvdx[i] += c * (vx - e->y[i] * omega);
+        coef->udvdy[i] += c * (vy + e->x[i] * omega);
+    }
+}
+
 #endif // HERMES_FIELD_H
@@ -92,8 +92,9 @@ scalar flow_bc_values_pressure(int marker, double x, double y)
 template<typename Real, typename Scalar>
 Scalar matrix_form_linear_sym_0_0_1_1(int n, double *wt, Func<Real> *u_ext[], Func<Real> *u, Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
-    return flowLabel[e->marker].dynamic_viscosity / flowLabel[e->marker].density * (int_grad_u_grad_v<Real, Scalar>(n, wt, u, v) +
-            ((analysisType == AnalysisType_Transient) ? int_u_v<Real, Scalar>(n, wt, u, v) / timeStep : 0.0));
+    // kinematic viscosity, the mass term is not scaled (the same as the right hand side)
+    return flowLabel[e->marker].dynamic_viscosity / flowLabel[e->marker].density * int_grad_u_grad_v<Real, Scalar>(n, wt, u, v) +
+            ((analysisType == AnalysisType_Transient) ? int_u_v<Real, Scalar>(n, wt, u, v) / timeStep : 0.0);
 }
 
 template<typename Real, typename Scalar>
@@ -115,13 +116,14 @@ Scalar vector_form(int n, double *wt, Func<Real> *u_ext[], Func<Real> *v, Geom<R
 template<typename Real, typename Scalar>
 Scalar matrix_form_linear_unsym_0_2(int n, double *wt, Func<Real> *u_ext[], Func<Real> *p, Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
-    return - int_u_dvdx<Real, Scalar>(n, wt, p, v);
+    // pressure gradient divided by the density
+    return - int_u_dvdx<Real, Scalar>(n, wt, p, v) / flowLabel[e->marker].density;
 }
 
 template<typename Real, typename Scalar>
 Scalar matrix_form_linear_unsym_1_2(int n, double *wt, Func<Real> *u_ext[], Func<Real> *p, Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
-    return - int_u_dvdy<Real, Scalar>(n, wt, p, v);
+    return - int_u_dvdy<Real, Scalar>(n, wt, p, v) / flowLabel[e->marker].density;
 }
 
 void callbackFlowSpace(Tuple<Space *> space)
@@ -138,31 +140,19 @@ void callbackFlowSpace(Tuple<Space *> space)
 
 void callbackFlowWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
 {
-    // FIX
-    /*
-    wf->add_matrix_form(0, 0, callback(matrix_form_linear_sym_0_0_1_1), H2D_SYM, H2D_ANY);
-    if (analysisType == AnalysisType_Transient)
-        wf->add_matrix_form(0, 0, callback(matrix_form_linear_unsym_0_0_1_1), H2D_UNSYM, H2D_ANY, slnArray);
-    else
-        wf->add_matrix_form(0, 0, callback(matrix_form_linear_unsym_0_0_1_1), H2D_UNSYM);
+    // velocity (0, 1) and pressure (2), the pressure block is zero (saddle point problem)
+    wf->add_matrix_form(0, 0, callback(matrix_form_linear_sym_0_0_1_1), H2D_SYM);
     wf->add_matrix_form(1, 1, callback(matrix_form_linear_sym_0_0_1_1), H2D_SYM);
-    if (analysisType == AnalysisType_Transient)
-        wf->add_matrix_form(1, 1, callback(matrix_form_linear_unsym_0_0_1_1), H2D_UNSYM, H2D_ANY, slnArray);
-    else
-        wf->add_matrix_form(1, 1, callback(matrix_form_linear_unsym_0_0_1_1), H2D_UNSYM);
     wf->add_matrix_form(0, 2, callback(matrix_form_linear_unsym_0_2), H2D_ANTISYM);
     wf->add_matrix_form(1, 2, callback(matrix_form_linear_unsym_1_2), H2D_ANTISYM);
     if (analysisType == AnalysisType_Transient)
     {
-        wf->add_vector_form(0, callback(vector_form), H2D_ANY, slnArray);
-        wf->add_vector_form(1, callback(vector_form), H2D_ANY, slnArray);
-    }
-    else
-    {
-        wf->add_vector_form(0, callback(vector_form));
-        wf->add_vector_form(1, callback(vector_form));
+        // convection by the velocity of the previous time step
+        wf->add_matrix_form(0, 0, callback(matrix_form_linear_unsym_0_0_1_1), H2D_UNSYM, HERMES_ANY, Tuple<MeshFunction *>(slnArray.at(0), slnArray.at(1)));
+        wf->add_matrix_form(1, 1, callback(matrix_form_linear_unsym_0_0_1_1), H2D_UNSYM, HERMES_ANY, Tuple<MeshFunction *>(slnArray.at(0), slnArray.at(1)));
+        wf->add_vector_form(0, callback(vector_form), HERMES_ANY, slnArray.at(0));
+        wf->add_vector_form(1, callback(vector_form), HERMES_ANY, slnArray.at(1));
     }
-    */
 }
 
 // *******************************************************************************************************
@@ -222,7 +212,7 @@ LocalPointValue *HermesFlow::localPointValue(Point point)
 QStringList HermesFlow::localPointValueHeader()
 {
     QStringList headers;
-    headers << "X" << "Y" << "t" << "vx" << "vy" << "v" << "p";
+    headers << "X" << "Y" << "t" << "v" << "vx" << "vy" << "p";
     return QStringList(headers);
 }
 
@@ -264,7 +254,7 @@ SceneEdgeMarker *HermesFlow::newEdgeMarker(PyObject *self, PyObject *args)
 
     double valuex, valuey, press;
     char *name, *type;
-    if (PyArg_ParseTuple(args, "sssdd", &name, &type, &valuex, &valuey, &press))
+    if (PyArg_ParseTuple(args, "ssddd", &name, &type, &valuex, &valuey, &press))
     {
         // check name
         if (Util::scene()->getEdgeMarker(name)) return NULL;
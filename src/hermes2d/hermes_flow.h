@@ -135,6 +135,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterFlow(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeFlowMarker : public SceneEdgeMarker
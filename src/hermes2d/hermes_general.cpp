@@ -79,6 +79,16 @@ Scalar general_matrix_form_linear(int n, double *wt, Func<Real> *u_ext[], Func<R
         return generalLabel[marker].constant * 2 * M_PI * int_x_grad_u_grad_v<Real, Scalar>(n, wt, u, v, e);
 }
 
+void general_matrix_form_linear_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    int marker = e->marker;
+
+    if (isPlanar)
+        coef_grad_u_grad_v(n, coef, generalLabel[marker].constant);
+    else
+        coef_x_grad_u_grad_v(n, coef, generalLabel[marker].constant * 2 * M_PI, e);
+}
+
 template<typename Real, typename Scalar>
 Scalar general_vector_form_linear(int n, double *wt, Func<Real> *u_ext[], Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
@@ -98,7 +108,7 @@ void callbackGeneralSpace(Tuple<Space *> space)
 
 void callbackGeneralWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
 {
-    wf->add_matrix_form(0, 0, callback(general_matrix_form_linear));
+    wf->add_matrix_form_coef(0, 0, general_matrix_form_linear_coef, general_matrix_form_linear<Ord, Ord>, H2D_SYM);
     wf->add_vector_form(0, callback(general_vector_form_linear));
     wf->add_vector_form_surf(0, callback(general_vector_form_linear_surf));
 }
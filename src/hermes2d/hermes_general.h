@@ -130,6 +130,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterGeneral(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeGeneralMarker : public SceneEdgeMarker
@@ -114,6 +114,22 @@ Scalar heat_matrix_form_linear(int n, double *wt, Func<Real> *u_ext[], Func<Real
                 + ((analysisType == AnalysisType_Transient) ? heatLabel[e->marker].density * heatLabel[e->marker].specific_heat * 2 * M_PI * int_x_u_v<Real, Scalar>(n, wt, u, v, e) / timeStep : 0.0);
 }
 
+void heat_matrix_form_linear_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    if (isPlanar)
+    {
+        coef_grad_u_grad_v(n, coef, heatLabel[e->marker].thermal_conductivity);
+        if (analysisType == AnalysisType_Transient)
+            coef_u_v(n, coef, heatLabel[e->marker].density * heatLabel[e->marker].specific_heat / timeStep);
+    }
+    else
+    {
+        coef_x_grad_u_grad_v(n, coef, heatLabel[e->marker].thermal_conductivity * 2 * M_PI, e);
+        if (analysisType == AnalysisType_Transient)
+            coef_x_u_v(n, coef, heatLabel[e->marker].density * heatLabel[e->marker].specific_heat * 2 * M_PI / timeStep, e);
+    }
+}
+
 template<typename Real, typename Scalar>
 Scalar heat_vector_form_linear(int n, double *wt, Func<Real> *u_ext[], Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
@@ -171,7 +187,7 @@ void callbackHeatWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
 {
     if (Util::scene()->problemInfo()->linearity == Linearity_Linear)
     {
-        wf->add_matrix_form(0, 0, callback(heat_matrix_form_linear));
+        wf->add_matrix_form_coef(0, 0, heat_matrix_form_linear_coef, heat_matrix_form_linear<Ord, Ord>, H2D_SYM);
         if (analysisType == AnalysisType_Transient)
             wf->add_vector_form(0, callback(heat_vector_form_linear), HERMES_ANY, slnArray.at(0));
         else
@@ -143,6 +143,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterHeat(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeHeatMarker : public SceneEdgeMarker
@@ -19,6 +19,7 @@
 
 #include "hermes_magnetic.h"
 #include "scene.h"
+#include "movingband.h"
 
 struct MagneticEdge
 {
@@ -43,6 +44,16 @@ struct MagneticLabel
 MagneticEdge *magneticEdge;
 MagneticLabel *magneticLabel;
 
+// direction of the remanence (deg), the magnets of the rotor turn with the moving band
+static double remanenceAngle(double angle, const Point &point)
+{
+    MovingBand *movingBand = Util::scene()->sceneSolution()->movingBand();
+    if (movingBand)
+        angle += movingBand->rotation(point);
+
+    return angle;
+}
+
 BCType magnetic_bc_types(int marker)
 {
     switch (magneticEdge[marker].type)
@@ -137,6 +148,38 @@ Scalar magnetic_matrix_form_linear_imag_imag(int n, double *wt, Func<Real> *u_ex
                magneticLabel[e->marker].conductivity * int_velocity<Real, Scalar>(n, wt, u, v, e, magneticLabel[e->marker].velocity_x, magneticLabel[e->marker].velocity_y, magneticLabel[e->marker].velocity_angular);
 }
 
+void magnetic_matrix_form_linear_coef(int n, Geom<double> *e, MatrixFormCoef *coef, bool isTransient)
+{
+    double reluctivity = 1.0 / (magneticLabel[e->marker].permeability * MU0);
+
+    coef_grad_u_grad_v(n, coef, reluctivity);
+    if (!isPlanar)
+        coef_u_dvdx_over_x(n, coef, reluctivity, e);
+    coef_velocity(n, coef, - magneticLabel[e->marker].conductivity, e, magneticLabel[e->marker].velocity_x, magneticLabel[e->marker].velocity_y, magneticLabel[e->marker].velocity_angular);
+    if (isTransient)
+        coef_u_v(n, coef, magneticLabel[e->marker].conductivity / timeStep);
+}
+
+void magnetic_matrix_form_linear_real_real_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    magnetic_matrix_form_linear_coef(n, e, coef, analysisType == AnalysisType_Transient);
+}
+
+void magnetic_matrix_form_linear_real_imag_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    coef_u_v(n, coef, - 2 * M_PI * frequency * magneticLabel[e->marker].conductivity);
+}
+
+void magnetic_matrix_form_linear_imag_real_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    coef_u_v(n, coef, + 2 * M_PI * frequency * magneticLabel[e->marker].conductivity);
+}
+
+void magnetic_matrix_form_linear_imag_imag_coef(int n, Func<scalar> *u_ext[], Geom<double> *e, ExtData<scalar> *ext, MatrixFormCoef *coef)
+{
+    magnetic_matrix_form_linear_coef(n, e, coef, false);
+}
+
 template<typename Real, typename Scalar>
 Scalar magnetic_vector_form_linear_real(int n, double *wt, Func<Real> *u_ext[], Func<Real> *v, Geom<Real> *e, ExtData<Scalar> *ext)
 {
@@ -176,11 +219,31 @@ void callbackMagneticSpace(Tuple<Space *> space)
     }
 }
 
+// planar problem without moving parts (axisymmetric and velocity terms are unsymmetric)
+bool magneticIsSymmetric()
+{
+    if (!isPlanar)
+        return false;
+
+    for (int i = 0; i < Util::scene()->labels.count(); i++)
+    {
+        SceneLabelMagneticMarker *labelMagneticMarker = dynamic_cast<SceneLabelMagneticMarker *>(Util::scene()->labels[i]->marker);
+        if (labelMagneticMarker &&
+                (labelMagneticMarker->velocity_x.number != 0.0 ||
+                 labelMagneticMarker->velocity_y.number != 0.0 ||
+                 labelMagneticMarker->velocity_angular.number != 0.0))
+            return false;
+    }
+
+    return true;
+}
+
 void callbackMagneticWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
 {
     if (slnArray.size() == 1)
     {
-        wf->add_matrix_form(0, 0, callback(magnetic_matrix_form_linear_real_real));
+        wf->add_matrix_form_coef(0, 0, magnetic_matrix_form_linear_real_real_coef, magnetic_matrix_form_linear_real_real<Ord, Ord>,
+                                 magneticIsSymmetric() ? H2D_SYM : H2D_UNSYM);
         if (analysisType == AnalysisType_Transient)
             wf->add_vector_form(0, callback(magnetic_vector_form_linear_real), HERMES_ANY, slnArray.at(0));
         else
@@ -189,10 +252,10 @@ void callbackMagneticWeakForm(WeakForm *wf, Tuple<Solution *> slnArray)
     }
     else
     {
-        wf->add_matrix_form(0, 0, callback(magnetic_matrix_form_linear_real_real));
-        wf->add_matrix_form(0, 1, callback(magnetic_matrix_form_linear_real_imag));
-        wf->add_matrix_form(1, 0, callback(magnetic_matrix_form_linear_imag_real));
-        wf->add_matrix_form(1, 1, callback(magnetic_matrix_form_linear_imag_imag));
+        wf->add_matrix_form_coef(0, 0, magnetic_matrix_form_linear_real_real_coef, magnetic_matrix_form_linear_real_real<Ord, Ord>);
+        wf->add_matrix_form_coef(0, 1, magnetic_matrix_form_linear_real_imag_coef, magnetic_matrix_form_linear_real_imag<Ord, Ord>);
+        wf->add_matrix_form_coef(1, 0, magnetic_matrix_form_linear_imag_real_coef, magnetic_matrix_form_linear_imag_real<Ord, Ord>);
+        wf->add_matrix_form_coef(1, 1, magnetic_matrix_form_linear_imag_imag_coef, magnetic_matrix_form_linear_imag_imag<Ord, Ord>);
         wf->add_vector_form(0, callback(magnetic_vector_form_linear_real));
         wf->add_vector_form(1, callback(magnetic_vector_form_linear_imag));
         wf->add_vector_form_surf(0, callback(magnetic_vector_form_linear_surf_real));
@@ -329,7 +392,7 @@ QStringList HermesMagnetic::volumeIntegralValueHeader()
 {
     QStringList headers;
     headers << "V" << "S" << "Ie_real" << "Ie_imag" << "Iit_real" << "Iit_imag" << "Iiv_real" << "Iiv_imag" << "I_real" << "I_imag"
-            << "Fx" << "Fy" << "T" << "Pj" << "Wm";
+            << "Fx" << "Fy" << "T" << "Pj" << "Wm" << "Fx_w" << "Fy_w" << "T_w";
     return QStringList(headers);
 }
 
@@ -741,6 +804,16 @@ void HermesMagnetic::showVolumeIntegralValue(QTreeWidget *trvWidget, VolumeInteg
         addTreeWidgetItemValue(itemForce, Util::scene()->problemInfo()->labelY(), QString("%1").arg(volumeIntegralValueMagnetic->forceLorentzY, 0, 'e', 3), "N");
 
         addTreeWidgetItemValue(magneticNode, tr("Torque:"), QString("%1").arg(volumeIntegralValueMagnetic->torque, 0, 'e', 3), tr("Nm"));
+
+        // virtual work (air gap)
+        QTreeWidgetItem *itemForceWeighted = new QTreeWidgetItem(magneticNode);
+        itemForceWeighted->setText(0, tr("Force avg. (virtual work)"));
+        itemForceWeighted->setExpanded(true);
+
+        addTreeWidgetItemValue(itemForceWeighted, Util::scene()->problemInfo()->labelX(), QString("%1").arg(volumeIntegralValueMagnetic->forceWeightedX, 0, 'e', 3), tr("N"));
+        addTreeWidgetItemValue(itemForceWeighted, Util::scene()->problemInfo()->labelY(), QString("%1").arg(volumeIntegralValueMagnetic->forceWeightedY, 0, 'e', 3), tr("N"));
+
+        addTreeWidgetItemValue(magneticNode, tr("Torque avg. (virtual work):"), QString("%1").arg(volumeIntegralValueMagnetic->torqueWeighted, 0, 'e', 3), tr("Nm"));
     }
     else
     {
@@ -759,6 +832,16 @@ void HermesMagnetic::showVolumeIntegralValue(QTreeWidget *trvWidget, VolumeInteg
         addTreeWidgetItemValue(itemForce, Util::scene()->problemInfo()->labelY(), QString("%1").arg(volumeIntegralValueMagnetic->forceLorentzY, 0, 'e', 3), tr("N"));
 
         addTreeWidgetItemValue(magneticNode, tr("Torque:"), QString("%1").arg(volumeIntegralValueMagnetic->torque, 0, 'e', 3), tr("Nm"));
+
+        // virtual work (air gap)
+        QTreeWidgetItem *itemForceWeighted = new QTreeWidgetItem(magneticNode);
+        itemForceWeighted->setText(0, tr("Force (virtual work)"));
+        itemForceWeighted->setExpanded(true);
+
+        addTreeWidgetItemValue(itemForceWeighted, Util::scene()->problemInfo()->labelX(), QString("%1").arg(volumeIntegralValueMagnetic->forceWeightedX, 0, 'e', 3), tr("N"));
+        addTreeWidgetItemValue(itemForceWeighted, Util::scene()->problemInfo()->labelY(), QString("%1").arg(volumeIntegralValueMagnetic->forceWeightedY, 0, 'e', 3), tr("N"));
+
+        addTreeWidgetItemValue(magneticNode, tr("Torque (virtual work):"), QString("%1").arg(volumeIntegralValueMagnetic->torqueWeighted, 0, 'e', 3), tr("Nm"));
     }
 }
 
@@ -782,13 +865,14 @@ ViewScalarFilter *HermesMagnetic::viewScalarFilter(PhysicFieldVariable physicFie
     }
     if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
     {
-        Solution *sln2;
+        Solution *sln2 = sln1;
+        Solution *sln3 = sln1;
         if (Util::scene()->sceneSolution()->timeStep() > 0)
             sln2 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 1);
-        else
-            sln2 = sln1;
+        if (Util::scene()->sceneSolution()->timeStep() > 1)
+            sln3 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 2);
 
-        return new ViewScalarFilterMagnetic(Tuple<MeshFunction *>(sln1, sln2),
+        return new ViewScalarFilterMagnetic(Tuple<MeshFunction *>(sln1, sln2, sln3),
                                             physicFieldVariable,
                                             physicFieldVariableComp);
     }
@@ -858,7 +942,7 @@ QList<SolutionArray *> *HermesMagnetic::solve(ProgressItemSolve *progressItemSol
             magneticLabel[i].permeability = labelMagneticMarker->permeability.number;
             magneticLabel[i].conductivity = labelMagneticMarker->conductivity.number;
             magneticLabel[i].remanence = labelMagneticMarker->remanence.number;
-            magneticLabel[i].remanence_angle = labelMagneticMarker->remanence_angle.number;
+            magneticLabel[i].remanence_angle = remanenceAngle(labelMagneticMarker->remanence_angle.number, Util::scene()->labels[i]->point);
             magneticLabel[i].velocity_x = labelMagneticMarker->velocity_x.number;
             magneticLabel[i].velocity_y = labelMagneticMarker->velocity_y.number;
             magneticLabel[i].velocity_angular = labelMagneticMarker->velocity_angular.number;        }
@@ -876,6 +960,15 @@ QList<SolutionArray *> *HermesMagnetic::solve(ProgressItemSolve *progressItemSol
 
 // ****************************************************************************************************************
 
+// time derivative of the vector potential of the actual step, u(n), u(n-1), u(n-2)
+static double timeDerivative(double value, double valuePrevious, double valuePrevious2)
+{
+    double coeffs[3];
+    Util::scene()->sceneSolution()->timeDerivative(coeffs);
+
+    return coeffs[0] * value + coeffs[1] * valuePrevious + coeffs[2] * valuePrevious2;
+}
+
 LocalPointValueMagnetic::LocalPointValueMagnetic(Point &point) : LocalPointValue(point)
 {
     permeability = 0;
@@ -942,7 +1035,7 @@ LocalPointValueMagnetic::LocalPointValueMagnetic(Point &point) : LocalPointValue
                 permeability = marker->permeability.number;
                 conductivity = marker->conductivity.number;
                 remanence = marker->remanence.number;
-                remanence_angle = marker->remanence_angle.number;
+                remanence_angle = remanenceAngle(marker->remanence_angle.number, point);
                 velocity = Point(marker->velocity_x.number - marker->velocity_angular.number * point.y,
                                  marker->velocity_y.number + marker->velocity_angular.number * point.x);
 
@@ -952,14 +1045,16 @@ LocalPointValueMagnetic::LocalPointValueMagnetic(Point &point) : LocalPointValue
                 // induced transform current density
                 if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
                 {
-                    Solution *sln2;
+                    Solution *sln2 = Util::scene()->sceneSolution()->sln();
+                    Solution *sln3 = Util::scene()->sceneSolution()->sln();
                     if (Util::scene()->sceneSolution()->timeStep() > 0)
                         sln2 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 1);
-                    else
-                        sln2 = Util::scene()->sceneSolution()->sln();
+                    if (Util::scene()->sceneSolution()->timeStep() > 1)
+                        sln3 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 2);
 
                     PointValue valuePrevious = pointValue(sln2, point);
-                    current_density_induced_transform_real = - marker->conductivity.number * (valueReal.value - valuePrevious.value) / Util::scene()->problemInfo()->timeStep.number;
+                    PointValue valuePrevious2 = pointValue(sln3, point);
+                    current_density_induced_transform_real = - marker->conductivity.number * timeDerivative(valueReal.value, valuePrevious.value, valuePrevious2.value);
                 }
 
                 // induced current density velocity
@@ -1026,7 +1121,7 @@ LocalPointValueMagnetic::LocalPointValueMagnetic(Point &point) : LocalPointValue
                 permeability = marker->permeability.number;
                 conductivity = marker->conductivity.number;
                 remanence = marker->remanence.number;
-                remanence_angle = marker->remanence_angle.number;
+                remanence_angle = remanenceAngle(marker->remanence_angle.number, point);
                 velocity = Point(marker->velocity_x.number - marker->velocity_angular.number * point.y,
                                  marker->velocity_y.number + marker->velocity_angular.number * point.x);
 
@@ -1406,7 +1501,11 @@ VolumeIntegralValueMagnetic::VolumeIntegralValueMagnetic() : VolumeIntegralValue
     forceLorentzX = 0;
     forceLorentzY = 0;
     torque = 0;
+    forceWeightedX = 0;
+    forceWeightedY = 0;
+    torqueWeighted = 0;
 
+    initWeight();
     calculate();
 
     currentTotalReal = currentReal + currentInducedTransformReal + currentInducedVelocityReal;
@@ -1449,11 +1548,11 @@ void VolumeIntegralValueMagnetic::calculateVariables(int i)
         result = 0.0;
         if (Util::scene()->problemInfo()->problemType == ProblemType_Planar)
         {
-            h1_integrate_expression(- marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number);
+            h1_integrate_expression(- marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]));
         }
         else
         {
-            h1_integrate_expression(- marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number);
+            h1_integrate_expression(- marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]));
         }
         currentInducedTransformReal += result;
     }
@@ -1534,7 +1633,7 @@ void VolumeIntegralValueMagnetic::calculateVariables(int i)
             h1_integrate_expression((marker->conductivity.number > 0.0) ?
                                     1.0 / marker->conductivity.number * sqr(
                                             marker->current_density_real.number
-                                            - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                            - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                             - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                              (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i]))
                                     :
@@ -1575,7 +1674,7 @@ void VolumeIntegralValueMagnetic::calculateVariables(int i)
             h1_integrate_expression((marker->conductivity.number > 0.0) ?
                                     2 * M_PI * x[i] * 1.0 / marker->conductivity.number * sqr(
                                             marker->current_density_real.number
-                                            - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                            - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                             - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                              (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i]))
                                     :
@@ -1725,6 +1824,194 @@ void VolumeIntegralValueMagnetic::calculateVariables(int i)
         h1_integrate_expression(0.0);
     }
     torque += result;
+
+    // force and torque - virtual work (the areas should be the air gap around the body)
+    if (!weightInner.isEmpty() && !weightOuter.isEmpty())
+    {
+        // stress in the quadrature points (shared by the force and torque)
+        int np = quad->get_num_points(o);
+        QVector<Point> stress(np);
+        for (int k = 0; k < np; k++)
+            stress[k] = stressWeightGradient(k, marker->permeability.number);
+
+        if (Util::scene()->problemInfo()->problemType == ProblemType_Planar)
+        {
+            result = 0.0;
+            h1_integrate_expression(- stress[i].x);
+            forceWeightedX += result;
+
+            result = 0.0;
+            h1_integrate_expression(- stress[i].y);
+            forceWeightedY += result;
+
+            result = 0.0;
+            h1_integrate_expression(- (x[i] * stress[i].y - y[i] * stress[i].x));
+            torqueWeighted += result;
+        }
+        else
+        {
+            result = 0.0;
+            h1_integrate_expression(- 2 * M_PI * x[i] * stress[i].y);
+            forceWeightedY += result;
+        }
+    }
+}
+
+// union-find of the boundary vertices
+static int weightComponent(QMap<int, int> &parent, int id)
+{
+    while (parent.value(id, id) != id)
+        id = parent.value(id, id);
+    return id;
+}
+
+static bool isWeightElement(Element *element)
+{
+    return ((element->marker < Util::scene()->labels.count()) && Util::scene()->labels[element->marker]->isSelected);
+}
+
+// distance from the nearest segment and its gradient
+static double weightDistance(const QList<Point> &segments, const Point &point, Point &gradient)
+{
+    double distance = CONST_DOUBLE;
+    gradient = Point();
+    for (int i = 0; i < segments.count() / 2; i++)
+    {
+        Point start = segments[2*i];
+        Point direction = segments[2*i + 1] - start;
+
+        double t = qBound(0.0, ((point - start) & direction) / (direction & direction), 1.0);
+        Point difference = point - (start + direction * t);
+        double dist = difference.magnitude();
+        if (dist < distance)
+        {
+            distance = dist;
+            gradient = (dist > EPS_ZERO) ? difference / dist : Point();
+        }
+    }
+
+    return distance;
+}
+
+void VolumeIntegralValueMagnetic::initWeight()
+{
+    // weight is one on the inner boundary of the selected areas (surface of the body)
+    // and zero on the outer boundary, w = d_out / (d_in + d_out)
+    weightInner.clear();
+    weightOuter.clear();
+
+    if (!Util::scene()->sceneSolution()->isSolved() || !Util::scene()->sceneSolution()->meshInitial())
+        return;
+
+    bool isAxisymmetric = (Util::scene()->problemInfo()->problemType == ProblemType_Axisymmetric);
+    Mesh *mesh = Util::scene()->sceneSolution()->meshInitial();
+
+    // boundary of the selected areas (initial mesh is conforming), the area is on the left
+    QList<Point> segments;
+    QList<int> segmentIds;
+    QMap<int, int> parent;
+    Element *element;
+    for_all_active_elements(element, mesh)
+    {
+        if (!isWeightElement(element))
+            continue;
+
+        for (int j = 0; j < element->get_num_surf(); j++)
+        {
+            Element *neighbor = (element->en[j]->elem[0] == element) ? element->en[j]->elem[1] : element->en[j]->elem[0];
+            if (neighbor && isWeightElement(neighbor))
+                continue;
+
+            Node *start = element->vn[j];
+            Node *end = element->vn[element->next_vert(j)];
+            // axisymmetric - axis is not a boundary of the body
+            if (isAxisymmetric && fabs(start->x) < EPS_ZERO && fabs(end->x) < EPS_ZERO)
+                continue;
+
+            segments.append(Point(start->x, start->y));
+            segments.append(Point(end->x, end->y));
+            segmentIds.append(start->id);
+
+            int componentStart = weightComponent(parent, start->id);
+            int componentEnd = weightComponent(parent, end->id);
+            if (componentStart != componentEnd)
+                parent[componentStart] = componentEnd;
+        }
+    }
+
+    if (segments.isEmpty())
+        return;
+
+    // signed area of the boundary loops, the holes (body) are clockwise
+    // (the chains ending on the axis are closed by the axis)
+    QMap<int, double> area;
+    for (int i = 0; i < segmentIds.count(); i++)
+        area[weightComponent(parent, segmentIds[i])] += (segments[2*i] % segments[2*i + 1]) / 2.0;
+
+    for (int i = 0; i < segmentIds.count(); i++)
+    {
+        QList<Point> &weight = (area[weightComponent(parent, segmentIds[i])] < 0.0) ? weightInner : weightOuter;
+        weight.append(segments[2*i]);
+        weight.append(segments[2*i + 1]);
+    }
+
+    // the selected areas do not enclose a body (the weight is not defined)
+    if (weightInner.isEmpty() || weightOuter.isEmpty())
+    {
+        forceWeightedX = qQNaN();
+        forceWeightedY = qQNaN();
+        torqueWeighted = qQNaN();
+    }
+}
+
+Point VolumeIntegralValueMagnetic::stressWeightGradient(int i, double permeability)
+{
+    // Maxwell stress tensor multiplied by the gradient of the weight function
+    Point gradientInner, gradientOuter;
+    double distanceInner = weightDistance(weightInner, Point(x[i], y[i]), gradientInner);
+    double distanceOuter = weightDistance(weightOuter, Point(x[i], y[i]), gradientOuter);
+    double distance = distanceInner + distanceOuter;
+    if (distance < EPS_ZERO)
+        return Point();
+
+    Point gradient = (gradientOuter * distanceInner - gradientInner * distanceOuter) / (distance * distance);
+
+    double Bx[2], By[2];
+    if (Util::scene()->problemInfo()->problemType == ProblemType_Planar)
+    {
+        Bx[0] = dudy1[i];
+        By[0] = - dudx1[i];
+        if (Util::scene()->problemInfo()->analysisType == AnalysisType_Harmonic)
+        {
+            Bx[1] = dudy2[i];
+            By[1] = - dudx2[i];
+        }
+    }
+    else
+    {
+        Bx[0] = - dudy1[i];
+        By[0] = dudx1[i] + ((x[i] > 0) ? value1[i] / x[i] : 0.0);
+        if (Util::scene()->problemInfo()->analysisType == AnalysisType_Harmonic)
+        {
+            Bx[1] = - dudy2[i];
+            By[1] = dudx2[i] + ((x[i] > 0) ? value2[i] / x[i] : 0.0);
+        }
+    }
+
+    // harmonic - time average of the real and imaginary parts
+    int count = (Util::scene()->problemInfo()->analysisType == AnalysisType_Harmonic) ? 2 : 1;
+
+    Point stress;
+    for (int j = 0; j < count; j++)
+    {
+        double Bg = Bx[j] * gradient.x + By[j] * gradient.y;
+        double B2 = sqr(Bx[j]) + sqr(By[j]);
+
+        stress = stress + Point(Bx[j] * Bg - 0.5 * B2 * gradient.x,
+                                By[j] * Bg - 0.5 * B2 * gradient.y) / (count * permeability * MU0);
+    }
+
+    return stress;
 }
 
 void VolumeIntegralValueMagnetic::initSolutions()
@@ -1732,7 +2019,14 @@ void VolumeIntegralValueMagnetic::initSolutions()
     sln1 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution());
     sln2 = NULL;
     if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
-        sln2 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 1);
+    {
+        sln2 = sln1;
+        sln3 = sln1;
+        if (Util::scene()->sceneSolution()->timeStep() > 0)
+            sln2 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 1);
+        if (Util::scene()->sceneSolution()->timeStep() > 1)
+            sln3 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() - 2);
+    }
     if (Util::scene()->problemInfo()->analysisType == AnalysisType_Harmonic)
         sln2 = Util::scene()->sceneSolution()->sln(Util::scene()->sceneSolution()->timeStep() * Util::scene()->problemInfo()->hermes()->numberOfSolution() + 1);
 }
@@ -1754,7 +2048,10 @@ QStringList VolumeIntegralValueMagnetic::variables()
             QString("%1").arg(forceLorentzY, 0, 'e', 5) <<
             QString("%1").arg(torque, 0, 'e', 5) <<
             QString("%1").arg(powerLosses, 0, 'e', 5) <<
-            QString("%1").arg(energy, 0, 'e', 5);
+            QString("%1").arg(energy, 0, 'e', 5) <<
+            QString("%1").arg(forceWeightedX, 0, 'e', 5) <<
+            QString("%1").arg(forceWeightedY, 0, 'e', 5) <<
+            QString("%1").arg(torqueWeighted, 0, 'e', 5);
     return QStringList(row);
 }
 
@@ -2040,7 +2337,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
             }
             if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
             {
-                node->values[0][0][i] = - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number;
+                node->values[0][0][i] = - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]);
             }
         }
         break;
@@ -2089,7 +2386,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                 node->values[0][0][i] += 2 * M_PI * Util::scene()->problemInfo()->frequency * marker->conductivity.number * value2[i];
 
             if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
-                node->values[0][0][i] -= marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number;
+                node->values[0][0][i] -= marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]);
         }
         break;
     case PhysicFieldVariable_Magnetic_CurrentDensityTotalImag:
@@ -2149,7 +2446,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                         marker->current_density_real.number +
                                         - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                          (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                        - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number)
+                                        - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]))
                                         :
                                         0.0;
             }
@@ -2179,7 +2476,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                                                 marker->current_density_real.number +
                                                                 - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                                  (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                                                - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                                                - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                                                 ));
                         }
                     }
@@ -2200,7 +2497,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                                                  marker->current_density_real.number +
                                                                  - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                                   (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                                                 - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                                                 - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                                                  ));
                         }
                     }
@@ -2231,14 +2528,14 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                                         - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                          (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
                                                         + ((Util::scene()->problemInfo()->analysisType == AnalysisType_Transient) ?
-                                                        - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number : 0.0)
+                                                        - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]) : 0.0)
                                                         ))
                                                     + sqr(dudy1[i] * (
                                                         marker->current_density_real.number +
                                                         - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                          (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
                                                         + ((Util::scene()->problemInfo()->analysisType == AnalysisType_Transient) ?
-                                                        - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number : 0.0)
+                                                        - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i]) : 0.0)
                                                         )));
                         }
 
@@ -2266,7 +2563,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                                                 marker->current_density_real.number +
                                                                 - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                                  (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                                                - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                                                - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                                                 ));
                         }
                     }
@@ -2287,7 +2584,7 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                                                  marker->current_density_real.number +
                                                                  - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                                   (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                                                 - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                                                 - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                                                  ));
 
                         }
@@ -2318,13 +2615,13 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
                                                         marker->current_density_real.number +
                                                         - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                          (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                                        - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                                        - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                                         ))
                                                     + sqr(dudy1[i] * (
                                                         marker->current_density_real.number +
                                                         - marker->conductivity.number * ((marker->velocity_x.number - marker->velocity_angular.number * y[i]) * dudx1[i] +
                                                                                          (marker->velocity_y.number + marker->velocity_angular.number * x[i]) * dudy1[i])
-                                                        - marker->conductivity.number * (value1[i] - value2[i]) / Util::scene()->problemInfo()->timeStep.number
+                                                        - marker->conductivity.number * timeDerivative(value1[i], value2[i], value3[i])
                                                         )));
                         }
                     }
@@ -2419,12 +2716,12 @@ void ViewScalarFilterMagnetic::calculateVariable(int i)
             {
             case PhysicFieldVariableComp_X:
                 {
-                    node->values[0][0][i] = marker->remanence.number * cos(marker->remanence_angle.number / 180.0 * M_PI);
+                    node->values[0][0][i] = marker->remanence.number * cos(remanenceAngle(marker->remanence_angle.number, Point(x[i], y[i])) / 180.0 * M_PI);
                 }
                 break;
             case PhysicFieldVariableComp_Y:
                 {
-                    node->values[0][0][i] = marker->remanence.number * sin(marker->remanence_angle.number / 180.0 * M_PI);
+                    node->values[0][0][i] = marker->remanence.number * sin(remanenceAngle(marker->remanence_angle.number, Point(x[i], y[i])) / 180.0 * M_PI);
                 }
                 break;
             case PhysicFieldVariableComp_Magnitude:
@@ -151,6 +151,14 @@ protected:
     void calculateVariables(int i);
     void initSolutions();
 
+    // weight function of the virtual work (eggshell) method,
+    // segments of the inner (body) and outer boundary of the selected areas
+    QList<Point> weightInner;
+    QList<Point> weightOuter;
+
+    void initWeight();
+    Point stressWeightGradient(int i, double permeability);
+
 public:
     double currentReal;
     double currentImag;
@@ -165,6 +173,9 @@ public:
     double powerLosses;
     double energy;
     double torque;
+    double forceWeightedX;
+    double forceWeightedY;
+    double torqueWeighted;
 
     VolumeIntegralValueMagnetic();
     QStringList variables();
@@ -178,6 +189,7 @@ public:
 
 protected:
     void calculateVariable(int i);
+    ViewScalarFilter *newFilter(Tuple<MeshFunction *> sln) { return new ViewScalarFilterMagnetic(sln, m_physicFieldVariable, m_physicFieldVariableComp); }
 };
 
 class SceneEdgeMagneticMarker : public SceneEdgeMarker
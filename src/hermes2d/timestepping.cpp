@@ -0,0 +1,270 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "timestepping.h"
+
+TimeStepping::TimeStepping(TimeStepMethod method, double timeStep, double timeTotal, double tolerance, int ndof)
+{
+    m_method = method;
+    m_timeTotal = timeTotal;
+    m_tolerance = tolerance;
+    m_stepsTotal = floor(timeTotal/timeStep);
+
+    m_time = 0.0;
+    m_tau = timeStep;
+    m_steps = 0;
+    m_rejected = 0;
+    m_error = -1.0;
+
+    // the first step (implicit Euler from the initial condition) has no error estimate,
+    // the adaptive step starts short (local error of the implicit Euler ~ tau^2) and grows
+    // with the estimate of the following steps
+    if (m_method == TimeStepMethod_BDF2Adaptive)
+        m_tau = qMin(m_tau, TIMESTEPPING_FIRST_STEP * sqrt(qMin(1.0, m_tolerance / 100.0)) * m_timeTotal);
+
+    m_ndof = ndof;
+    for (int i = 0; i < 3; i++)
+        m_levels[i] = new scalar[m_ndof];
+    m_tauLevels[0] = 0.0;
+    m_tauLevels[1] = 0.0;
+    m_levelCount = 0;
+    for (int i = 0; i < 3; i++)
+        m_derivative[i] = 0.0;
+}
+
+TimeStepping::~TimeStepping()
+{
+    for (int i = 0; i < 3; i++)
+        delete [] m_levels[i];
+}
+
+void TimeStepping::setInitialCondition(scalar *coeffs)
+{
+    m_levelCount = 0;
+    push(coeffs);
+}
+
+bool TimeStepping::isBDF2() const
+{
+    return (m_method == TimeStepMethod_BDF2 || m_method == TimeStepMethod_BDF2Adaptive);
+}
+
+bool TimeStepping::isFinished() const
+{
+    if (m_method == TimeStepMethod_BDF2Adaptive)
+        return (m_time >= m_timeTotal * (1.0 - TIMESTEPPING_MIN_STEP));
+    else
+        return (m_steps >= m_stepsTotal);
+}
+
+double TimeStepping::time() const
+{
+    if (m_method == TimeStepMethod_BDF2Adaptive)
+        return m_time + m_tau;
+    else
+        return (m_steps + 1) * m_tau;
+}
+
+void TimeStepping::coefficients(double &alpha0, double &alpha1, double &alpha2) const
+{
+    if (isBDF2() && m_levelCount >= 2)
+    {
+        // variable step BDF2 (ratio of the actual and the previous step)
+        double omega = m_tau / m_tauLevels[0];
+
+        alpha0 = (1.0 + 2.0*omega) / (1.0 + omega);
+        alpha1 = 1.0 + omega;
+        alpha2 = omega*omega / (1.0 + omega);
+    }
+    else
+    {
+        // implicit Euler
+        alpha0 = 1.0;
+        alpha1 = 1.0;
+        alpha2 = 0.0;
+    }
+}
+
+double TimeStepping::effectiveStep() const
+{
+    double alpha0, alpha1, alpha2;
+    coefficients(alpha0, alpha1, alpha2);
+
+    return m_tau / alpha0;
+}
+
+bool TimeStepping::history(scalar *coeffs) const
+{
+    if (m_levelCount == 0)
+        return false;
+
+    double alpha0, alpha1, alpha2;
+    coefficients(alpha0, alpha1, alpha2);
+
+    // alpha1 - alpha2 = alpha0, the Dirichlet lift of the history is kept
+    for (int i = 0; i < m_ndof; i++)
+    {
+        coeffs[i] = alpha1 * m_levels[0][i];
+        if (alpha2 != 0.0)
+            coeffs[i] -= alpha2 * m_levels[1][i];
+        coeffs[i] /= alpha0;
+    }
+
+    return true;
+}
+
+void TimeStepping::setDerivative()
+{
+    double alpha0, alpha1, alpha2;
+    coefficients(alpha0, alpha1, alpha2);
+
+    // (alpha0 u(n+1) - alpha1 u(n) + alpha2 u(n-1)) / tau of the actual step
+    m_derivative[0] = alpha0 / m_tau;
+    m_derivative[1] = - alpha1 / m_tau;
+    m_derivative[2] = alpha2 / m_tau;
+}
+
+void TimeStepping::push(scalar *coeffs)
+{
+    // rotate the levels
+    scalar *last = m_levels[2];
+    m_levels[2] = m_levels[1];
+    m_levels[1] = m_levels[0];
+    m_levels[0] = last;
+    memcpy(m_levels[0], coeffs, m_ndof * sizeof(scalar));
+
+    m_tauLevels[1] = m_tauLevels[0];
+    m_tauLevels[0] = m_tau;
+
+    if (m_levelCount < 3)
+        m_levelCount++;
+}
+
+void TimeStepping::restore(scalar *coeffs, double time, double timeStepNext, int rejected)
+{
+    m_tau = time - m_time;
+    setDerivative();
+    push(coeffs);
+    m_steps++;
+    m_time = time;
+
+    m_tau = timeStepNext;
+    m_rejected = rejected;
+}
+
+bool TimeStepping::accept(scalar *coeffs)
+{
+    if (m_method != TimeStepMethod_BDF2Adaptive)
+    {
+        setDerivative();
+        push(coeffs);
+        m_steps++;
+        m_time = m_steps * m_tau;
+
+        return true;
+    }
+
+    // local error estimate - difference of the solution and the predictor
+    m_error = -1.0;
+    if (m_levelCount >= 2)
+    {
+        double tau = m_tau;
+        double tau1 = m_tauLevels[0];
+        double tau2 = m_tauLevels[1];
+
+        double l0, l1, l2, scale;
+        if (m_levelCount >= 3)
+        {
+            // quadratic extrapolation from t(n), t(n-1), t(n-2)
+            l0 = (tau + tau1) * (tau + tau1 + tau2) / (tau1 * (tau1 + tau2));
+            l1 = - tau * (tau + tau1 + tau2) / (tau1 * tau2);
+            l2 = tau * (tau + tau1) / ((tau1 + tau2) * tau2);
+
+            // error constants of the predictor and the corrector (BDF2)
+            double alpha0, alpha1, alpha2;
+            coefficients(alpha0, alpha1, alpha2);
+            double errorPredictor = tau * (tau + tau1) * (tau + tau1 + tau2) / 6.0;
+            double errorCorrector = (alpha0*tau*tau*tau - alpha2*tau1*tau1*tau1 - 3.0*tau*tau*tau) / (6.0 * alpha0);
+
+            scale = fabs(errorCorrector / (errorPredictor - errorCorrector));
+        }
+        else
+        {
+            // linear extrapolation, the estimate is conservative
+            l0 = 1.0 + tau / tau1;
+            l1 = - tau / tau1;
+            l2 = 0.0;
+
+            scale = 1.0;
+        }
+
+        double normDifference = 0.0;
+        double normSolution = 0.0;
+        double normPrevious = 0.0;
+        for (int i = 0; i < m_ndof; i++)
+        {
+            scalar predictor = l0 * m_levels[0][i] + l1 * m_levels[1][i];
+            if (l2 != 0.0)
+                predictor += l2 * m_levels[2][i];
+
+            normDifference += std::abs(coeffs[i] - predictor) * std::abs(coeffs[i] - predictor);
+            normSolution += std::abs(coeffs[i]) * std::abs(coeffs[i]);
+            normPrevious += std::abs(m_levels[0][i]) * std::abs(m_levels[0][i]);
+        }
+
+        double norm = sqrt(qMax(normSolution, normPrevious));
+        m_error = (norm > 0.0) ? 100.0 * scale * sqrt(normDifference) / norm : 0.0;
+    }
+
+    // step controller (order of the error estimate is 3)
+    double factor = 1.0;
+    if (m_error > 0.0)
+        factor = qBound(TIMESTEPPING_MAX_DECREASE,
+                        TIMESTEPPING_SAFETY * pow(m_tolerance / m_error, 1.0/3.0),
+                        TIMESTEPPING_MAX_INCREASE);
+    else if (m_error == 0.0)
+        factor = TIMESTEPPING_MAX_INCREASE;
+
+    // reject the step
+    if (m_error > m_tolerance && factor < 1.0 && m_tau * factor > TIMESTEPPING_MIN_STEP * m_timeTotal)
+    {
+        m_tau *= factor;
+        m_rejected++;
+
+        return false;
+    }
+
+    setDerivative();
+    push(coeffs);
+    m_steps++;
+    m_time += m_tau;
+
+    // small increase keeps the step, the matrix and its factorization can be reused
+    if (factor < 1.0 || factor >= TIMESTEPPING_KEEP_INCREASE)
+        m_tau *= factor;
+    // the step accepted at the minimum length is not shortened further (the time interval is finished)
+    m_tau = qMax(m_tau, TIMESTEPPING_MIN_STEP * m_timeTotal);
+
+    // end of the time interval (stretch the last step rather than add a very short one)
+    double remaining = m_timeTotal - m_time;
+    if (remaining > 0.0 && remaining < 1.1 * m_tau)
+        m_tau = remaining;
+
+    return true;
+}
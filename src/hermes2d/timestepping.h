@@ -0,0 +1,97 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef TIMESTEPPING_H
+#define TIMESTEPPING_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+const double TIMESTEPPING_SAFETY = 0.9;
+const double TIMESTEPPING_MAX_INCREASE = 2.0; // BDF2 is zero-stable for the ratio of the steps below 1 + sqrt(2)
+const double TIMESTEPPING_MAX_DECREASE = 0.2;
+const double TIMESTEPPING_KEEP_INCREASE = 1.5; // smaller increase keeps the step (and the factorization)
+const double TIMESTEPPING_MIN_STEP = 1e-9; // relative to the total time
+const double TIMESTEPPING_FIRST_STEP = 0.1; // relative to the total time, scaled by the square root of the tolerance
+
+// Time integration of the coefficient vectors of a transient problem (the space does not change).
+// Implicit Euler or variable step BDF2 (the first step is implicit Euler)
+//   alpha0 u(n+1) - alpha1 u(n) + alpha2 u(n-1) = tau f(u(n+1)),
+// the weak forms keep the mass term (u - u_prev) / timeStep with the effective step tau / alpha0
+// and the history u_prev = (alpha1 u(n) - alpha2 u(n-1)) / alpha0.
+// The adaptive step is controlled by the local error estimated from the difference
+// of the solution and the explicit predictor (extrapolation of the previous steps).
+class TimeStepping
+{
+public:
+    TimeStepping(TimeStepMethod method, double timeStep, double timeTotal, double tolerance, int ndof);
+    ~TimeStepping();
+
+    // coefficients of the initial condition (needed by BDF2)
+    void setInitialCondition(scalar *coeffs);
+
+    bool isFinished() const;
+
+    // time at the end of the actual step
+    double time() const;
+    inline double step() const { return m_tau; }
+    // effective step of the weak forms (tau / alpha0)
+    double effectiveStep() const;
+    // history of the actual step, false if it is not known (initial condition of the implicit Euler)
+    bool history(scalar *coeffs) const;
+
+    // solution of the actual step, false if the step is rejected (and shortened)
+    bool accept(scalar *coeffs);
+    // accepted step of the checkpoint (the length of the next step and the number of the rejected steps)
+    void restore(scalar *coeffs, double time, double timeStepNext, int rejected);
+
+    inline int steps() const { return m_steps; }
+    inline int rejected() const { return m_rejected; }
+    // estimated error of the last step (%), negative if it is not known
+    inline double error() const { return m_error; }
+    // time derivative of the last accepted step (postprocessor)
+    //   du/dt = derivative[0] u(n) + derivative[1] u(n-1) + derivative[2] u(n-2)
+    inline const double *derivative() const { return m_derivative; }
+
+private:
+    TimeStepMethod m_method;
+    double m_timeTotal;
+    double m_tolerance;
+    int m_stepsTotal; // fixed step
+
+    double m_time; // beginning of the actual step
+    double m_tau;
+    int m_steps;
+    int m_rejected;
+    double m_error;
+
+    // u(n), u(n-1), u(n-2) and the lengths of the steps t(n) - t(n-1), t(n-1) - t(n-2)
+    int m_ndof;
+    scalar *m_levels[3];
+    double m_tauLevels[2];
+    int m_levelCount;
+    double m_derivative[3];
+
+    bool isBDF2() const;
+    void coefficients(double &alpha0, double &alpha1, double &alpha2) const;
+    void setDerivative();
+    void push(scalar *coeffs);
+};
+
+#endif // TIMESTEPPING_H
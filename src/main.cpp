@@ -92,10 +92,23 @@ int main(int argc, char *argv[])
         }
     }
 
+    // parameter sweep worker (agros2d -sweep fileName) has no window, it must not wait for the user
+    if (args.contains("-sweep"))
+    {
+        if (args.count() != 3 || args[1] != "-sweep" || !QFile::exists(args[2]))
+        {
+            qWarning() << "Parameter sweep worker: script" << (args.count() == 3 ? args[2] : QString()) << "does not exist.";
+            a.exit(1);
+            return 1;
+        }
+    }
+
     qDebug() << "Agros2D starting";
 
     MainWindow w;
-    w.show();
+    // parameter sweep workers run without window
+    if (!args.contains("-sweep"))
+        w.show();
 
     return a.exec();
 }
@@ -19,6 +19,8 @@
 
 #include "mainwindow.h"
 #include "datatabledialog.h"
+#include "parametersweep.h"
+#include "hermes2d/checkpoint.h"
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 {
@@ -73,11 +75,13 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 
     doInvalidated();
 
-    if (settings.value("General/CheckVersion", true).value<bool>())
-        checkForNewVersion(true);
-
     // parameters
     QStringList args = QCoreApplication::arguments();
+
+    // parameter sweep workers do not check the version
+    if (settings.value("General/CheckVersion", true).value<bool>() && !args.contains("-sweep"))
+        checkForNewVersion(true);
+
     if (args.count() > 1)
     {
         if (args.count() == 2)
@@ -92,6 +96,10 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
                 if (QFile::exists(args[2]))
                     runPythonScript(readFileContent(args[2]));
             }
+
+            // parameter sweep worker (the script is checked in main(), the worker always quits)
+            if (args[1] == "-sweep")
+                runSweepWorker(args[2]);
         }
     }
 }
@@ -233,6 +241,10 @@ void MainWindow::createActions()
     actSolve->setStatusTip(tr("Solve problem"));
     connect(actSolve, SIGNAL(triggered()), this, SLOT(doSolve()));
 
+    actSolveResume = new QAction(tr("&Resume solve"), this);
+    actSolveResume->setStatusTip(tr("Resume transient solve from the checkpoint"));
+    connect(actSolveResume, SIGNAL(triggered()), this, SLOT(doSolveResume()));
+
     actChart = new QAction(icon("chart"), tr("&Chart"), this);
     actChart->setStatusTip(tr("Chart"));
     connect(actChart, SIGNAL(triggered()), this, SLOT(doChart()));
@@ -355,6 +367,7 @@ void MainWindow::createMenus()
     mnuProblem->addSeparator();
     mnuProblem->addAction(actCreateMesh);
     mnuProblem->addAction(actSolve);
+    mnuProblem->addAction(actSolveResume);
     mnuProblem->addAction(Util::scene()->actClearSolution);
     mnuProblem->addSeparator();
     mnuProblem->addAction(Util::scene()->actProblemProperties);
@@ -800,6 +813,24 @@ void MainWindow::doSolve()
     activateWindow();
 }
 
+void MainWindow::doSolveResume()
+{
+    // continue transient solve from the checkpoint
+    Util::scene()->sceneSolution()->solve(SolverMode_Resume);
+    if (Util::scene()->sceneSolution()->isSolved())
+    {
+        sceneView->actSceneModePostprocessor->trigger();
+
+        // show local point values
+        Point point = Point(0, 0);
+        localPointValueView->doShowPoint(point);
+    }
+
+    doInvalidated();
+    setFocus();
+    activateWindow();
+}
+
 void MainWindow::doOptions()
 {
     ConfigDialog configDialog(this);
@@ -890,6 +921,8 @@ void MainWindow::doInvalidated()
     actChart->setEnabled(Util::scene()->sceneSolution()->isSolved());
     actCreateVideo->setEnabled(Util::scene()->sceneSolution()->isSolved() && (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient));
     tlbTransient->setEnabled(Util::scene()->sceneSolution()->isSolved());
+    actSolveResume->setEnabled((Util::scene()->problemInfo()->analysisType == AnalysisType_Transient) &&
+                               QFile::exists(Checkpoint::checkpointFileName()));
     fillComboBoxTimeStep(cmbTimeStep);
 
     lblProblemType->setText(tr("Problem Type: %1").arg(problemTypeString(Util::scene()->problemInfo()->problemType)));
@@ -976,7 +1009,7 @@ void MainWindow::doDocumentExportMeshFile()
         }
 
         if (!fileName.isEmpty())
-            QFile::copy(tempProblemFileName() + ".mesh", fileName + ".mesh");
+            QFile::copy(spillScratchContent("mesh"), fileName + ".mesh");
 
         QFile::remove(tempProblemFileName() + ".mesh");
     }
@@ -63,6 +63,7 @@ private slots:
 
     void doCreateMesh();
     void doSolve();
+    void doSolveResume();
     void doProgressLog();
 
     void doChart();
@@ -137,6 +138,7 @@ private:
     QAction *actOptions;
     QAction *actCreateMesh;
     QAction *actSolve;
+    QAction *actSolveResume;
     QAction *actProgressLog;
     QAction *actChart;
     QAction *actFullScreen;
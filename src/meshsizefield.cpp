@@ -0,0 +1,98 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#include "meshsizefield.h"
+
+#include "scene.h"
+
+MeshSizeField::MeshSizeField(const QList<SceneEdge *> &edges, double gradation)
+{
+    m_gradation = qMax(gradation, 0.0);
+    m_rotorAngle = 0.0;
+
+    foreach (SceneEdge *edge, edges)
+    {
+        if (edge->meshSize > 0.0)
+        {
+            m_sources.append(edge);
+            m_sourcesRotor.append(false);
+        }
+    }
+}
+
+void MeshSizeField::setRotor(const Point &center, double radius, double angle)
+{
+    m_rotorCenter = center;
+    m_rotorAngle = angle / 180.0 * M_PI;
+
+    for (int i = 0; i < m_sources.count(); i++)
+        m_sourcesRotor[i] = ((m_sources[i]->nodeStart->point - center).magnitude() < radius &&
+                             (m_sources[i]->nodeEnd->point - center).magnitude() < radius);
+}
+
+double MeshSizeField::size(const Point &point) const
+{
+    // point in the initial position of the rotor
+    Point vector = point - m_rotorCenter;
+    Point pointRotor = m_rotorCenter + Point(vector.x * cos(m_rotorAngle) + vector.y * sin(m_rotorAngle),
+                                             - vector.x * sin(m_rotorAngle) + vector.y * cos(m_rotorAngle));
+
+    double size = CONST_DOUBLE;
+    for (int i = 0; i < m_sources.count(); i++)
+        size = qMin(size, m_sources[i]->meshSize + m_gradation * m_sources[i]->distance(m_sourcesRotor[i] ? pointRotor : point));
+
+    return size;
+}
+
+int MeshSizeField::refine(Mesh *mesh, int maxSteps) const
+{
+    if (isEmpty())
+        return 0;
+
+    int count = 0;
+    for (int i = 0; i < maxSteps; i++)
+    {
+        // elements created in this pass are checked in the next one
+        QList<int> marked;
+
+        Element *e;
+        for_all_active_elements(e, mesh)
+        {
+            Point centroid;
+            for (int j = 0; j < e->nvert; j++)
+            {
+                centroid.x += e->vn[j]->x / e->nvert;
+                centroid.y += e->vn[j]->y / e->nvert;
+            }
+
+            if (e->get_diameter() > size(centroid))
+                marked.append(e->id);
+        }
+
+        if (marked.isEmpty())
+            break;
+
+        foreach (int id, marked)
+            mesh->refine_element(id);
+        count += marked.count();
+    }
+
+    return count;
+}
@@ -0,0 +1,58 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#ifndef MESHSIZEFIELD_H
+#define MESHSIZEFIELD_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+class SceneEdge;
+
+const int MESHSIZEFIELD_MAX_STEPS = 5; // maximum number of the local refinement passes
+
+// Target element size given by the edges with the mesh size.
+// The size grows linearly with the distance from the edge (gradation).
+class MeshSizeField
+{
+public:
+    MeshSizeField(const QList<SceneEdge *> &edges, double gradation);
+
+    inline bool isEmpty() const { return m_sources.isEmpty(); }
+
+    // edges inside the radius are rotated by the angle (deg) around the center (rotor of the moving band)
+    void setRotor(const Point &center, double radius, double angle);
+
+    // target size in the point (CONST_DOUBLE if there are no sources)
+    double size(const Point &point) const;
+
+    // refines active elements larger than the target size, returns number of refined elements
+    int refine(Mesh *mesh, int maxSteps) const;
+
+private:
+    QList<SceneEdge *> m_sources;
+    QList<bool> m_sourcesRotor;
+    double m_gradation;
+
+    Point m_rotorCenter;
+    double m_rotorAngle;
+};
+
+#endif // MESHSIZEFIELD_H
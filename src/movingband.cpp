@@ -0,0 +1,494 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "movingband.h"
+
+// items (inner braces) of the section of the Hermes2D mesh file
+static QList<QVector<double> > meshSection(const QString &content, const QString &name)
+{
+    QList<QVector<double> > items;
+
+    int pos = content.indexOf(QRegExp("\\b" + name + "\\s*="));
+    if (pos == -1)
+        return items;
+    pos = content.indexOf("{", pos);
+    if (pos == -1)
+        return items;
+
+    pos++;
+    while (true)
+    {
+        int open = content.indexOf("{", pos);
+        int close = content.indexOf("}", pos);
+
+        // end of the section
+        if ((close == -1) || (open == -1) || (close < open))
+            break;
+
+        close = content.indexOf("}", open);
+        QVector<double> item;
+        foreach (QString value, content.mid(open + 1, close - open - 1).split(",", QString::SkipEmptyParts))
+            item.append(value.trimmed().toDouble());
+        items.append(item);
+
+        pos = close + 1;
+    }
+
+    return items;
+}
+
+// kind of the mesh nodes
+enum NodeKind
+{
+    NodeKind_Rotor,
+    NodeKind_Band,
+    NodeKind_Stator
+};
+
+MovingBand::MovingBand(const QByteArray &mesh, const Point &center, double radiusInner, double radiusOuter)
+    : m_center(center), m_radiusInner(radiusInner), m_radiusOuter(radiusOuter), m_remeshCount(0), m_angle(0.0),
+      m_bandMarker(-1), m_bandAngle(0.0), m_bandMinAngle(0.0), m_countNodes(0)
+{
+    if ((radiusInner <= 0.0) || (radiusOuter <= radiusInner))
+    {
+        m_error = QObject::tr("Inner radius of the band has to be positive and smaller than outer radius.");
+        return;
+    }
+
+    QString content(mesh);
+
+    foreach (QVector<double> item, meshSection(content, "vertices"))
+        m_nodes.append(Point(item.value(0), item.value(1)));
+
+    QList<QVector<double> > elements = meshSection(content, "elements");
+    if (m_nodes.isEmpty() || elements.isEmpty())
+    {
+        m_error = QObject::tr("Mesh is empty.");
+        return;
+    }
+
+    double tolerance = 1e-5 * radiusOuter;
+    QVector<NodeKind> kind(m_nodes.count());
+    m_nodeRotor.resize(m_nodes.count());
+    for (int i = 0; i < m_nodes.count(); i++)
+    {
+        double radius = (m_nodes[i] - center).magnitude();
+        if (radius <= radiusInner + tolerance)
+            kind[i] = NodeKind_Rotor;
+        else if (radius >= radiusOuter - tolerance)
+            kind[i] = NodeKind_Stator;
+        else
+            kind[i] = NodeKind_Band;
+
+        m_nodeRotor[i] = (kind[i] == NodeKind_Rotor);
+    }
+
+    // elements
+    QVector<int> bandElements;
+    foreach (QVector<double> item, elements)
+    {
+        if (item.count() != 4)
+        {
+            m_error = QObject::tr("Moving band supports triangular elements only.");
+            return;
+        }
+
+        int node[3];
+        for (int j = 0; j < 3; j++)
+        {
+            node[j] = int(item[j]);
+            if ((node[j] < 0) || (node[j] >= m_nodes.count()))
+            {
+                m_error = QObject::tr("Mesh is not valid.");
+                return;
+            }
+        }
+        int marker = int(item[3]);
+
+        double radius = ((m_nodes[node[0]] + m_nodes[node[1]] + m_nodes[node[2]]) / 3.0 - center).magnitude();
+        if ((radius < radiusInner) || (radius > radiusOuter))
+        {
+            // rotor or stator element
+            NodeKind kindElement = (radius < radiusInner) ? NodeKind_Rotor : NodeKind_Stator;
+            for (int j = 0; j < 3; j++)
+            {
+                if (kind[node[j]] != kindElement)
+                {
+                    m_error = QObject::tr("Mesh elements cross the boundary of the band, the band has to be bounded by the circles with radius %1 and %2.").
+                            arg(radiusInner).arg(radiusOuter);
+                    return;
+                }
+            }
+
+            m_elements << node[0] << node[1] << node[2] << marker;
+        }
+        else
+        {
+            // band element
+            for (int j = 0; j < 3; j++)
+            {
+                double radiusNode = (m_nodes[node[j]] - center).magnitude();
+                if ((radiusNode < radiusInner - tolerance) || (radiusNode > radiusOuter + tolerance))
+                {
+                    m_error = QObject::tr("Mesh elements cross the boundary of the band, the band has to be bounded by the circles with radius %1 and %2.").
+                            arg(radiusInner).arg(radiusOuter);
+                    return;
+                }
+            }
+
+            if (m_bandMarker == -1)
+                m_bandMarker = marker;
+            if (m_bandMarker != marker)
+            {
+                m_error = QObject::tr("Band has to be one area with the same material.");
+                return;
+            }
+
+            bandElements << node[0] << node[1] << node[2];
+        }
+    }
+
+    if (bandElements.isEmpty())
+    {
+        m_error = QObject::tr("There are no elements in the band.");
+        return;
+    }
+
+    // boundaries and curves must not touch the band
+    foreach (QVector<double> item, meshSection(content, "boundaries"))
+    {
+        int node_1 = int(item.value(0));
+        int node_2 = int(item.value(1));
+        if ((kind.value(node_1, NodeKind_Band) == NodeKind_Band) || (kind.value(node_2, NodeKind_Band) == NodeKind_Band) ||
+                (kind[node_1] != kind[node_2]))
+        {
+            m_error = QObject::tr("Band must not contain edges of the geometry.");
+            return;
+        }
+
+        m_boundaries << node_1 << node_2 << int(item.value(2));
+    }
+
+    foreach (QVector<double> item, meshSection(content, "curves"))
+    {
+        int node_1 = int(item.value(0));
+        int node_2 = int(item.value(1));
+        if ((kind.value(node_1, NodeKind_Band) == NodeKind_Band) || (kind.value(node_2, NodeKind_Band) == NodeKind_Band) ||
+                (kind[node_1] != kind[node_2]))
+        {
+            m_error = QObject::tr("Band must not contain edges of the geometry.");
+            return;
+        }
+
+        m_curves << node_1 << node_2;
+        m_curvesAngle << item.value(2);
+    }
+
+    // output numbering - rotor and stator nodes first, then the band nodes
+    m_nodeIndex.resize(m_nodes.count());
+    QVector<int> bandIndex(m_nodes.count(), -1);
+    for (int i = 0; i < m_nodes.count(); i++)
+        m_nodeIndex[i] = (kind[i] == NodeKind_Band) ? -1 : m_countNodes++;
+    for (int i = 0; i < m_nodes.count(); i++)
+    {
+        if (kind[i] == NodeKind_Band)
+        {
+            bandIndex[i] = m_countNodes + m_bandNodes.count();
+            m_bandNodes.append(m_nodes[i]);
+        }
+    }
+
+    for (int i = 0; i < bandElements.count(); i++)
+        m_bandElements.append((kind[bandElements[i]] == NodeKind_Band) ? bandIndex[bandElements[i]] : m_nodeIndex[bandElements[i]]);
+
+    // boundary of the band (edges with one band element)
+    QMap<QPair<int, int>, int> edges;
+    for (int i = 0; i < m_bandElements.count() / 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            int node_1 = m_bandElements[3*i + j];
+            int node_2 = m_bandElements[3*i + (j + 1) % 3];
+            edges[QPair<int, int>(qMin(node_1, node_2), qMax(node_1, node_2))]++;
+        }
+    }
+
+    for (QMap<QPair<int, int>, int>::const_iterator it = edges.constBegin(); it != edges.constEnd(); ++it)
+    {
+        if (it.value() == 1)
+        {
+            if ((it.key().first >= m_countNodes) || (it.key().second >= m_countNodes))
+            {
+                m_error = QObject::tr("Band has to be closed by the rotor and stator.");
+                return;
+            }
+            m_bandBoundary << it.key().first << it.key().second;
+        }
+    }
+
+    QVector<Point> nodes(m_countNodes + m_bandNodes.count());
+    for (int i = 0; i < m_nodes.count(); i++)
+        nodes[(kind[i] == NodeKind_Band) ? bandIndex[i] : m_nodeIndex[i]] = m_nodes[i];
+    m_bandMinAngle = minAngle(nodes);
+}
+
+QByteArray MovingBand::mesh(double angle)
+{
+    if (!isValid())
+        return QByteArray();
+
+    double theta = angle / 180.0 * M_PI;
+
+    // rotor is rotated, stator is fixed
+    QVector<Point> nodes(m_countNodes + m_bandNodes.count());
+    for (int i = 0; i < m_nodes.count(); i++)
+        if (m_nodeIndex[i] != -1)
+            nodes[m_nodeIndex[i]] = m_nodeRotor[i] ? rotate(m_nodes[i], theta) : m_nodes[i];
+
+    // band is deformed, the rotation decreases linearly from the rotor to the stator
+    for (int i = 0; i < m_bandNodes.count(); i++)
+    {
+        double weight = (m_radiusOuter - (m_bandNodes[i] - m_center).magnitude()) / (m_radiusOuter - m_radiusInner);
+        weight = qMax(0.0, qMin(1.0, weight));
+
+        nodes[m_countNodes + i] = rotate(m_bandNodes[i], (theta - m_bandAngle) * weight);
+    }
+
+    // new triangulation of the band
+    if (minAngle(nodes) < qMin(MOVINGBAND_MIN_ANGLE, 0.5 * m_bandMinAngle))
+    {
+        if (!triangulate(nodes, theta))
+            return QByteArray();
+
+        nodes.resize(m_countNodes);
+        nodes += m_bandNodes;
+    }
+
+    QString outNodes;
+    outNodes += "vertices = \n";
+    outNodes += "{ \n";
+    for (int i = 0; i < nodes.count(); i++)
+        outNodes += QString("\t{ %1,  %2 }, \n").arg(nodes[i].x, 0, 'f', 10).arg(nodes[i].y, 0, 'f', 10);
+    outNodes.truncate(outNodes.length()-3);
+    outNodes += "\n} \n\n";
+
+    QString outElements;
+    outElements += "elements = \n";
+    outElements += "{ \n";
+    for (int i = 0; i < m_elements.count() / 4; i++)
+        outElements += QString("\t{ %1, %2, %3, %4  }, \n").
+                arg(m_nodeIndex[m_elements[4*i]]).
+                arg(m_nodeIndex[m_elements[4*i + 1]]).
+                arg(m_nodeIndex[m_elements[4*i + 2]]).
+                arg(m_elements[4*i + 3]);
+    for (int i = 0; i < m_bandElements.count() / 3; i++)
+        outElements += QString("\t{ %1, %2, %3, %4  }, \n").
+                arg(m_bandElements[3*i]).
+                arg(m_bandElements[3*i + 1]).
+                arg(m_bandElements[3*i + 2]).
+                arg(m_bandMarker);
+    outElements.truncate(outElements.length()-3);
+    outElements += "\n} \n\n";
+
+    QString outEdges;
+    outEdges += "boundaries = \n";
+    outEdges += "{ \n";
+    for (int i = 0; i < m_boundaries.count() / 3; i++)
+        outEdges += QString("\t{ %1, %2, %3 }, \n").
+                arg(m_nodeIndex[m_boundaries[3*i]]).
+                arg(m_nodeIndex[m_boundaries[3*i + 1]]).
+                arg(m_boundaries[3*i + 2]);
+    outEdges.truncate(outEdges.length()-3);
+    outEdges += "\n} \n\n";
+
+    QString outCurves;
+    if (!m_curvesAngle.isEmpty())
+    {
+        outCurves += "curves = \n";
+        outCurves += "{ \n";
+        for (int i = 0; i < m_curvesAngle.count(); i++)
+            outCurves += QString("\t{ %1, %2, %3 }, \n").
+                    arg(m_nodeIndex[m_curves[2*i]]).
+                    arg(m_nodeIndex[m_curves[2*i + 1]]).
+                    arg(m_curvesAngle[i], 0, 'f', 10);
+        outCurves.truncate(outCurves.length()-3);
+        outCurves += "\n} \n\n";
+    }
+
+    m_angle = angle;
+
+    return QString(outNodes + outElements + outEdges + outCurves).toAscii();
+}
+
+double MovingBand::rotation(const Point &point) const
+{
+    return ((point - m_center).magnitude() < m_radiusInner) ? m_angle : 0.0;
+}
+
+Point MovingBand::rotate(const Point &point, double angle) const
+{
+    Point vector = point - m_center;
+
+    return m_center + Point(vector.x * cos(angle) - vector.y * sin(angle),
+                            vector.x * sin(angle) + vector.y * cos(angle));
+}
+
+double MovingBand::minAngle(const QVector<Point> &nodes) const
+{
+    double angleMin = 180.0;
+    for (int i = 0; i < m_bandElements.count() / 3; i++)
+    {
+        Point p[3] = { nodes[m_bandElements[3*i]], nodes[m_bandElements[3*i + 1]], nodes[m_bandElements[3*i + 2]] };
+
+        // inverted element
+        if (((p[1] - p[0]) % (p[2] - p[0])) <= 0.0)
+            return -1.0;
+
+        for (int j = 0; j < 3; j++)
+        {
+            Point a = p[(j + 1) % 3] - p[j];
+            Point b = p[(j + 2) % 3] - p[j];
+
+            double cosAngle = (a & b) / (a.magnitude() * b.magnitude());
+            angleMin = qMin(angleMin, acos(qMax(-1.0, qMin(1.0, cosAngle))) / M_PI * 180.0);
+        }
+    }
+
+    return angleMin;
+}
+
+bool MovingBand::triangulate(const QVector<Point> &nodes, double angle)
+{
+    // save current locale
+    char *plocale = setlocale (LC_NUMERIC, "");
+    setlocale (LC_NUMERIC, "C");
+
+    // boundary nodes of the band (rotor and stator nodes)
+    QList<int> boundaryNodes;
+    QMap<int, int> polyIndex;
+    foreach (int node, m_bandBoundary)
+    {
+        if (!polyIndex.contains(node))
+        {
+            polyIndex[node] = boundaryNodes.count();
+            boundaryNodes.append(node);
+        }
+    }
+
+    QString outPoly;
+    outPoly += QString("%1 2 0 0\n").arg(boundaryNodes.count());
+    for (int i = 0; i < boundaryNodes.count(); i++)
+        outPoly += QString("%1  %2  %3\n").
+                arg(i).
+                arg(nodes[boundaryNodes[i]].x, 0, 'f', 10).
+                arg(nodes[boundaryNodes[i]].y, 0, 'f', 10);
+    outPoly += QString("%1 0\n").arg(m_bandBoundary.count() / 2);
+    for (int i = 0; i < m_bandBoundary.count() / 2; i++)
+        outPoly += QString("%1  %2  %3\n").
+                arg(i).
+                arg(polyIndex[m_bandBoundary[2*i]]).
+                arg(polyIndex[m_bandBoundary[2*i + 1]]);
+    // rotor is a hole
+    outPoly += "1\n";
+    outPoly += QString("0  %1  %2\n").arg(m_center.x, 0, 'f', 10).arg(m_center.y, 0, 'f', 10);
+
+    QString fileName = tempProblemFileName() + ".band";
+    writeStringContent(fileName + ".poly", &outPoly);
+
+    // boundary of the band is kept (-Y), so the rotor and stator meshes are not changed
+    QProcess processTriangle;
+    processTriangle.start(QString("%1 -p -P -Y -q30.0 -z -Q -I \"%2\"").
+                          arg(triangleBinary()).
+                          arg(fileName));
+
+    if (!processTriangle.waitForStarted() || !processTriangle.waitForFinished() || (processTriangle.exitCode() != 0))
+    {
+        m_error = QObject::tr("Triangulation of the band failed.");
+        processTriangle.kill();
+        setlocale(LC_NUMERIC, plocale);
+        return false;
+    }
+
+    QFile fileNode(fileName + ".node");
+    QFile fileEle(fileName + ".ele");
+    if (!fileNode.open(QIODevice::ReadOnly | QIODevice::Text) || !fileEle.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        m_error = QObject::tr("Could not read Triangle files of the band.");
+        setlocale(LC_NUMERIC, plocale);
+        return false;
+    }
+    QTextStream inNode(&fileNode);
+    QTextStream inEle(&fileEle);
+
+    int k, n, node_1, node_2, node_3;
+    double x, y;
+
+    // input nodes keep their numbering, new nodes are appended
+    QVector<int> index;
+    QVector<Point> bandNodes;
+    sscanf(inNode.readLine().toStdString().c_str(), "%i", &k);
+    for (int i = 0; i < k; i++)
+    {
+        sscanf(inNode.readLine().toStdString().c_str(), "%i   %lf %lf", &n, &x, &y);
+        if (i < boundaryNodes.count())
+        {
+            index.append(boundaryNodes[i]);
+        }
+        else
+        {
+            index.append(m_countNodes + bandNodes.count());
+            bandNodes.append(Point(x, y));
+        }
+    }
+
+    QVector<int> bandElements;
+    sscanf(inEle.readLine().toStdString().c_str(), "%i", &k);
+    for (int i = 0; i < k; i++)
+    {
+        sscanf(inEle.readLine().toStdString().c_str(), "%i	%i	%i	%i", &n, &node_1, &node_2, &node_3);
+        bandElements << index.value(node_1) << index.value(node_2) << index.value(node_3);
+    }
+
+    fileNode.close();
+    fileEle.close();
+
+    QFile::remove(fileName + ".poly");
+    QFile::remove(fileName + ".node");
+    QFile::remove(fileName + ".ele");
+
+    // set system locale
+    setlocale(LC_NUMERIC, plocale);
+
+    if (bandElements.isEmpty())
+    {
+        m_error = QObject::tr("Triangulation of the band failed.");
+        return false;
+    }
+
+    m_bandAngle = angle;
+    m_bandNodes = bandNodes;
+    m_bandElements = bandElements;
+    m_remeshCount++;
+
+    QVector<Point> nodesBand = nodes.mid(0, m_countNodes);
+    nodesBand += m_bandNodes;
+    m_bandMinAngle = minAngle(nodesBand);
+
+    return true;
+}
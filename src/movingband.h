@@ -0,0 +1,82 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef MOVINGBAND_H
+#define MOVINGBAND_H
+
+#include "util.h"
+
+const double MOVINGBAND_MIN_ANGLE = 15.0; // minimal angle of the deformed band elements (deg)
+
+// Rotor positions of rotating machines without remeshing of the whole geometry.
+// The mesh inside the inner radius (rotor) is rotated, the mesh outside the outer radius
+// (stator) is fixed and the band between them (air gap) is deformed. The band is
+// re-triangulated only when its elements are distorted too much.
+class MovingBand
+{
+public:
+    MovingBand(const QByteArray &mesh, const Point &center, double radiusInner, double radiusOuter);
+
+    inline bool isValid() const { return m_error.isEmpty(); }
+    inline QString error() const { return m_error; }
+    inline int remeshCount() const { return m_remeshCount; }
+
+    inline Point center() const { return m_center; }
+    inline double radiusInner() const { return m_radiusInner; }
+    // rotor position of the last mesh (deg)
+    inline double angle() const { return m_angle; }
+    // rotation of the point of the initial geometry (deg), the rotor angle inside the inner radius
+    double rotation(const Point &point) const;
+
+    // Hermes2D mesh with the rotor rotated by the angle (deg) from the initial position (empty on error)
+    QByteArray mesh(double angle);
+
+private:
+    Point m_center;
+    double m_radiusInner;
+    double m_radiusOuter;
+    QString m_error;
+    int m_remeshCount;
+    double m_angle;
+
+    // initial mesh, band elements are kept separately
+    QVector<Point> m_nodes;
+    QVector<bool> m_nodeRotor;
+    QVector<int> m_nodeIndex; // index in the output mesh (-1 for the nodes inside the band)
+    QVector<int> m_elements; // node, node, node, marker
+    QVector<int> m_boundaries; // node, node, marker
+    QVector<int> m_curves; // node, node
+    QVector<double> m_curvesAngle;
+    int m_bandMarker;
+
+    // band at the reference angle, nodes are indexed after the rotor and stator nodes
+    double m_bandAngle;
+    QVector<Point> m_bandNodes;
+    QVector<int> m_bandElements;
+    QVector<int> m_bandBoundary; // closed boundary of the band (segments)
+    double m_bandMinAngle; // minimal angle of the band elements at the reference angle (deg)
+
+    int m_countNodes; // rotor and stator nodes
+
+    Point rotate(const Point &point, double angle) const;
+    double minAngle(const QVector<Point> &nodes) const;
+    bool triangulate(const QVector<Point> &nodes, double angle);
+};
+
+#endif // MOVINGBAND_H
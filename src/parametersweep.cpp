@@ -0,0 +1,206 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "parametersweep.h"
+
+#include "scripteditordialog.h"
+
+SweepRun::SweepRun()
+{
+    index = -1;
+    parameters = "";
+    result = "";
+    error = "";
+    elapsedTime = 0;
+}
+
+// *********************************************************************************************
+
+ParameterSweep::ParameterSweep(const QString &script, int workers, int timeout) : QObject()
+{
+    m_script = script;
+    m_workers = (workers > 0) ? workers : QThread::idealThreadCount();
+    if (m_workers < 1) m_workers = 1;
+    m_timeout = timeout;
+
+    m_next = 0;
+    m_finished = 0;
+    m_eventLoop = NULL;
+}
+
+ParameterSweep::~ParameterSweep()
+{
+    removeDirectory(tempProblemDir() + "/sweep");
+}
+
+void ParameterSweep::appendRun(const QString &parameters)
+{
+    SweepRun sweepRun;
+    sweepRun.index = m_runs.count();
+    sweepRun.parameters = parameters;
+
+    m_runs.append(sweepRun);
+}
+
+QString ParameterSweep::runDir(int index)
+{
+    return QString("%1/sweep/%2").arg(tempProblemDir()).arg(index);
+}
+
+void ParameterSweep::run()
+{
+    if (m_runs.isEmpty())
+        return;
+
+    m_next = 0;
+    m_finished = 0;
+
+    // fill the pool
+    for (int i = 0; i < m_workers && i < m_runs.count(); i++)
+        startNext();
+
+    // wait for the last worker
+    QEventLoop eventLoop;
+    m_eventLoop = &eventLoop;
+    if (m_finished < m_runs.count())
+        eventLoop.exec();
+    m_eventLoop = NULL;
+}
+
+void ParameterSweep::startNext()
+{
+    if (m_next >= m_runs.count())
+        return;
+
+    int index = m_next++;
+    QString dir = runDir(index);
+    QDir().mkpath(dir);
+
+    // model (parameters + base script)
+    QString model = m_runs[index].parameters + "\n" + m_script + "\n";
+    writeStringContent(dir + "/model.py", &model);
+
+    // worker stores repr(result) or the traceback
+    QString worker;
+    worker += "import traceback\n";
+    worker += "try:\n";
+    worker += "    execfile(u\"" + dir + "/model.py\")\n";
+    worker += "    sweepfile = open(u\"" + dir + "/result.txt\", \"w\")\n";
+    worker += "    sweepfile.write(repr(result))\n";
+    worker += "    sweepfile.close()\n";
+    worker += "except:\n";
+    worker += "    sweepfile = open(u\"" + dir + "/error.txt\", \"w\")\n";
+    worker += "    sweepfile.write(traceback.format_exc())\n";
+    worker += "    sweepfile.close()\n";
+    writeStringContent(dir + "/worker.py", &worker);
+
+    QProcess *process = new QProcess(this);
+    process->setWorkingDirectory(dir);
+    process->setStandardOutputFile(dir + "/stdout.txt");
+    process->setStandardErrorFile(dir + "/stderr.txt");
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(doProcessFinished(int, QProcess::ExitStatus)));
+
+    m_process[process] = index;
+    QTime time;
+    time.start();
+    m_processTime[process] = time;
+
+    process->start(QApplication::applicationFilePath(), QStringList() << "-sweep" << dir + "/worker.py");
+    if (!process->waitForStarted())
+    {
+        finishRun(process, tr("Could not start worker process."));
+        return;
+    }
+
+    if (m_timeout > 0)
+    {
+        QTimer *timer = new QTimer(process);
+        timer->setSingleShot(true);
+        connect(timer, SIGNAL(timeout()), this, SLOT(doProcessTimeout()));
+        timer->start(m_timeout);
+    }
+}
+
+void ParameterSweep::doProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (!process || !m_process.contains(process))
+        return;
+
+    QString error;
+    if (exitStatus == QProcess::CrashExit)
+        error = tr("Worker process crashed.");
+    else if (exitCode != 0)
+        error = tr("Worker process exited with code %1.").arg(exitCode);
+
+    finishRun(process, error);
+}
+
+void ParameterSweep::doProcessTimeout()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender()->parent());
+    if (!process || !m_process.contains(process))
+        return;
+
+    // finished() is emitted after kill
+    disconnect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(doProcessFinished(int, QProcess::ExitStatus)));
+    process->kill();
+    process->waitForFinished();
+
+    finishRun(process, tr("Worker process timed out after %1 ms.").arg(m_timeout));
+}
+
+void ParameterSweep::finishRun(QProcess *process, const QString &error)
+{
+    int index = m_process.take(process);
+    QTime time = m_processTime.take(process);
+
+    SweepRun &sweepRun = m_runs[index];
+    sweepRun.elapsedTime = time.elapsed();
+    sweepRun.error = error;
+
+    QString dir = runDir(index);
+    if (QFile::exists(dir + "/error.txt"))
+        sweepRun.error = readFileContent(dir + "/error.txt");
+    else if (QFile::exists(dir + "/result.txt"))
+        sweepRun.result = readFileContent(dir + "/result.txt");
+    else if (sweepRun.error.isEmpty())
+        sweepRun.error = tr("Script did not set variable 'result'.");
+
+    process->deleteLater();
+    m_finished++;
+
+    // next run
+    startNext();
+
+    if (m_finished == m_runs.count() && m_eventLoop)
+        m_eventLoop->quit();
+}
+
+// *********************************************************************************************
+
+void runSweepWorker(const QString &fileName)
+{
+    ScriptResult result = runPythonScript(readFileContent(fileName), fileName);
+    if (result.isError)
+        qWarning() << result.text;
+
+    // leave the event loop as soon as it is entered
+    QTimer::singleShot(0, QApplication::instance(), SLOT(quit()));
+}
@@ -0,0 +1,85 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include "util.h"
+
+// one run of the sweep
+struct SweepRun
+{
+    int index;
+
+    // python assignments prepended to the base script
+    QString parameters;
+
+    // repr() of the variable "result" set by the script
+    QString result;
+    QString error;
+
+    // wall time of the worker process (ms)
+    int elapsedTime;
+
+    SweepRun();
+};
+
+// Runs a model script for several parameter sets in separate worker
+// processes (agros2d -sweep script.py). Every worker has its own temp
+// directory (tempProblemDir() is pid based) and its own hermes state.
+class ParameterSweep : public QObject
+{
+    Q_OBJECT
+
+public:
+    ParameterSweep(const QString &script, int workers = 0, int timeout = 0);
+    ~ParameterSweep();
+
+    void appendRun(const QString &parameters);
+    void run();
+
+    inline QList<SweepRun> runs() { return m_runs; }
+    inline int workers() { return m_workers; }
+
+private slots:
+    void doProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void doProcessTimeout();
+
+private:
+    QString m_script;
+    int m_workers;
+    int m_timeout;
+
+    QList<SweepRun> m_runs;
+    int m_next;
+    int m_finished;
+
+    QMap<QProcess *, int> m_process;
+    QMap<QProcess *, QTime> m_processTime;
+    QEventLoop *m_eventLoop;
+
+    QString runDir(int index);
+    void startNext();
+    void finishRun(QProcess *process, const QString &error);
+};
+
+// worker side, called from MainWindow for "-sweep fileName"
+void runSweepWorker(const QString &fileName);
+
+#endif // PARAMETERSWEEP_H
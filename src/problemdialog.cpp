@@ -76,6 +76,7 @@ QWidget *ProblemDialog::createControlsGeneral()
     txtNumberOfRefinements = new QSpinBox(this);
     txtNumberOfRefinements->setMinimum(0);
     txtNumberOfRefinements->setMaximum(5);
+    txtMeshGradation = new SLineEditDouble(0.3);
     txtPolynomialOrder = new QSpinBox(this);
     txtPolynomialOrder->setMinimum(1);
     txtPolynomialOrder->setMaximum(10);
@@ -93,10 +94,13 @@ QWidget *ProblemDialog::createControlsGeneral()
     txtTransientTimeStep = new SLineEditValue();
     txtTransientTimeTotal = new SLineEditValue();
     txtTransientInitialCondition = new SLineEditValue();
+    cmbTransientTimeStepMethod = new QComboBox();
+    txtTransientTimeStepTolerance = new SLineEditDouble(1);
     lblTransientSteps = new QLabel("0");
 
     connect(txtTransientTimeStep, SIGNAL(editingFinished()), this, SLOT(doTransientChanged()));
     connect(txtTransientTimeTotal, SIGNAL(editingFinished()), this, SLOT(doTransientChanged()));
+    connect(cmbTransientTimeStepMethod, SIGNAL(currentIndexChanged(int)), this, SLOT(doTransientChanged()));
 
     connect(cmbPhysicField, SIGNAL(currentIndexChanged(int)), this, SLOT(doPhysicFieldChanged(int)));
     connect(cmbAdaptivityType, SIGNAL(currentIndexChanged(int)), this, SLOT(doAdaptivityChanged(int)));
@@ -138,6 +142,8 @@ QWidget *ProblemDialog::createControlsGeneral()
     layoutProblemTable->addWidget(txtAdaptivitySteps, 8, 1);
     layoutProblemTable->addWidget(new QLabel(tr("Adaptivity tolerance (%):")), 9, 0);
     layoutProblemTable->addWidget(txtAdaptivityTolerance, 9, 1);
+    layoutProblemTable->addWidget(new QLabel(tr("Mesh gradation:")), 10, 0);
+    layoutProblemTable->addWidget(txtMeshGradation, 10, 1);
     // right
     layoutProblemTable->addWidget(new QLabel(tr("Matrix solver:")), 2, 2);
     layoutProblemTable->addWidget(cmbMatrixCommonSolverType, 2, 3);
@@ -157,8 +163,12 @@ QWidget *ProblemDialog::createControlsGeneral()
     layoutProblemTable->addWidget(txtTransientTimeTotal, 9, 3);
     layoutProblemTable->addWidget(new QLabel(tr("Initial condition:")), 10, 2);
     layoutProblemTable->addWidget(txtTransientInitialCondition, 10, 3);
-    layoutProblemTable->addWidget(new QLabel(tr("Steps:")), 11, 2);
-    layoutProblemTable->addWidget(lblTransientSteps, 11, 3);
+    layoutProblemTable->addWidget(new QLabel(tr("Time step method:")), 11, 2);
+    layoutProblemTable->addWidget(cmbTransientTimeStepMethod, 11, 3);
+    layoutProblemTable->addWidget(new QLabel(tr("Time step tolerance (%):")), 12, 2);
+    layoutProblemTable->addWidget(txtTransientTimeStepTolerance, 12, 3);
+    layoutProblemTable->addWidget(new QLabel(tr("Steps:")), 13, 2);
+    layoutProblemTable->addWidget(lblTransientSteps, 13, 3);
 
     // equation
     QHBoxLayout *layoutEquation = new QHBoxLayout();
@@ -236,6 +246,12 @@ void ProblemDialog::fillComboBox()
     cmbMatrixCommonSolverType->addItem(matrixCommonSolverTypeString(MatrixCommonSolverType_SparseLib_GeneralizedMinimumResidual), MatrixCommonSolverType_SparseLib_GeneralizedMinimumResidual);
     cmbMatrixCommonSolverType->addItem(matrixCommonSolverTypeString(MatrixCommonSolverType_SparseLib_QuasiMinimalResidual), MatrixCommonSolverType_SparseLib_QuasiMinimalResidual);
     cmbMatrixCommonSolverType->addItem(matrixCommonSolverTypeString(MatrixCommonSolverType_SparseLib_RichardsonIterativeRefinement), MatrixCommonSolverType_SparseLib_RichardsonIterativeRefinement);
+    cmbMatrixCommonSolverType->addItem(matrixCommonSolverTypeString(MatrixCommonSolverType_SaddlePoint), MatrixCommonSolverType_SaddlePoint);
+
+    // time step method
+    cmbTransientTimeStepMethod->addItem(timeStepMethodString(TimeStepMethod_Fixed), TimeStepMethod_Fixed);
+    cmbTransientTimeStepMethod->addItem(timeStepMethodString(TimeStepMethod_BDF2), TimeStepMethod_BDF2);
+    cmbTransientTimeStepMethod->addItem(timeStepMethodString(TimeStepMethod_BDF2Adaptive), TimeStepMethod_BDF2Adaptive);
 
     // linearity
     cmbLinearity->addItem(linearityString(Linearity_Linear), Linearity_Linear);
@@ -250,6 +266,7 @@ void ProblemDialog::load()
     cmbProblemType->setCurrentIndex(cmbProblemType->findData(m_problemInfo->problemType));
     dtmDate->setDate(m_problemInfo->date);
     txtNumberOfRefinements->setValue(m_problemInfo->numberOfRefinements);
+    txtMeshGradation->setValue(m_problemInfo->meshGradation);
     txtPolynomialOrder->setValue(m_problemInfo->polynomialOrder);
     cmbAdaptivityType->setCurrentIndex(cmbAdaptivityType->findData(m_problemInfo->adaptivityType));
     txtAdaptivitySteps->setValue(m_problemInfo->adaptivitySteps);
@@ -261,6 +278,8 @@ void ProblemDialog::load()
     txtTransientTimeStep->setValue(m_problemInfo->timeStep);
     txtTransientTimeTotal->setValue(m_problemInfo->timeTotal);
     txtTransientInitialCondition->setValue(m_problemInfo->initialCondition);
+    cmbTransientTimeStepMethod->setCurrentIndex(cmbTransientTimeStepMethod->findData(m_problemInfo->timeStepMethod));
+    txtTransientTimeStepTolerance->setValue(m_problemInfo->timeStepTolerance);
     // matrix solver
     cmbMatrixCommonSolverType->setCurrentIndex(cmbMatrixCommonSolverType->findData(m_problemInfo->matrixCommonSolverType));
     // linearity
@@ -294,6 +313,12 @@ bool ProblemDialog::save()
     if (this->m_isNewProblem) m_problemInfo->setHermes(hermesFieldFactory((PhysicField) cmbPhysicField->itemData(cmbPhysicField->currentIndex()).toInt()));
 
     // check values
+    if (txtMeshGradation->value() <= 0.0)
+    {
+        QMessageBox::critical(this, tr("Error"), tr("Mesh gradation must be positive."));
+        return false;
+    }
+
     if (cmbAnalysisType->itemData(cmbAnalysisType->currentIndex()).toInt() == AnalysisType_Harmonic)
     {
         if (txtFrequency->value() < 0)
@@ -323,6 +348,11 @@ bool ProblemDialog::save()
             QMessageBox::critical(this, tr("Error"), tr("Time step is greater then total time."));
             return false;
         }
+        if (txtTransientTimeStepTolerance->value() <= 0.0)
+        {
+            QMessageBox::critical(this, tr("Error"), tr("Time step tolerance must be positive."));
+            return false;
+        }
     }
 
     Util::scene()->sceneSolution()->clear();
@@ -331,6 +361,7 @@ bool ProblemDialog::save()
     m_problemInfo->name = txtName->text();
     m_problemInfo->date = dtmDate->date();
     m_problemInfo->numberOfRefinements = txtNumberOfRefinements->value();
+    m_problemInfo->meshGradation = txtMeshGradation->value();
     m_problemInfo->polynomialOrder = txtPolynomialOrder->value();
     m_problemInfo->adaptivityType = (AdaptivityType) cmbAdaptivityType->itemData(cmbAdaptivityType->currentIndex()).toInt();
     m_problemInfo->adaptivitySteps = txtAdaptivitySteps->value();
@@ -344,6 +375,8 @@ bool ProblemDialog::save()
     m_problemInfo->timeStep = txtTransientTimeStep->value();
     m_problemInfo->timeTotal = txtTransientTimeTotal->value();
     m_problemInfo->initialCondition = txtTransientInitialCondition->value();
+    m_problemInfo->timeStepMethod = (TimeStepMethod) cmbTransientTimeStepMethod->itemData(cmbTransientTimeStepMethod->currentIndex()).toInt();
+    m_problemInfo->timeStepTolerance = txtTransientTimeStepTolerance->value();
 
     // matrix solver
     m_problemInfo->matrixCommonSolverType = (MatrixCommonSolverType) cmbMatrixCommonSolverType->itemData(cmbMatrixCommonSolverType->currentIndex()).toInt();
@@ -402,6 +435,9 @@ void ProblemDialog::doAnalysisTypeChanged(int index)
     txtTransientTimeStep->setEnabled((AnalysisType) cmbAnalysisType->itemData(index).toInt() == AnalysisType_Transient);
     txtTransientTimeTotal->setEnabled((AnalysisType) cmbAnalysisType->itemData(index).toInt() == AnalysisType_Transient);
     txtTransientInitialCondition->setEnabled((AnalysisType) cmbAnalysisType->itemData(index).toInt() == AnalysisType_Transient);
+    cmbTransientTimeStepMethod->setEnabled((AnalysisType) cmbAnalysisType->itemData(index).toInt() == AnalysisType_Transient);
+    txtTransientTimeStepTolerance->setEnabled(((AnalysisType) cmbAnalysisType->itemData(index).toInt() == AnalysisType_Transient) &&
+                                              ((TimeStepMethod) cmbTransientTimeStepMethod->itemData(cmbTransientTimeStepMethod->currentIndex()).toInt() == TimeStepMethod_BDF2Adaptive));
 
     txtFrequency->setEnabled((AnalysisType) cmbAnalysisType->itemData(index).toInt() == AnalysisType_Harmonic);
 
@@ -416,8 +452,16 @@ void ProblemDialog::doLinearityChanged(int index)
 
 void ProblemDialog::doTransientChanged()
 {
-    if (txtTransientTimeStep->evaluate(true) &&
-        txtTransientTimeTotal->evaluate(true))
+    // length of the steps is controlled by the error (time step is the first step)
+    bool isAdaptive = ((TimeStepMethod) cmbTransientTimeStepMethod->itemData(cmbTransientTimeStepMethod->currentIndex()).toInt() == TimeStepMethod_BDF2Adaptive);
+    txtTransientTimeStepTolerance->setEnabled(isAdaptive && cmbTransientTimeStepMethod->isEnabled());
+
+    if (isAdaptive)
+    {
+        lblTransientSteps->setText(tr("adaptive"));
+    }
+    else if (txtTransientTimeStep->evaluate(true) &&
+             txtTransientTimeTotal->evaluate(true))
     {
         lblTransientSteps->setText(QString("%1").arg(floor(txtTransientTimeTotal->number()/txtTransientTimeStep->number())));
     }
@@ -54,6 +54,7 @@ private:
     QComboBox *cmbPhysicField;
     QDateTimeEdit *dtmDate;
     QSpinBox *txtNumberOfRefinements;
+    SLineEditDouble *txtMeshGradation;
     QSpinBox *txtPolynomialOrder;
     QComboBox *cmbAdaptivityType;
     QSpinBox *txtAdaptivitySteps;
@@ -67,6 +68,8 @@ private:
     SLineEditValue *txtTransientTimeStep;
     SLineEditValue *txtTransientTimeTotal;
     SLineEditValue *txtTransientInitialCondition;
+    QComboBox *cmbTransientTimeStepMethod;
+    SLineEditDouble *txtTransientTimeStepTolerance;
     QLabel *lblTransientSteps;
 
     // startup script
@@ -21,20 +21,22 @@
 #include "scene.h"
 #include "sceneview.h"
 
+const double ARC_CURVED_MAX_ANGLE = 30.0; // maximal angle of the curved segment (deg.)
+
 SolutionArray::SolutionArray()
 {
     sln = NULL;
-    order = NULL;
 
     time = 0.0;
     adaptiveSteps = 0;
     adaptiveError = 100.0;
+    for (int i = 0; i < 3; i++)
+        derivative[i] = 0.0;
 }
 
 SolutionArray::~SolutionArray()
 {
     if (sln) { delete sln; sln = NULL; }
-    if (order) { delete order; order = NULL; }
 }
 
 void SolutionArray::load(QDomElement *element)
@@ -52,13 +54,17 @@ void SolutionArray::load(QDomElement *element)
     contentOrder.append(element->elementsByTagName("order").at(0).toElement().childNodes().at(0).nodeValue());
     writeStringContentByteArray(fileNameOrder, QByteArray::fromBase64(contentOrder));
 
-    order = new Orderizer();
+    order = QSharedPointer<Orderizer>(new Orderizer());
     order->load_data(fileNameOrder.toStdString().c_str());
     sln = new Solution();
     sln->load(fileNameSolution.toStdString().c_str());
     adaptiveError = element->attribute("adaptiveerror").toDouble();
     adaptiveSteps = element->attribute("adaptivesteps").toInt();
     time = element->attribute("time").toDouble();
+    QStringList coeffs = element->attribute("timederivative").split(" ", QString::SkipEmptyParts);
+    if (coeffs.count() == 3)
+        for (int i = 0; i < 3; i++)
+            derivative[i] = coeffs.at(i).toDouble();
 
     // delete solution
     QFile::remove(fileNameSolution);
@@ -86,6 +92,11 @@ void SolutionArray::save(QDomDocument *doc, QDomElement *element)
     element->setAttribute("adaptiveerror", adaptiveError);
     element->setAttribute("adaptivesteps", adaptiveSteps);
     element->setAttribute("time", time);
+    // full precision, the coefficients of the constant solution cancel
+    element->setAttribute("timederivative", QString("%1 %2 %3").
+                          arg(derivative[0], 0, 'e', 16).
+                          arg(derivative[1], 0, 'e', 16).
+                          arg(derivative[2], 0, 'e', 16));
     element->appendChild(eleSolution);
     element->appendChild(eleOrder);
 
@@ -121,27 +132,27 @@ ProgressItemMesh::ProgressItemMesh() : ProgressItem()
 
 bool ProgressItemMesh::run()
 {
-    QFile::remove(tempProblemFileName() + ".mesh");
+    removeScratchContent("mesh");
+
+    SolverInfo &solverInfo = Util::scene()->sceneSolution()->solverInfo();
+    solverInfo.start("mesh");
 
     // create triangle files
     if (writeToTriangle())
     {
         emit message(tr("Poly file was created"), false, 1);
 
+        // stopped in meshTriangleCreated()
+        solverInfo.start("triangle");
+
         // exec triangle
         QProcess processTriangle;
         processTriangle.setStandardOutputFile(tempProblemFileName() + ".triangle.out");
         processTriangle.setStandardErrorFile(tempProblemFileName() + ".triangle.err");
         connect(&processTriangle, SIGNAL(finished(int)), this, SLOT(meshTriangleCreated(int)));
 
-        QString triangleBinary = "triangle";
-        if (QFile::exists(QApplication::applicationDirPath() + QDir::separator() + "triangle.exe"))
-            triangleBinary = "\"" + QApplication::applicationDirPath() + QDir::separator() + "triangle.exe\"";
-        if (QFile::exists(QApplication::applicationDirPath() + QDir::separator() + "triangle"))
-            triangleBinary = QApplication::applicationDirPath() + QDir::separator() + "triangle";
-
         processTriangle.start(QString(Util::config()->commandTriangle).
-                              arg(triangleBinary).
+                              arg(triangleBinary()).
                               arg(tempProblemFileName()));
 
         if (!processTriangle.waitForStarted())
@@ -149,6 +160,8 @@ bool ProgressItemMesh::run()
             emit message(tr("Could not start Triangle"), true, 0);
             processTriangle.kill();
 
+            solverInfo.stop();
+            solverInfo.stop();
             return !m_isError;
         }
 
@@ -166,17 +179,25 @@ bool ProgressItemMesh::run()
         while (!processTriangle.waitForFinished()) {}
     }
 
+    solverInfo.stop();
     return !m_isError;
 }
 
 void ProgressItemMesh::meshTriangleCreated(int exitCode)
 {
+    SolverInfo &solverInfo = Util::scene()->sceneSolution()->solverInfo();
+    solverInfo.stop();
+
     if (exitCode == 0)
     {
         emit message(tr("Mesh files was created"), false, 2);
 
         // convert triangle mesh to hermes mesh
-        if (triangleToHermes2D())
+        solverInfo.start("conversion");
+        bool isConverted = triangleToHermes2D();
+        solverInfo.stop();
+
+        if (isConverted)
         {
             emit message(tr("Mesh was converted to Hermes2D mesh file"), false, 3);
 
@@ -185,7 +206,7 @@ void ProgressItemMesh::meshTriangleCreated(int exitCode)
             {
                 QFileInfo fileInfoOrig(Util::scene()->problemInfo()->fileName);
 
-                QFile::copy(tempProblemFileName() + ".mesh", fileInfoOrig.absolutePath() + "/" + fileInfoOrig.baseName() + ".mesh");
+                writeStringContentByteArray(fileInfoOrig.absolutePath() + "/" + fileInfoOrig.baseName() + ".mesh", readScratchContent("mesh"));
             }
 
             //  remove triangle temp files
@@ -198,7 +219,7 @@ void ProgressItemMesh::meshTriangleCreated(int exitCode)
             emit message(tr("Mesh files was deleted"), false, 4);
 
             // load mesh
-            Mesh *mesh = readMeshFromFile(tempProblemFileName() + ".mesh");
+            Mesh *mesh = readMeshFromString(readScratchContent("mesh"));
 
             // check that all boundary edges have a marker assigned
             for (int i = 0; i < mesh->get_max_node_id(); i++)
@@ -318,6 +339,15 @@ bool ProgressItemMesh::writeToTriangle()
         nodesCount++;
     }
 
+    // element size required by the labels (curved arcs)
+    double elementSize = 0.0;
+    for (int i = 0; i<Util::scene()->labels.count(); i++)
+    {
+        double area = Util::scene()->labels[i]->area;
+        if (area > 0.0 && (elementSize == 0.0 || sqrt(4.0 * area / sqrt(3.0)) < elementSize))
+            elementSize = sqrt(4.0 * area / sqrt(3.0));
+    }
+
     // edges
     QString outEdges;
     int edgesCount = 0;
@@ -326,12 +356,40 @@ bool ProgressItemMesh::writeToTriangle()
         if (Util::scene()->edges[i]->angle == 0)
         {
             // line
-            outEdges += QString("%1  %2  %3  %4\n").
-                        arg(edgesCount).
-                        arg(Util::scene()->nodes.indexOf(Util::scene()->edges[i]->nodeStart)).
-                        arg(Util::scene()->nodes.indexOf(Util::scene()->edges[i]->nodeEnd)).
-                        arg(i+1);
-            edgesCount++;
+            // split to the segments given by the mesh size
+            Point start = Util::scene()->edges[i]->nodeStart->point;
+            Point end = Util::scene()->edges[i]->nodeEnd->point;
+            int segments = 1;
+            if (Util::scene()->edges[i]->meshSize > 0.0)
+                segments = qMax(1, int(ceil((end - start).magnitude() / Util::scene()->edges[i]->meshSize)));
+
+            int nodeStartIndex = Util::scene()->nodes.indexOf(Util::scene()->edges[i]->nodeStart);
+            int nodeEndIndex = 0;
+            for (int j = 0; j < segments; j++)
+            {
+                if (j == segments - 1)
+                {
+                    nodeEndIndex = Util::scene()->nodes.indexOf(Util::scene()->edges[i]->nodeEnd);
+                }
+                else
+                {
+                    Point point = start + (end - start) * (double(j + 1) / segments);
+                    outNodes += QString("%1  %2  %3  %4\n").
+                                arg(nodesCount).
+                                arg(point.x, 0, 'f', 10).
+                                arg(point.y, 0, 'f', 10).
+                                arg(0);
+                    nodeEndIndex = nodesCount;
+                    nodesCount++;
+                }
+                outEdges += QString("%1  %2  %3  %4\n").
+                            arg(edgesCount).
+                            arg(nodeStartIndex).
+                            arg(nodeEndIndex).
+                            arg(i+1);
+                edgesCount++;
+                nodeStartIndex = nodeEndIndex;
+            }
         }
         else
         {
@@ -341,8 +399,28 @@ bool ProgressItemMesh::writeToTriangle()
             double radius = Util::scene()->edges[i]->radius();
             double startAngle = atan2(center.y - Util::scene()->edges[i]->nodeStart->point.y,
                                       center.x - Util::scene()->edges[i]->nodeStart->point.x) - M_PI;
-            int segments = Util::scene()->edges[i]->angle/5.0 + 1;
-            if (segments < Util::config()->angleSegmentsCount) segments = Util::config()->angleSegmentsCount; // minimum segments
+            int segments = 0;
+            if (Util::config()->curvilinearElements)
+            {
+                // arc is exported as curved edges (see triangleToHermes2D()), the polygon
+                // only has to be close enough to the arc to keep the elements valid
+                segments = ceil(Util::scene()->edges[i]->angle / ARC_CURVED_MAX_ANGLE);
+                if (elementSize > 0.0 && elementSize < 4.0 * radius)
+                {
+                    // sagitta of the segment is smaller than quarter of the element size
+                    double theta = 2.0 * acos(1.0 - 0.25 * elementSize / radius);
+                    segments = qMax(segments, int(ceil(deg2rad(Util::scene()->edges[i]->angle) / theta)));
+                }
+            }
+            else
+            {
+                segments = Util::scene()->edges[i]->angle/5.0 + 1;
+                if (segments < Util::config()->angleSegmentsCount) segments = Util::config()->angleSegmentsCount; // minimum segments
+            }
+
+            // mesh size of the edge
+            if (Util::scene()->edges[i]->meshSize > 0.0)
+                segments = qMax(segments, int(ceil(radius * deg2rad(Util::scene()->edges[i]->angle) / Util::scene()->edges[i]->meshSize)));
 
             double theta = deg2rad(Util::scene()->edges[i]->angle) / double(segments);
 
@@ -442,14 +520,6 @@ bool ProgressItemMesh::triangleToHermes2D()
     char *plocale = setlocale (LC_NUMERIC, "");
     setlocale (LC_NUMERIC, "C");
 
-    QFile fileMesh(tempProblemFileName() + ".mesh");
-    if (!fileMesh.open(QIODevice::WriteOnly))
-    {
-        emit message(tr("Could not create Hermes2D mesh file"), true, 0);
-        return false;
-    }
-    QTextStream outMesh(&fileMesh);
-
     QFile fileNode(tempProblemFileName() + ".node");
     if (!fileNode.open(QIODevice::ReadOnly | QIODevice::Text))
     {
@@ -475,22 +545,20 @@ bool ProgressItemMesh::triangleToHermes2D()
     QTextStream inEle(&fileEle);
 
     // nodes
-    QString outNodes;
-    outNodes += "vertices = \n";
-    outNodes += "{ \n";
+    QVector<Point> nodeList;
     sscanf(inNode.readLine().toStdString().c_str(), "%i", &k);
     for (int i = 0; i<k; i++)
     {
         sscanf(inNode.readLine().toStdString().c_str(), "%i   %lf %lf %i", &n, &x, &y, &marker);
-        outNodes += QString("\t{ %1,  %2 }, \n").arg(x, 0, 'f', 10).arg(y, 0, 'f', 10);
+        nodeList.append(Point(x, y));
     }
-    outNodes.truncate(outNodes.length()-3);
-    outNodes += "\n} \n\n";
 
-    // edges and curves
+    // edges
     QString outEdges;
     outEdges += "boundaries = \n";
     outEdges += "{ \n";
+    QList<QPair<int, int> > arcEdges;
+    QList<int> arcMarkers;
     sscanf(inEdge.readLine().toStdString().c_str(), "%i", &k);
     count = 0;
     for (int i = 0; i<k; i++)
@@ -503,6 +571,13 @@ bool ProgressItemMesh::triangleToHermes2D()
                 count++;
                 outEdges += QString("\t{ %1, %2, %3 }, \n").arg(node_1).arg(node_2).arg(abs(marker));
             }
+
+            // part of the arc (boundary or interface)
+            if (Util::config()->curvilinearElements && Util::scene()->edges[marker-1]->angle != 0)
+            {
+                arcEdges.append(QPair<int, int>(node_1, node_2));
+                arcMarkers.append(marker);
+            }
         }
     }
     outEdges.truncate(outEdges.length()-3);
@@ -517,6 +592,8 @@ bool ProgressItemMesh::triangleToHermes2D()
     QString outElements;
     outElements += "elements = \n";
     outElements += "{ \n";
+    QVector<int> elementNodes;
+    QVector<QList<int> > nodeElements(nodeList.count());
     sscanf(inEle.readLine().toStdString().c_str(), "%i", &k);
     count = 0;
     for (int i = 0; i<k; i++)
@@ -531,6 +608,11 @@ bool ProgressItemMesh::triangleToHermes2D()
         // triangle returns zero region number for areas without marker, markers must start from 1
         marker--;
         outElements += QString("\t{ %1, %2, %3, %4  }, \n").arg(node_1).arg(node_2).arg(node_3).arg(abs(marker));
+
+        elementNodes << node_1 << node_2 << node_3;
+        nodeElements[node_1].append(i);
+        nodeElements[node_2].append(i);
+        nodeElements[node_3].append(i);
     }
     outElements.truncate(outElements.length()-3);
     outElements += "\n} \n\n";
@@ -540,17 +622,93 @@ bool ProgressItemMesh::triangleToHermes2D()
         return false;
     }
 
-    outMesh << outNodes;
-    outMesh << outElements;
-    outMesh << outEdges;
+    // curved edges - nodes inserted by Triangle lie on the chords, they are moved to the arc
+    QVector<bool> nodeStraight(nodeList.count(), false);
+    for (int i = 0; i < arcEdges.count(); i++)
+    {
+        SceneEdge *edge = Util::scene()->edges[arcMarkers[i]-1];
+        Point center = edge->center();
+        double radius = edge->radius();
+
+        int nodes[2] = { arcEdges[i].first, arcEdges[i].second };
+        for (int j = 0; j < 2; j++)
+        {
+            Point point = nodeList[nodes[j]];
+            double distance = (point - center).magnitude();
+            if (nodeStraight[nodes[j]] || fabs(distance - radius) < EPS_ZERO * radius)
+                continue;
+
+            Point pointArc = center + (point - center) * (radius / distance);
+
+            // the elements must not be inverted
+            bool isValid = true;
+            foreach (int element, nodeElements[nodes[j]])
+            {
+                Point p[3];
+                for (int l = 0; l < 3; l++)
+                    p[l] = (elementNodes[3*element + l] == nodes[j]) ? pointArc : nodeList[elementNodes[3*element + l]];
+
+                if ((p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y) <= 0.0)
+                {
+                    isValid = false;
+                    break;
+                }
+            }
+
+            if (isValid)
+                nodeList[nodes[j]] = pointArc;
+            else
+                nodeStraight[nodes[j]] = true;
+        }
+    }
+
+    QString outCurves;
+    outCurves += "curves = \n";
+    outCurves += "{ \n";
+    count = 0;
+    for (int i = 0; i < arcEdges.count(); i++)
+    {
+        node_1 = arcEdges[i].first;
+        node_2 = arcEdges[i].second;
+        if (nodeStraight[node_1] || nodeStraight[node_2])
+            continue;
+
+        // counterclockwise angle of the part of the arc
+        Point center = Util::scene()->edges[arcMarkers[i]-1]->center();
+        double angle = (nodeList[node_2] - center).angle() - (nodeList[node_1] - center).angle();
+        while (angle > M_PI) angle -= 2.0*M_PI;
+        while (angle <= -M_PI) angle += 2.0*M_PI;
+        if (angle < 0.0)
+        {
+            std::swap(node_1, node_2);
+            angle = -angle;
+        }
+        if (angle < EPS_ZERO)
+            continue;
+
+        count++;
+        outCurves += QString("\t{ %1, %2, %3 }, \n").arg(node_1).arg(node_2).arg(angle / M_PI * 180.0, 0, 'f', 10);
+    }
+    outCurves.truncate(outCurves.length()-3);
+    outCurves += "\n} \n\n";
+    if (count == 0)
+        outCurves.clear();
+
+    QString outNodes;
+    outNodes += "vertices = \n";
+    outNodes += "{ \n";
+    for (int i = 0; i<nodeList.count(); i++)
+        outNodes += QString("\t{ %1,  %2 }, \n").arg(nodeList[i].x, 0, 'f', 10).arg(nodeList[i].y, 0, 'f', 10);
+    outNodes.truncate(outNodes.length()-3);
+    outNodes += "\n} \n\n";
+
+    // hermes mesh is kept in memory
+    writeScratchContent("mesh", QString(outNodes + outElements + outEdges + outCurves).toAscii());
 
     fileNode.close();
     fileEdge.close();
     fileEle.close();
 
-    fileMesh.waitForBytesWritten(0);
-    fileMesh.close();
-
     // set system locale
     setlocale(LC_NUMERIC, plocale);
 
@@ -559,9 +717,10 @@ bool ProgressItemMesh::triangleToHermes2D()
 
 // *********************************************************************************************
 
-ProgressItemSolve::ProgressItemSolve() : ProgressItem()
+ProgressItemSolve::ProgressItemSolve(bool isResume) : ProgressItem()
 {
     m_name = tr("Solver");
+    m_isResume = isResume;
     m_steps = 1;
     if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
         m_steps += floor(Util::scene()->problemInfo()->timeTotal.number / Util::scene()->problemInfo()->timeStep.number);
@@ -580,13 +739,16 @@ void ProgressItemSolve::solve()
 
     qDebug() << "ProgressItemSolve::solve()";
 
-    if (!QFile::exists(tempProblemFileName() + ".mesh"))
+    if (!scratchContains("mesh"))
         return;
 
     // benchmark
     QTime time;
     time.start();
 
+    SolverInfo &solverInfo = Util::scene()->sceneSolution()->solverInfo();
+    solverInfo.start("solve");
+
     emit message(tr("Solver was started: %1 (%2, %3)").
                  arg(physicFieldString(Util::scene()->problemInfo()->physicField())).
                  arg(problemTypeString(Util::scene()->problemInfo()->problemType)).
@@ -608,6 +770,9 @@ void ProgressItemSolve::solve()
         Util::scene()->sceneSolution()->setTimeElapsed(0);
     }
 
+    solverInfo.stop();
+    solverInfo.setCounter("memory peak [MB]", peakMemoryUsage());
+
     Util::scene()->sceneSolution()->setSolutionArrayList(solutionArrayList);
 }
 
@@ -617,14 +782,18 @@ ProgressItemProcessView::ProgressItemProcessView() : ProgressItem()
 {
     m_name = tr("View");
 
+    // cached views are not counted
     m_steps = 0;
-    if (sceneView()->sceneViewSettings().showContours == 1)
+    if (sceneView()->sceneViewSettings().showContours == 1 &&
+        !Util::scene()->sceneSolution()->isViewCached(ViewCacheType_Contour))
         m_steps += 1;
-    if (sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView ||
-        sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView3D ||
-        sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView3DSolid)
+    if ((sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView ||
+         sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView3D ||
+         sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView3DSolid) &&
+        !Util::scene()->sceneSolution()->isViewCached(ViewCacheType_Scalar))
         m_steps += 1;
-    if (sceneView()->sceneViewSettings().showVectors == 1)
+    if (sceneView()->sceneViewSettings().showVectors == 1 &&
+        !Util::scene()->sceneSolution()->isViewCached(ViewCacheType_Vector))
         m_steps += 1;
 }
 
@@ -641,22 +810,31 @@ void ProgressItemProcessView::process()
 
     if (sceneView()->sceneViewSettings().showContours == 1)
     {
-        step++;
-        emit message(tr("Processing countour view cache"), false, step);
+        if (!Util::scene()->sceneSolution()->isViewCached(ViewCacheType_Contour))
+        {
+            step++;
+            emit message(tr("Processing countour view cache"), false, step);
+        }
         Util::scene()->sceneSolution()->processRangeContour();
     }
     if (sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView ||
         sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView3D ||
         sceneView()->sceneViewSettings().postprocessorShow == SceneViewPostprocessorShow_ScalarView3DSolid)
     {
-        step++;
-        emit message(tr("Processing scalar view cache"), false, step);
+        if (!Util::scene()->sceneSolution()->isViewCached(ViewCacheType_Scalar))
+        {
+            step++;
+            emit message(tr("Processing scalar view cache"), false, step);
+        }
         Util::scene()->sceneSolution()->processRangeScalar();
     }
     if (sceneView()->sceneViewSettings().showVectors == 1)
     {
-        step++;
-        emit message(tr("Processing vector view cache"), false, step);
+        if (!Util::scene()->sceneSolution()->isViewCached(ViewCacheType_Vector))
+        {
+            step++;
+            emit message(tr("Processing vector view cache"), false, step);
+        }
         Util::scene()->sceneSolution()->processRangeVector();
     }
 }
@@ -891,6 +1069,14 @@ void ProgressDialog::start()
         }
     }
 
+    // phases and counters of the solve (saved in the progress log)
+    if (!Util::scene()->sceneSolution()->solverInfo().phases().isEmpty())
+    {
+        lstMessage->setTextColor(QColor(Qt::darkGray));
+        lstMessage->insertPlainText(tr("Solver info:\n") + Util::scene()->sceneSolution()->solverInfo().toString());
+        lstMessage->ensureCursorVisible();
+    }
+
     // successfull run
     if (!Util::config()->showConvergenceChart ||
         Util::scene()->problemInfo()->adaptivityType == AdaptivityType_None ||
@@ -36,9 +36,13 @@ struct SolutionArray
     double time;
     double adaptiveError;
     int adaptiveSteps;
+    // time derivative of the step (the same formula as the time stepping method)
+    //   du/dt = derivative[0] u(n) + derivative[1] u(n-1) + derivative[2] u(n-2)
+    double derivative[3];
 
     Solution *sln;
-    Orderizer *order;
+    // shared by the time steps with the same space
+    QSharedPointer<Orderizer> order;
 
     SolutionArray();
     ~SolutionArray();
@@ -95,9 +99,11 @@ class ProgressItemSolve : public ProgressItem
     Q_OBJECT
 
 public:
-    ProgressItemSolve();
+    ProgressItemSolve(bool isResume = false);
 
     bool run();
+    // continue from the checkpoint (transient)
+    inline bool isResume() { return m_isResume; }
     inline void addAdaptivityError(double error, int dof) { m_adaptivityError.append(error); m_adaptivityDOF.append(dof); emit changed(); }
     inline QList<double> adaptivityError() { return m_adaptivityError; }
     inline QList<int> adaptivityDOF() { return m_adaptivityDOF; }
@@ -109,6 +115,7 @@ private slots:
 private:
     QList<double> m_adaptivityError;
     QList<int> m_adaptivityDOF;
+    bool m_isResume;
 };
 
 class ProgressItemProcessView : public ProgressItem
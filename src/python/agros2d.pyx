@@ -22,9 +22,12 @@ cdef extern from "../scripteditorcommandpython.h":
                            char *analysistype, double timestep, double totaltime, double initialcondition) except +
     void pythonOpenDocument(char *str) except +
     void pythonSaveDocument(char *str) except +
+    void pythonDiscretization(int numberofrefinements, int polynomialorder) except +
+    void pythonTimeStepMethod(char *method, double tolerance) except +
+    void pythonMatrixSolver(char *solver) except +
     
     void pythonAddNode(double x, double y) except +
-    void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, char *marker) except +
+    void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, char *marker, double meshSize) except +
     void pythonAddLabel(double x, double y, double area, int polynomialOrder, char *marker) except +
 
     void pythonDeleteNode(int index) except +
@@ -34,6 +37,9 @@ cdef extern from "../scripteditorcommandpython.h":
     void pythonDeleteLabel(int index) except +
     void pythonDeleteLabelPoint(double x, double y)
 
+    void pythonBeginBatch()
+    void pythonCommitBatch() except +
+
     void pythonSelectNone()
     void pythonSelectAll()
 
@@ -48,6 +54,9 @@ cdef extern from "../scripteditorcommandpython.h":
 
     void pythonMesh()
     void pythonSolve()
+    void pythonSolveResume() except +
+    void pythonMovingBand(double x, double y, double radiusInner, double radiusOuter) except +
+    int pythonSolveRotor(double angle) except +
 
     void pythonZoomBestFit()
     void pythonZoomIn()
@@ -68,6 +77,7 @@ cdef extern from "../scripteditorcommandpython.h":
     void pythonSetTimeStep(int timestep) except +
     int pythonTimeStepCount()
     void pythonSaveImage(char *str, int w, int h) except +
+    void pythonSaveContours(char *str) except +
 
 # system
 
@@ -108,13 +118,22 @@ def opendocument(char *str):
 def savedocument(char *str):
     pythonSaveDocument(str)
 
+def discretization(int numberofrefinements, int polynomialorder):
+    pythonDiscretization(numberofrefinements, polynomialorder)
+
+def timestepmethod(char *method, double tolerance = 1.0):
+    pythonTimeStepMethod(method, tolerance)
+
+def matrixsolver(char *solver):
+    pythonMatrixSolver(solver)
+
 # preprocessor
 
 def addnode(double x, double y):
     pythonAddNode(x, y)
 
-def addedge(double x1, double y1, double x2, double y2, double angle = 0, char *marker = "none"):
-    pythonAddEdge(x1, y1, x2, y2, angle, marker)
+def addedge(double x1, double y1, double x2, double y2, double angle = 0, char *marker = "none", double meshsize = 0):
+    pythonAddEdge(x1, y1, x2, y2, angle, marker, meshsize)
 
 def addlabel(double x, double y, double area = 0, int polynomialorder = 0, char *marker = "none"):
     pythonAddLabel(x, y, area, polynomialorder, marker)
@@ -137,6 +156,12 @@ def deletelabel(int index):
 def deletelabelpoint(double x, double y):
     pythonDeleteLabelPoint(x, y)
 
+def beginbatch():
+    pythonBeginBatch()
+
+def commitbatch():
+    pythonCommitBatch()
+
 def selectnone():
     pythonSelectNone()
 
@@ -172,6 +197,15 @@ def mesh():
 def solve():
     pythonSolve()
 
+def resume():
+    pythonSolveResume()
+
+def movingband(double x, double y, double rinner, double router):
+    pythonMovingBand(x, y, rinner, router)
+
+def solverotor(double angle):
+    return pythonSolveRotor(angle)
+
 # postprocessor
     
 def zoombestfit():
@@ -222,3 +256,6 @@ def timestepcount():
 def saveimage(char *str, int w = 0, int h = 0):
     pythonSaveImage(str, w, h)
 
+def savecontours(char *str):
+    pythonSaveContours(str)
+
@@ -0,0 +1,324 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "scalarviewtiles.h"
+
+#include "scene.h"
+#include "hermes2d/hermes_field.h"
+
+const int TILES_COUNT = 8; // tiles in one direction
+const int TILES_MAX_LEVEL = 4;
+const int TILES_MAX_TRIANGLES = 2000000; // memory budget of the refined tiles
+const int TILES_BASE = -2; // running job of the base linearization
+
+// parameters of the linearization of one tile (the whole domain without the mask)
+struct ScalarViewTileJob
+{
+    QVector<bool> mask;
+    QVector<int> groups;
+    double eps;
+    double borderEps;
+    double maxAbs;
+};
+
+// runs in a worker thread on a clone of the filter, the borders of the tiles are
+// subdivided with the global tolerance and range by all linearizations (no cracks)
+static Linearizer *linearizeTile(MeshFunction *filter, ScalarViewTileJob job)
+{
+    Linearizer *linearizer = new Linearizer();
+    linearizer->set_element_mask(job.mask.isEmpty() ? NULL : job.mask.constData());
+    linearizer->set_element_groups(job.groups.constData(), job.borderEps);
+    linearizer->process_solution(filter, H2D_FN_VAL_0, job.eps, job.maxAbs);
+    linearizer->set_element_mask(NULL);
+    linearizer->set_element_groups(NULL, 0.0);
+
+    delete filter;
+    return linearizer;
+}
+
+ScalarViewTile::ScalarViewTile()
+{
+    level = 0;
+    linearizer = NULL;
+    lastUsed = 0;
+}
+
+// *********************************************************************************************
+
+ScalarViewTiles::ScalarViewTiles() : QObject()
+{
+    m_filter = NULL;
+    m_maxAbs = 0.0;
+    m_eps = 0.0;
+    m_domainSize = 0.0;
+    m_base = NULL;
+    m_level = 0;
+    m_used = 0;
+    m_running = -1;
+    m_runningLevel = 0;
+
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(doTileFinished()));
+}
+
+ScalarViewTiles::~ScalarViewTiles()
+{
+    clear();
+}
+
+void ScalarViewTiles::clear()
+{
+    // running job uses the mask of the tile
+    if (m_running != -1)
+    {
+        m_watcher.waitForFinished();
+        delete m_watcher.result();
+        m_running = -1;
+    }
+
+    for (int i = 0; i < m_tiles.count(); i++)
+    {
+        if (m_tiles[i]->linearizer)
+            delete m_tiles[i]->linearizer;
+        delete m_tiles[i];
+    }
+    m_tiles.clear();
+    m_elementTile.clear();
+
+    if (m_base)
+    {
+        delete m_base;
+        m_base = NULL;
+    }
+
+    m_filter = NULL;
+    m_level = 0;
+}
+
+void ScalarViewTiles::setFilter(ViewScalarFilter *filter, double maxAbs, double eps)
+{
+    clear();
+
+    // deformed shape is not supported
+    if (!filter || Util::scene()->problemInfo()->physicField() == PhysicField_Elasticity)
+        return;
+
+    // clone is used in the worker thread
+    MeshFunction *test = filter->clone();
+    if (!test)
+        return;
+    delete test;
+
+    Mesh *mesh = filter->get_mesh();
+
+    // straight triangles only (see Linearizer::can_prefetch())
+    double minX =  CONST_DOUBLE;
+    double maxX = -CONST_DOUBLE;
+    double minY =  CONST_DOUBLE;
+    double maxY = -CONST_DOUBLE;
+
+    Element *e;
+    for_all_active_elements(e, mesh)
+    {
+        if (!e->is_triangle() || e->is_curved())
+            return;
+
+        for (int i = 0; i < e->get_num_surf(); i++)
+        {
+            minX = qMin(minX, e->vn[i]->x);
+            maxX = qMax(maxX, e->vn[i]->x);
+            minY = qMin(minY, e->vn[i]->y);
+            maxY = qMax(maxY, e->vn[i]->y);
+        }
+    }
+
+    m_filter = filter;
+    m_maxAbs = maxAbs;
+    m_eps = eps;
+    m_domainSize = qMax(maxX - minX, maxY - minY);
+
+    double dx = (maxX - minX) / TILES_COUNT;
+    double dy = (maxY - minY) / TILES_COUNT;
+    for (int j = 0; j < TILES_COUNT; j++)
+    {
+        for (int i = 0; i < TILES_COUNT; i++)
+        {
+            ScalarViewTile *tile = new ScalarViewTile();
+            tile->rect.set(Point(minX + i*dx, minY + j*dy), Point(minX + (i+1)*dx, minY + (j+1)*dy));
+            tile->mask.fill(false, mesh->get_max_element_id());
+            m_tiles.append(tile);
+        }
+    }
+
+    // element belongs to the tile with its centroid
+    m_elementTile.fill(-1, mesh->get_max_element_id());
+    for_all_active_elements(e, mesh)
+    {
+        double x = (e->vn[0]->x + e->vn[1]->x + e->vn[2]->x) / 3.0;
+        double y = (e->vn[0]->y + e->vn[1]->y + e->vn[2]->y) / 3.0;
+
+        int i = (dx > 0.0) ? qBound(0, int((x - minX) / dx), TILES_COUNT - 1) : 0;
+        int j = (dy > 0.0) ? qBound(0, int((y - minY) / dy), TILES_COUNT - 1) : 0;
+
+        m_elementTile[e->id] = j*TILES_COUNT + i;
+        m_tiles[j*TILES_COUNT + i]->mask[e->id] = true;
+    }
+}
+
+int ScalarViewTiles::level(double pixelSize)
+{
+    // the global linearization resolves approximately 1/1000 of the domain
+    if (pixelSize <= 0.0 || m_domainSize <= 0.0)
+        return 0;
+
+    return qBound(0, int(floor(log(m_domainSize / (pixelSize * 1000.0)) / log(2.0))), TILES_MAX_LEVEL);
+}
+
+void ScalarViewTiles::setViewport(const RectPoint &viewport, double pixelSize)
+{
+    if (m_tiles.isEmpty())
+        return;
+
+    m_viewport = viewport;
+    m_level = level(pixelSize);
+    m_used++;
+
+    startNext();
+}
+
+static bool intersects(const RectPoint &a, const RectPoint &b)
+{
+    return !(a.end.x < b.start.x || b.end.x < a.start.x || a.end.y < b.start.y || b.end.y < a.start.y);
+}
+
+void ScalarViewTiles::startNext()
+{
+    if (m_running != -1 || m_level == 0)
+        return;
+
+    // the base linearization is the first job (the global one does not know the tiles)
+    if (!m_base)
+    {
+        start(TILES_BASE, QVector<bool>(), m_eps);
+        return;
+    }
+
+    // nearest visible tile with lower level
+    Point center((m_viewport.start.x + m_viewport.end.x) / 2.0, (m_viewport.start.y + m_viewport.end.y) / 2.0);
+
+    int next = -1;
+    double distance = CONST_DOUBLE;
+    for (int i = 0; i < m_tiles.count(); i++)
+    {
+        ScalarViewTile *tile = m_tiles[i];
+        if (!intersects(tile->rect, m_viewport))
+            continue;
+
+        tile->lastUsed = m_used;
+        if (tile->level >= m_level)
+            continue;
+
+        Point tileCenter((tile->rect.start.x + tile->rect.end.x) / 2.0, (tile->rect.start.y + tile->rect.end.y) / 2.0);
+        double dist = (tileCenter - center).magnitude();
+        if (dist < distance)
+        {
+            distance = dist;
+            next = i;
+        }
+    }
+
+    if (next == -1)
+        return;
+
+    m_runningLevel = m_level;
+    start(next, m_tiles[next]->mask, m_eps / (1 << m_level));
+}
+
+void ScalarViewTiles::start(int running, const QVector<bool> &mask, double eps)
+{
+    MeshFunction *filter = m_filter->clone();
+    if (!filter)
+        return;
+
+    ScalarViewTileJob job;
+    job.mask = mask;
+    job.groups = m_elementTile;
+    job.eps = eps;
+    job.borderEps = m_eps;
+    job.maxAbs = m_maxAbs;
+
+    m_running = running;
+    m_watcher.setFuture(QtConcurrent::run(linearizeTile, filter, job));
+}
+
+void ScalarViewTiles::doTileFinished()
+{
+    if (m_running == -1)
+        return;
+
+    if (m_running == TILES_BASE)
+    {
+        m_base = m_watcher.result();
+        m_running = -1;
+
+        startNext();
+        return;
+    }
+
+    ScalarViewTile *tile = m_tiles[m_running];
+    if (tile->linearizer)
+        delete tile->linearizer;
+    tile->linearizer = m_watcher.result();
+    tile->level = m_runningLevel;
+    m_running = -1;
+
+    reduceMemory();
+
+    emit refined();
+
+    startNext();
+}
+
+void ScalarViewTiles::reduceMemory()
+{
+    int triangles = 0;
+    for (int i = 0; i < m_tiles.count(); i++)
+        if (m_tiles[i]->linearizer)
+            triangles += m_tiles[i]->linearizer->get_num_triangles();
+
+    // drop the least recently used tiles outside of the viewport
+    while (triangles > TILES_MAX_TRIANGLES)
+    {
+        ScalarViewTile *oldest = NULL;
+        for (int i = 0; i < m_tiles.count(); i++)
+        {
+            ScalarViewTile *tile = m_tiles[i];
+            if (tile->linearizer && tile->lastUsed < m_used)
+                if (!oldest || tile->lastUsed < oldest->lastUsed)
+                    oldest = tile;
+        }
+
+        if (!oldest)
+            break;
+
+        triangles -= oldest->linearizer->get_num_triangles();
+        delete oldest->linearizer;
+        oldest->linearizer = NULL;
+        oldest->level = 0;
+    }
+}
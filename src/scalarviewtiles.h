@@ -0,0 +1,99 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SCALARVIEWTILES_H
+#define SCALARVIEWTILES_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+class ViewScalarFilter;
+
+// part of the domain (elements with the centroid in rect)
+struct ScalarViewTile
+{
+    RectPoint rect;
+    QVector<bool> mask;
+
+    // refinement level of the linearization (0 = global scalar view)
+    int level;
+    Linearizer *linearizer;
+    int lastUsed;
+
+    ScalarViewTile();
+};
+
+// View dependent refinement of the scalar view. The domain is split into
+// tiles, tiles in the viewport are linearized in the background with the
+// tolerance given by the size of a pixel, the others stay as they are.
+// The edges between the tiles are subdivided with the tolerance of the global
+// linearization (Linearizer::set_element_groups()), the coarse triangles are drawn
+// from the base linearization with the same rule while the tiles are refined.
+class ScalarViewTiles : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScalarViewTiles();
+    ~ScalarViewTiles();
+
+    void clear();
+    void setFilter(ViewScalarFilter *filter, double maxAbs, double eps);
+    void setViewport(const RectPoint &viewport, double pixelSize);
+
+    inline bool isEmpty() { return m_tiles.isEmpty(); }
+    inline int count() { return m_tiles.count(); }
+    inline ScalarViewTile *tile(int index) { return m_tiles[index]; }
+    // global linearization with the tile borders (NULL until a tile is refined)
+    inline Linearizer *base() { return m_base; }
+
+    // element is drawn from a refined tile
+    inline bool isRefined(int element) { return (element >= 0 && element < m_elementTile.count() && m_elementTile[element] >= 0 && m_tiles[m_elementTile[element]]->linearizer); }
+
+signals:
+    void refined();
+
+private slots:
+    void doTileFinished();
+
+private:
+    ViewScalarFilter *m_filter;
+    double m_maxAbs;
+    double m_eps;
+    double m_domainSize;
+    Linearizer *m_base;
+
+    QList<ScalarViewTile *> m_tiles;
+    QVector<int> m_elementTile;
+
+    RectPoint m_viewport;
+    int m_level;
+    int m_used;
+
+    QFutureWatcher<Linearizer *> m_watcher;
+    int m_running;
+    int m_runningLevel;
+
+    int level(double pixelSize);
+    void startNext();
+    void start(int running, const QVector<bool> &mask, double eps);
+    void reduceMemory();
+};
+
+#endif // SCALARVIEWTILES_H
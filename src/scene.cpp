@@ -131,6 +131,11 @@ Scene::Scene()
     m_problemInfo = new ProblemInfo();
     m_undoStack = new QUndoStack(this);
     m_sceneSolution = new SceneSolution();
+    m_sceneIndex = new SceneIndex(this);
+
+    m_batchLevel = 0;
+    m_batchModified = false;
+    m_batchCommand = NULL;
 
     connect(this, SIGNAL(invalidated()), this, SLOT(doInvalidated()));
     connect(m_sceneSolution, SIGNAL(solved()), this, SLOT(doInvalidated()));
@@ -143,6 +148,7 @@ Scene::~Scene()
     clear();
 
     delete m_sceneSolution;
+    delete m_sceneIndex;
     delete m_undoStack;
 }
 
@@ -198,64 +204,65 @@ void Scene::createActions()
 
 SceneNode *Scene::addNode(SceneNode *node)
 {
-    // clear solution
-    m_sceneSolution->clear();
+    // clear solution (deferred in the batch)
+    if (!isBatch()) m_sceneSolution->clear();
 
     // check if node doesn't exists
-    foreach (SceneNode *nodeCheck, nodes)
+    SceneNode *nodeCheck = m_sceneIndex->node(node->point);
+    if (nodeCheck)
     {
-        if (nodeCheck->point == node->point)
-        {
-            delete node;
-            return nodeCheck;
-        }
+        delete node;
+        return nodeCheck;
     }
+
     nodes.append(node);
-    if (!scriptIsRunning()) emit invalidated();
+    m_sceneIndex->addNode(node);
+    if (m_batchCommand) new SceneNodeCommandAdd(node->point, m_batchCommand);
+
+    if (isBatch()) m_batchModified = true;
+    else if (!scriptIsRunning()) emit invalidated();
 
     return node;
 }
 
 void Scene::removeNode(SceneNode *node)
 {
-    // clear solution
-    m_sceneSolution->clear();
+    // clear solution (deferred in the batch)
+    if (!isBatch()) m_sceneSolution->clear();
 
     // remove all edges connected to this node
-    foreach (SceneEdge *edge, edges)
+    foreach (SceneEdge *edge, m_sceneIndex->edges(node->point))
     {
         if ((edge->nodeStart == node) || (edge->nodeEnd == node))
         {
-            m_undoStack->push(new SceneEdgeCommandRemove(edge->nodeStart->point, edge->nodeEnd->point, edge->marker->name, edge->angle));
+            // the batch records the removal itself
+            if (!isBatch()) m_undoStack->push(new SceneEdgeCommandRemove(edge->nodeStart->point, edge->nodeEnd->point, edge->marker->name, edge->angle, edge->meshSize));
             removeEdge(edge);
         }
     }
 
     nodes.removeOne(node);
+    m_sceneIndex->removeNode(node);
+    if (m_batchCommand) new SceneNodeCommandRemove(node->point, m_batchCommand);
     // delete node;
 
-    emit invalidated();
+    if (isBatch()) m_batchModified = true;
+    else emit invalidated();
 }
 
 SceneNode *Scene::getNode(const Point &point)
 {
-    foreach (SceneNode *nodeCheck, nodes)
-    {
-        if (nodeCheck->point == point)
-            return nodeCheck;
-    }
-
-    return NULL;
+    return m_sceneIndex->node(point);
 }
 
 
 SceneEdge *Scene::addEdge(SceneEdge *edge)
 {
-    // clear solution
-    m_sceneSolution->clear();
+    // clear solution (deferred in the batch)
+    if (!isBatch()) m_sceneSolution->clear();
 
     // check if edge doesn't exists
-    foreach (SceneEdge *edgeCheck, edges)
+    foreach (SceneEdge *edgeCheck, m_sceneIndex->edges(edge->nodeStart->point))
     {
         if ((((edgeCheck->nodeStart == edge->nodeStart) && (edgeCheck->nodeEnd == edge->nodeEnd)) ||
              ((edgeCheck->nodeStart == edge->nodeEnd) && (edgeCheck->nodeEnd == edge->nodeStart))) &&
@@ -267,25 +274,32 @@ SceneEdge *Scene::addEdge(SceneEdge *edge)
     }
 
     edges.append(edge);
-    if (!scriptIsRunning()) emit invalidated();
+    m_sceneIndex->addEdge(edge);
+    if (m_batchCommand) new SceneEdgeCommandAdd(edge->nodeStart->point, edge->nodeEnd->point, edge->marker->name, edge->angle, edge->meshSize, m_batchCommand);
+
+    if (isBatch()) m_batchModified = true;
+    else if (!scriptIsRunning()) emit invalidated();
 
     return edge;
 }
 
 void Scene::removeEdge(SceneEdge *edge)
 {
-    // clear solution
-    m_sceneSolution->clear();
+    // clear solution (deferred in the batch)
+    if (!isBatch()) m_sceneSolution->clear();
 
     edges.removeOne(edge);
+    m_sceneIndex->removeEdge(edge);
+    if (m_batchCommand) new SceneEdgeCommandRemove(edge->nodeStart->point, edge->nodeEnd->point, edge->marker->name, edge->angle, edge->meshSize, m_batchCommand);
     // delete edge;
 
-    emit invalidated();
+    if (isBatch()) m_batchModified = true;
+    else emit invalidated();
 }
 
 SceneEdge *Scene::getEdge(const Point &pointStart, const Point &pointEnd, double angle)
 {
-    foreach (SceneEdge *edgeCheck, edges)
+    foreach (SceneEdge *edgeCheck, m_sceneIndex->edges(pointStart))
     {
         if (((edgeCheck->nodeStart->point == pointStart) && (edgeCheck->nodeEnd->point == pointEnd)) && (edgeCheck->angle == angle))
             return edgeCheck;
@@ -306,44 +320,44 @@ void Scene::setEdgeEdgeMarker(SceneEdgeMarker *edgeMarker)
 
 SceneLabel *Scene::addLabel(SceneLabel *label)
 {
-    // clear solution
-    m_sceneSolution->clear();
+    // clear solution (deferred in the batch)
+    if (!isBatch()) m_sceneSolution->clear();
 
     // check if label doesn't exists
-    foreach (SceneLabel *labelCheck, labels)
+    SceneLabel *labelCheck = m_sceneIndex->label(label->point);
+    if (labelCheck)
     {
-        if (labelCheck->point == label->point)
-        {
-            delete label;
-            return labelCheck;
-        }
+        delete label;
+        return labelCheck;
     }
 
     labels.append(label);
-    if (!scriptIsRunning()) emit invalidated();
+    m_sceneIndex->addLabel(label);
+    if (m_batchCommand) new SceneLabelCommandAdd(label->point, label->marker->name, label->area, label->polynomialOrder, m_batchCommand);
+
+    if (isBatch()) m_batchModified = true;
+    else if (!scriptIsRunning()) emit invalidated();
 
     return label;
 }
 
 void Scene::removeLabel(SceneLabel *label)
 {
-    // clear solution
-    m_sceneSolution->clear();
+    // clear solution (deferred in the batch)
+    if (!isBatch()) m_sceneSolution->clear();
 
     labels.removeOne(label);
+    m_sceneIndex->removeLabel(label);
+    if (m_batchCommand) new SceneLabelCommandRemove(label->point, label->marker->name, label->area, label->polynomialOrder, m_batchCommand);
     // delete label;
 
-    emit invalidated();
+    if (isBatch()) m_batchModified = true;
+    else emit invalidated();
 }
 
 SceneLabel *Scene::getLabel(const Point &point)
 {
-    foreach (SceneLabel *labelCheck, labels)
-    {
-        if (labelCheck->point == point)
-            return labelCheck;
-    }
-    return NULL;
+    return m_sceneIndex->label(point);
 }
 
 void Scene::setLabelLabelMarker(SceneLabelMarker *labelMarker)
@@ -497,6 +511,15 @@ void Scene::clear()
 
     m_undoStack->clear();
 
+    // the open batch is closed (new document)
+    if (m_batchCommand)
+    {
+        delete m_batchCommand;
+        m_batchCommand = NULL;
+    }
+    m_batchLevel = 0;
+    m_batchModified = false;
+
     m_sceneSolution->clear();
     m_problemInfo->clear();
 
@@ -507,6 +530,7 @@ void Scene::clear()
     edges.clear();
     for (int i = 0; i < labels.count(); i++) delete labels[i];
     labels.clear();
+    m_sceneIndex->clear();
 
     // markers
     for (int i = 0; i < edgeMarkers.count(); i++) delete edgeMarkers[i];
@@ -585,40 +609,27 @@ void Scene::selectAll(SceneMode sceneMode)
 
 void Scene::deleteSelected()
 {
-    m_undoStack->beginMacro(tr("Delete selected"));
+    beginBatch(tr("Delete selected"));
 
     foreach (SceneNode *node, nodes)
     {
         if (node->isSelected)
-        {
-            m_undoStack->beginMacro(tr("Remove node"));
-            m_undoStack->push(new SceneNodeCommandRemove(node->point));
             removeNode(node);
-            m_undoStack->endMacro();
-        }
     }
 
     foreach (SceneEdge *edge, edges)
     {
         if (edge->isSelected)
-        {
-            m_undoStack->push(new SceneEdgeCommandRemove(edge->nodeStart->point, edge->nodeEnd->point, edge->marker->name, edge->angle));
             removeEdge(edge);
-        }
     }
 
     foreach (SceneLabel *label, labels)
     {
         if (label->isSelected)
-        {
-            m_undoStack->push(new SceneLabelCommandRemove(label->point, label->marker->name, label->area, label->polynomialOrder));
             removeLabel(label);
-        }
     }
 
-    m_undoStack->endMacro();
-
-    emit invalidated();
+    commitBatch();
 }
 
 int Scene::selectedCount()
@@ -650,10 +661,7 @@ void Scene::highlightNone()
 
 void Scene::transformTranslate(const Point &point, bool copy)
 {
-    // clear solution
-    m_sceneSolution->clear();
-
-    m_undoStack->beginMacro(tr("Translation"));
+    beginBatch(tr("Translation"));
 
     foreach (SceneEdge *edge, edges)
     {
@@ -672,16 +680,11 @@ void Scene::transformTranslate(const Point &point, bool copy)
             if (!copy)
             {
                 if (!getNode(pointNew))
-                {
-                    m_undoStack->push(new SceneNodeCommandEdit(node->point, pointNew));
-                    node->point = pointNew;
-                }
+                    moveNode(node, pointNew);
             }
             else
             {
-                SceneNode *nodeNew = new SceneNode(pointNew);
-                SceneNode *nodeAdded = addNode(nodeNew);
-                if (nodeAdded == nodeNew) m_undoStack->push(new SceneNodeCommandAdd(nodeNew->point));
+                addNode(new SceneNode(pointNew));
             }
         }
     }
@@ -694,31 +697,21 @@ void Scene::transformTranslate(const Point &point, bool copy)
             if (!copy)
             {
                 if (!getLabel(pointNew))
-                {
-                    m_undoStack->push(new SceneLabelCommandEdit(label->point, pointNew));
-                    label->point = pointNew;
-                }
+                    moveLabel(label, pointNew);
             }
             else
             {
-                SceneLabel *labelNew = new SceneLabel(pointNew, label->marker, label->area, label->polynomialOrder);
-                SceneLabel *labelAdded = addLabel(labelNew);
-                if (labelAdded == labelNew) m_undoStack->push(new SceneLabelCommandAdd(labelNew->point, labelNew->marker->name, labelNew->area, label->polynomialOrder));
+                addLabel(new SceneLabel(pointNew, label->marker, label->area, label->polynomialOrder));
             }
         }
     }
 
-    m_undoStack->endMacro();
-
-    emit invalidated();
+    commitBatch();
 }
 
 void Scene::transformRotate(const Point &point, double angle, bool copy)
 {
-    // clear solution
-    m_sceneSolution->clear();
-
-    m_undoStack->beginMacro(tr("Rotation"));
+    beginBatch(tr("Rotation"));
 
     foreach (SceneEdge *edge, edges)
     {
@@ -738,13 +731,11 @@ void Scene::transformRotate(const Point &point, double angle, bool copy)
         Point pointNew = point + Point(distanceNode * cos((angleNode + angle)/180.0*M_PI), distanceNode * sin((angleNode + angle)/180.0*M_PI));
         if (!copy)
         {
-            node->point = pointNew;
+            moveNode(node, pointNew);
         }
         else
         {
-            SceneNode *nodeNew = new SceneNode(pointNew);
-            SceneNode *nodeAdded = addNode(nodeNew);
-            if (nodeAdded == nodeNew) m_undoStack->push(new SceneNodeCommandAdd(nodeNew->point));
+            addNode(new SceneNode(pointNew));
         }
     }
 
@@ -757,27 +748,20 @@ void Scene::transformRotate(const Point &point, double angle, bool copy)
         Point pointNew = point + Point(distanceNode * cos((angleNode + angle)/180.0*M_PI), distanceNode * sin((angleNode + angle)/180.0*M_PI));
         if (!copy)
         {
-            label->point = pointNew;
+            moveLabel(label, pointNew);
         }
         else
         {
-            SceneLabel *labelNew = new SceneLabel(pointNew, label->marker, label->area, label->polynomialOrder);
-            SceneLabel *labelAdded = addLabel(labelNew);
-            if (labelAdded == labelNew) m_undoStack->push(new SceneLabelCommandAdd(labelNew->point, labelNew->marker->name, labelNew->area, labelNew->polynomialOrder));
+            addLabel(new SceneLabel(pointNew, label->marker, label->area, label->polynomialOrder));
         }
     }
 
-    m_undoStack->endMacro();
-
-    emit invalidated();
+    commitBatch();
 }
 
 void Scene::transformScale(const Point &point, double scaleFactor, bool copy)
 {
-    // clear solution
-    m_sceneSolution->clear();
-
-    m_undoStack->beginMacro(tr("Scale"));
+    beginBatch(tr("Scale"));
 
     foreach (SceneEdge *edge, edges)
     {
@@ -794,13 +778,11 @@ void Scene::transformScale(const Point &point, double scaleFactor, bool copy)
         Point pointNew = point + (node->point - point) * scaleFactor;
         if (!copy)
         {
-            node->point = pointNew;
+            moveNode(node, pointNew);
         }
         else
         {
-            SceneNode *nodeNew = new SceneNode(pointNew);
-            SceneNode *nodeAdded = addNode(nodeNew);
-            if (nodeAdded == nodeNew) m_undoStack->push(new SceneNodeCommandAdd(nodeNew->point));
+            addNode(new SceneNode(pointNew));
         }
     }
 
@@ -810,19 +792,68 @@ void Scene::transformScale(const Point &point, double scaleFactor, bool copy)
         Point pointNew = point + (label->point - point) * scaleFactor;
         if (!copy)
         {
-            label->point = pointNew;
+            moveLabel(label, pointNew);
         }
         else
         {
-            SceneLabel *labelNew = new SceneLabel(pointNew, label->marker, label->area, label->polynomialOrder);
-            SceneLabel *labelAdded = addLabel(labelNew);
-            if (labelAdded == labelNew) m_undoStack->push(new SceneLabelCommandAdd(labelNew->point, labelNew->marker->name, labelNew->area, labelNew->polynomialOrder));
+            addLabel(new SceneLabel(pointNew, label->marker, label->area, label->polynomialOrder));
         }
     }
 
-    m_undoStack->endMacro();
+    commitBatch();
+}
 
-    emit invalidated();
+void Scene::moveNode(SceneNode *node, const Point &point)
+{
+    if (m_batchCommand) new SceneNodeCommandEdit(node->point, point, m_batchCommand);
+    m_sceneIndex->moveNode(node, point);
+
+    if (isBatch()) m_batchModified = true;
+    else m_sceneSolution->clear();
+}
+
+void Scene::moveLabel(SceneLabel *label, const Point &point)
+{
+    if (m_batchCommand) new SceneLabelCommandEdit(label->point, point, m_batchCommand);
+    m_sceneIndex->moveLabel(label, point);
+
+    if (isBatch()) m_batchModified = true;
+    else m_sceneSolution->clear();
+}
+
+void Scene::beginBatch(const QString &text, bool isRecorded)
+{
+    // nested batches are part of the outer one
+    if (m_batchLevel++ > 0)
+        return;
+
+    m_batchModified = false;
+    if (isRecorded)
+        m_batchCommand = new SceneCommandBatch(text);
+}
+
+void Scene::commitBatch()
+{
+    if (m_batchLevel == 0 || --m_batchLevel > 0)
+        return;
+
+    if (m_batchCommand)
+    {
+        // operations are already done (see SceneCommandBatch::redo())
+        if (m_batchCommand->childCount() > 0)
+            m_undoStack->push(m_batchCommand);
+        else
+            delete m_batchCommand;
+        m_batchCommand = NULL;
+    }
+
+    if (m_batchModified)
+    {
+        m_batchModified = false;
+
+        m_sceneSolution->clear();
+        if (!scriptIsRunning()) emit invalidated();
+    }
 }
 
 void Scene::doInvalidated()
@@ -854,7 +885,8 @@ void Scene::doNewEdge()
             m_undoStack->push(new SceneEdgeCommandAdd(edge->nodeStart->point,
                                                                          edge->nodeEnd->point,
                                                                          edge->marker->name,
-                                                                         edge->angle));
+                                                                         edge->angle,
+                                                                         edge->meshSize));
     }
     else
         delete edge;
@@ -932,20 +964,14 @@ void Scene::doProblemProperties()
     }
 }
 
-void Scene::writeToDxf(const QString &fileName)
+// dxf header, tables (one layer) and start of the entities section
+DL_WriterA *writeDxfStart(DL_Dxf *dxf, const QString &fileName, const QString &layer, double width)
 {
-    RectPoint box = boundingBox();
-
-    // save current locale
-    char *plocale = setlocale (LC_NUMERIC, "");
-    setlocale (LC_NUMERIC, "C");
-
-    DL_Dxf* dxf = new DL_Dxf();
     DL_Codes::version exportVersion = DL_Codes::AC1015;
     DL_WriterA *dw = dxf->out(fileName.toStdString().c_str(), exportVersion);
     if (dw == NULL) {
         qCritical() << fileName << " could not be opened.";
-        return;
+        return NULL;
     }
 
     dxf->writeHeader(*dw);
@@ -997,11 +1023,11 @@ void Scene::writeToDxf(const QString &fileName)
     dw->tableLayers(numberOfLayers);
 
     dxf->writeLayer(*dw,
-                    DL_LayerData("main", 0),
+                    DL_LayerData(layer.toStdString(), 0),
                     DL_Attributes(
                             std::string(""),            // leave empty
                             DL_Codes::black,            // default color
-                            qMax(box.width(), box.height())/100.0,   // default width
+                            width,                      // default width
                             "CONTINUOUS"));             // default line style
 
     dw->tableEnd();
@@ -1023,6 +1049,37 @@ void Scene::writeToDxf(const QString &fileName)
     dw->sectionEnd();
     dw->sectionEntities();
 
+    return dw;
+}
+
+// end of the entities section and the objects
+void writeDxfEnd(DL_Dxf *dxf, DL_WriterA *dw)
+{
+    dw->sectionEnd();
+    dxf->writeObjects(*dw);
+    dxf->writeObjectsEnd(*dw);
+    dw->dxfEOF();
+    dw->close();
+
+    delete dw;
+}
+
+void Scene::writeToDxf(const QString &fileName)
+{
+    RectPoint box = boundingBox();
+
+    // save current locale
+    char *plocale = setlocale (LC_NUMERIC, "");
+    setlocale (LC_NUMERIC, "C");
+
+    DL_Dxf* dxf = new DL_Dxf();
+    DL_WriterA *dw = writeDxfStart(dxf, fileName, "main", qMax(box.width(), box.height())/100.0);
+    if (dw == NULL) {
+        delete dxf;
+        setlocale(LC_NUMERIC, plocale);
+        return;
+    }
+
     // edges
     for (int i = 0; i<edges.length(); i++)
     {
@@ -1054,13 +1111,7 @@ void Scene::writeToDxf(const QString &fileName)
         }
     }
 
-    dw->sectionEnd();
-    dxf->writeObjects(*dw);
-    dxf->writeObjectsEnd(*dw);
-    dw->dxfEOF();
-    dw->close();
-
-    delete dw;
+    writeDxfEnd(dxf, dw);
     delete dxf;
 
     // set system locale
@@ -1074,22 +1125,17 @@ void Scene::readFromDxf(const QString &fileName)
     char *plocale = setlocale (LC_NUMERIC, "");
     setlocale (LC_NUMERIC, "C");
 
-    blockSignals(true);
+    beginBatch(tr("Import DXF"));
 
     DxfFilter *filter = new DxfFilter(this);
     DL_Dxf* dxf = new DL_Dxf();
     if (!dxf->in(fileName.toStdString(), filter))
-    {
         qCritical() << fileName << " could not be opened.";
-        return;
-    }
 
     delete dxf;
     delete filter;
 
-    blockSignals(false);
-
-    emit invalidated();
+    commitBatch();
 
     // set system locale
     setlocale(LC_NUMERIC, plocale);
@@ -1148,6 +1194,8 @@ ErrorResult Scene::readFromFile(const QString &fileName)
     m_problemInfo->setHermes(hermesFieldFactory(physicFieldFromStringKey(eleProblem.toElement().attribute("type"))));
     // number of refinements
     m_problemInfo->numberOfRefinements = eleProblem.toElement().attribute("numberofrefinements").toInt();
+    // mesh gradation
+    m_problemInfo->meshGradation = eleProblem.toElement().attribute("meshgradation", "0.3").toDouble();
     // polynomial order
     m_problemInfo->polynomialOrder = eleProblem.toElement().attribute("polynomialorder").toInt();
     // adaptivity
@@ -1162,6 +1210,15 @@ ErrorResult Scene::readFromFile(const QString &fileName)
     m_problemInfo->timeStep.text = eleProblem.toElement().attribute("timestep", "1");
     m_problemInfo->timeTotal.text = eleProblem.toElement().attribute("timetotal", "1");
     m_problemInfo->initialCondition.text = eleProblem.toElement().attribute("initialcondition", "0");
+    m_problemInfo->timeStepMethod = timeStepMethodFromStringKey(eleProblem.toElement().attribute("timestepmethod", timeStepMethodToStringKey(TimeStepMethod_Fixed)));
+    m_problemInfo->timeStepTolerance = eleProblem.toElement().attribute("timesteptolerance", "1").toDouble();
+    if (m_problemInfo->timeStepTolerance <= 0.0)
+    {
+        clear();
+        setlocale(LC_NUMERIC, plocale);
+        blockSignals(false);
+        return ErrorResult(ErrorResultType_Critical, tr("Time step tolerance in file '%1' must be positive.").arg(fileName));
+    }
 
     // solver
     m_problemInfo->matrixCommonSolverType = matrixCommonSolverTypeFromStringKey(eleProblem.toElement().attribute("matrixsolver", matrixCommonSolverTypeToStringKey(MatrixCommonSolverType_SparseLib_GeneralizedMinimumResidual)));
@@ -1248,7 +1305,9 @@ ErrorResult Scene::readFromFile(const QString &fileName)
         SceneEdgeMarker *marker = edgeMarkers[element.attribute("marker").toInt()];
         double angle = element.attribute("angle").toDouble();
 
-        addEdge(new SceneEdge(nodeFrom, nodeTo, marker, angle));
+        SceneEdge *edge = new SceneEdge(nodeFrom, nodeTo, marker, angle);
+        edge->meshSize = element.attribute("meshsize", "0").toDouble();
+        addEdge(edge);
         n = n.nextSibling();
     }
 
@@ -1308,32 +1367,17 @@ ErrorResult Scene::readFromFile(const QString &fileName)
     return ErrorResult();
 }
 
-ErrorResult Scene::writeToFile(const QString &fileName)
+void Scene::writeToDomDocument(QDomDocument *doc)
 {
-    QSettings settings;
-
-    if (QFileInfo(tempProblemFileName()).baseName() != QFileInfo(fileName).baseName())
-    {
-        QFileInfo fileInfo(fileName);
-        settings.setValue("General/LastDataDir", fileInfo.absoluteFilePath());
-        m_problemInfo->fileName = fileName;
-    }
-
-    // save current locale
-    char *plocale = setlocale (LC_NUMERIC, "");
-    setlocale (LC_NUMERIC, "C");
-
-    QDomDocument doc;
-
     // main document
-    QDomElement eleDoc = doc.createElement("document");
-    doc.appendChild(eleDoc);
+    QDomElement eleDoc = doc->createElement("document");
+    doc->appendChild(eleDoc);
 
     // problems
-    QDomNode eleProblems = doc.createElement("problems");
+    QDomNode eleProblems = doc->createElement("problems");
     eleDoc.appendChild(eleProblems);
     // first problem
-    QDomElement eleProblem = doc.createElement("problem");
+    QDomElement eleProblem = doc->createElement("problem");
     eleProblems.appendChild(eleProblem);
     // id
     eleProblem.setAttribute("id", 0);
@@ -1351,6 +1395,8 @@ ErrorResult Scene::writeToFile(const QString &fileName)
     eleProblem.setAttribute("type", physicFieldToStringKey(m_problemInfo->physicField()));
     // number of refinements
     eleProblem.setAttribute("numberofrefinements", m_problemInfo->numberOfRefinements);
+    // mesh gradation
+    eleProblem.setAttribute("meshgradation", m_problemInfo->meshGradation);
     // polynomial order
     eleProblem.setAttribute("polynomialorder", m_problemInfo->polynomialOrder);
     // adaptivity
@@ -1363,31 +1409,33 @@ ErrorResult Scene::writeToFile(const QString &fileName)
     eleProblem.setAttribute("timestep", m_problemInfo->timeStep.text);
     eleProblem.setAttribute("timetotal", m_problemInfo->timeTotal.text);
     eleProblem.setAttribute("initialcondition", m_problemInfo->initialCondition.text);
+    eleProblem.setAttribute("timestepmethod", timeStepMethodToStringKey(m_problemInfo->timeStepMethod));
+    eleProblem.setAttribute("timesteptolerance", m_problemInfo->timeStepTolerance);
     // solver
     eleProblem.setAttribute("matrixsolver", matrixCommonSolverTypeToStringKey(m_problemInfo->matrixCommonSolverType));
 
     // startup script
-    QDomElement eleScriptStartup = doc.createElement("scriptstartup");
-    eleScriptStartup.appendChild(doc.createTextNode(m_problemInfo->scriptStartup));
+    QDomElement eleScriptStartup = doc->createElement("scriptstartup");
+    eleScriptStartup.appendChild(doc->createTextNode(m_problemInfo->scriptStartup));
     eleProblem.appendChild(eleScriptStartup);
 
     // description
-    QDomElement eleDescription = doc.createElement("description");
-    eleDescription.appendChild(doc.createTextNode(m_problemInfo->description));
+    QDomElement eleDescription = doc->createElement("description");
+    eleDescription.appendChild(doc->createTextNode(m_problemInfo->description));
     eleProblem.appendChild(eleDescription);
 
     // geometry
-    QDomNode eleGeometry = doc.createElement("geometry");
+    QDomNode eleGeometry = doc->createElement("geometry");
     eleDoc.appendChild(eleGeometry);
 
     // geometry ***************************************************************************************************************
 
     // nodes
-    QDomNode eleNodes = doc.createElement("nodes");
+    QDomNode eleNodes = doc->createElement("nodes");
     eleGeometry.appendChild(eleNodes);
     for (int i = 0; i<nodes.length(); i++)
     {
-        QDomElement eleNode = doc.createElement("node");
+        QDomElement eleNode = doc->createElement("node");
 
         eleNode.setAttribute("id", i);
         eleNode.setAttribute("x", nodes[i]->point.x);
@@ -1397,27 +1445,29 @@ ErrorResult Scene::writeToFile(const QString &fileName)
     }
 
     // edges
-    QDomNode eleEdges = doc.createElement("edges");
+    QDomNode eleEdges = doc->createElement("edges");
     eleGeometry.appendChild(eleEdges);
     for (int i = 0; i<edges.length(); i++)
     {
-        QDomElement eleEdge = doc.createElement("edge");
+        QDomElement eleEdge = doc->createElement("edge");
 
         eleEdge.setAttribute("id", i);
         eleEdge.setAttribute("start", nodes.indexOf(edges[i]->nodeStart));
         eleEdge.setAttribute("end", nodes.indexOf(edges[i]->nodeEnd));
         eleEdge.setAttribute("angle", edges[i]->angle);
         eleEdge.setAttribute("marker", edgeMarkers.indexOf(edges[i]->marker));
+        if (edges[i]->meshSize > 0.0)
+            eleEdge.setAttribute("meshsize", edges[i]->meshSize);
 
         eleEdges.appendChild(eleEdge);
     }
 
     // labels
-    QDomNode eleLabels = doc.createElement("labels");
+    QDomNode eleLabels = doc->createElement("labels");
     eleGeometry.appendChild(eleLabels);
     for (int i = 0; i<labels.length(); i++)
     {
-        QDomElement eleLabel = doc.createElement("label");
+        QDomElement eleLabel = doc->createElement("label");
 
         eleLabel.setAttribute("id", i);
         eleLabel.setAttribute("x", labels[i]->point.x);
@@ -1432,11 +1482,11 @@ ErrorResult Scene::writeToFile(const QString &fileName)
     // markers ***************************************************************************************************************
 
     // edge markers
-    QDomNode eleEdgeMarkers = doc.createElement("edges");
+    QDomNode eleEdgeMarkers = doc->createElement("edges");
     eleProblem.appendChild(eleEdgeMarkers);
     for (int i = 1; i<edgeMarkers.length(); i++)
     {
-        QDomElement eleEdgeMarker = doc.createElement("edge");
+        QDomElement eleEdgeMarker = doc->createElement("edge");
 
         eleEdgeMarker.setAttribute("id", i);
         eleEdgeMarker.setAttribute("name", edgeMarkers[i]->name);
@@ -1453,11 +1503,11 @@ ErrorResult Scene::writeToFile(const QString &fileName)
     }
 
     // label markers
-    QDomNode eleLabelMarkers = doc.createElement("labels");
+    QDomNode eleLabelMarkers = doc->createElement("labels");
     eleProblem.appendChild(eleLabelMarkers);
     for (int i = 1; i<labelMarkers.length(); i++)
     {
-        QDomElement eleLabelMarker = doc.createElement("label");
+        QDomElement eleLabelMarker = doc->createElement("label");
 
         eleLabelMarker.setAttribute("id", i);
         eleLabelMarker.setAttribute("name", labelMarkers[i]->name);
@@ -1472,11 +1522,11 @@ ErrorResult Scene::writeToFile(const QString &fileName)
     }
 
     // functions
-    QDomNode eleFunctions = doc.createElement("functions");
+    QDomNode eleFunctions = doc->createElement("functions");
     eleDoc.appendChild(eleFunctions);
     for (int i = 0; i<functions.length(); i++)
     {
-        QDomElement eleFunction = doc.createElement("function");
+        QDomElement eleFunction = doc->createElement("function");
 
         eleFunction.setAttribute("name", functions[i]->name);
         eleFunction.setAttribute("function", functions[i]->function);
@@ -1485,6 +1535,26 @@ ErrorResult Scene::writeToFile(const QString &fileName)
 
         eleFunctions.appendChild(eleFunction);
     }
+}
+
+ErrorResult Scene::writeToFile(const QString &fileName)
+{
+    QSettings settings;
+
+    if (QFileInfo(tempProblemFileName()).baseName() != QFileInfo(fileName).baseName())
+    {
+        QFileInfo fileInfo(fileName);
+        settings.setValue("General/LastDataDir", fileInfo.absoluteFilePath());
+        m_problemInfo->fileName = fileName;
+    }
+
+    // save current locale
+    char *plocale = setlocale (LC_NUMERIC, "");
+    setlocale (LC_NUMERIC, "C");
+
+    QDomDocument doc;
+    writeToDomDocument(&doc);
+    QDomElement eleDoc = doc.documentElement();
 
     if (settings.value("Solver/SaveProblemWithSolution", false).value<bool>())
     {
@@ -30,6 +30,7 @@
 #include "scenemarker.h"
 #include "scenefunction.h"
 #include "scenesolution.h"
+#include "sceneindex.h"
 
 #include "localvalueview.h"
 #include "surfaceintegralview.h"
@@ -85,6 +86,7 @@ public:
     int linearityNewtonMaxSteps;
     double linearityNewtonTolerance;
     int numberOfRefinements;
+    double meshGradation; // growth of the element size with the distance from the edges with mesh size
     int polynomialOrder;
     AdaptivityType adaptivityType;
     int adaptivitySteps;
@@ -100,6 +102,8 @@ public:
     Value timeStep;
     Value timeTotal;
     Value initialCondition;
+    TimeStepMethod timeStepMethod;
+    double timeStepTolerance; // percent (adaptive time step)
 
     // matrix solver
     MatrixCommonSolverType matrixCommonSolverType;
@@ -130,6 +134,7 @@ public:
         scriptStartup = "";
         description = "";
         numberOfRefinements = 1;
+        meshGradation = 0.3;
         polynomialOrder = 2;
         adaptivityType = AdaptivityType_None;
         adaptivitySteps = 0;
@@ -142,6 +147,8 @@ public:
         timeStep = Value("1.0", false);
         timeTotal = Value("1.0", false);
         initialCondition = Value("0.0", false);
+        timeStepMethod = TimeStepMethod_Fixed;
+        timeStepTolerance = 1.0;
 
         // solver
         matrixCommonSolverType = MatrixCommonSolverType_SparseLib_BiConjugateGradient;
@@ -174,6 +181,10 @@ private:
     Scene *m_scene;
 };
 
+// dxf export (geometry, contours)
+DL_WriterA *writeDxfStart(DL_Dxf *dxf, const QString &fileName, const QString &layer, double width);
+void writeDxfEnd(DL_Dxf *dxf, DL_WriterA *dw);
+
 class Scene : public QObject
 {
     Q_OBJECT
@@ -258,17 +269,29 @@ public:
     void transformTranslate(const Point &point, bool copy);
     void transformRotate(const Point &point, double angle, bool copy);
     void transformScale(const Point &point, double scaleFactor, bool copy);
+
+    void moveNode(SceneNode *node, const Point &point);
+    void moveLabel(SceneLabel *label, const Point &point);
+
+    // batch of geometry operations - solution clearing and invalidation are deferred to the commit,
+    // operations are recorded as one undo command (batches can be nested)
+    void beginBatch(const QString &text = tr("Batch"), bool isRecorded = true);
+    void commitBatch();
+    inline bool isBatch() { return m_batchLevel > 0; }
     
     inline ProblemInfo *problemInfo() { return m_problemInfo; }
     inline void setProblemInfo(ProblemInfo *problemInfo) { m_problemInfo = problemInfo; emit defaultValues(); }
     
     inline void refresh() { emit invalidated(); }
     inline SceneSolution *sceneSolution() { return m_sceneSolution; }
+    inline SceneIndex *sceneIndex() { return m_sceneIndex; }
     
     void readFromDxf(const QString &fileName);
     void writeToDxf(const QString &fileName);
     ErrorResult readFromFile(const QString &fileName);
     ErrorResult writeToFile(const QString &fileName);
+    // problem, geometry, markers and functions (without the solution)
+    void writeToDomDocument(QDomDocument *doc);
     
     inline QUndoStack *undoStack() { return m_undoStack; }
     
@@ -278,6 +301,14 @@ private:
     
     // scene solution
     SceneSolution *m_sceneSolution;
+
+    // spatial index of the geometry
+    SceneIndex *m_sceneIndex;
+
+    // batch
+    int m_batchLevel;
+    bool m_batchModified;
+    SceneCommandBatch *m_batchCommand;
     
     void createActions();
     
@@ -58,6 +58,7 @@ SceneEdge::SceneEdge(SceneNode *nodeStart, SceneNode *nodeEnd, SceneEdgeMarker *
     this->nodeEnd = nodeEnd;
     this->marker = marker;
     this->angle = angle;
+    this->meshSize = 0.0;
 }
 
 Point SceneEdge::center()
@@ -263,7 +264,7 @@ bool DSceneNode::save()
         }
     }
 
-    sceneNode->point = point;
+    Util::scene()->sceneIndex()->moveNode(sceneNode, point);
 
     return true;
 }
@@ -318,17 +319,28 @@ QLayout* DSceneEdge::createContent()
     txtAngle->setMaximum(180.0);
     connect(txtAngle, SIGNAL(evaluated(bool)), this, SLOT(evaluated(bool)));
     lblLength = new QLabel();
+    txtMeshSize = new SLineEditValue();
+    connect(txtMeshSize, SIGNAL(evaluated(bool)), this, SLOT(evaluated(bool)));
 
     QHBoxLayout *layoutMarker = new QHBoxLayout();
     layoutMarker->addWidget(cmbMarker);
     layoutMarker->addWidget(btnMarker);
 
+    // mesh size
+    chkMeshSize = new QCheckBox();
+    connect(chkMeshSize, SIGNAL(stateChanged(int)), this, SLOT(doMeshSize(int)));
+
+    QHBoxLayout *layoutMeshSize = new QHBoxLayout();
+    layoutMeshSize->addWidget(chkMeshSize);
+    layoutMeshSize->addWidget(txtMeshSize);
+
     QFormLayout *layout = new QFormLayout();
     layout->addRow(tr("Start point:"), cmbNodeStart);
     layout->addRow(tr("End point:"), cmbNodeEnd);
     layout->addRow(tr("Boundary condition:"), layoutMarker);
     layout->addRow(tr("Angle (deg.):"), txtAngle);
     layout->addRow(tr("Length:"), lblLength);
+    layout->addRow(tr("Mesh size (m):"), layoutMeshSize);
 
     fillComboBox();
 
@@ -370,6 +382,9 @@ bool DSceneEdge::load()
     cmbNodeEnd->setCurrentIndex(cmbNodeEnd->findData(sceneEdge->nodeEnd->variant()));
     cmbMarker->setCurrentIndex(cmbMarker->findData(sceneEdge->marker->variant()));
     txtAngle->setNumber(sceneEdge->angle);
+    txtMeshSize->setNumber(sceneEdge->meshSize);
+    chkMeshSize->setChecked(sceneEdge->meshSize > 0.0);
+    txtMeshSize->setEnabled(chkMeshSize->isChecked());
 
     doNodeChanged();
 
@@ -379,6 +394,15 @@ bool DSceneEdge::load()
 bool DSceneEdge::save()
 {
     if (!txtAngle->evaluate(false)) return false;
+    if (chkMeshSize->isChecked())
+    {
+        if (!txtMeshSize->evaluate(false)) return false;
+        if (txtMeshSize->number() <= 0.0)
+        {
+            QMessageBox::warning(this, "Edge", "Mesh size must be positive.");
+            return false;
+        }
+    }
 
     SceneEdge *sceneEdge = dynamic_cast<SceneEdge *>(m_object);
 
@@ -411,10 +435,17 @@ bool DSceneEdge::save()
     sceneEdge->nodeEnd = nodeEnd;
     sceneEdge->marker = cmbMarker->itemData(cmbMarker->currentIndex()).value<SceneEdgeMarker *>();
     sceneEdge->angle = txtAngle->number();
+    sceneEdge->meshSize = chkMeshSize->isChecked() ? txtMeshSize->number() : 0.0;
+    Util::scene()->sceneIndex()->invalidateEdges();
 
     return true;
 }
 
+void DSceneEdge::doMeshSize(int state)
+{
+    txtMeshSize->setEnabled(chkMeshSize->isChecked());
+}
+
 void DSceneEdge::doMarkerChanged(int index)
 {
     btnMarker->setEnabled(cmbMarker->currentIndex() > 0);
@@ -595,7 +626,7 @@ bool DSceneLabel::save()
         }
     }
 
-    sceneLabel->point = point;
+    Util::scene()->sceneIndex()->moveLabel(sceneLabel, point);
     sceneLabel->marker = cmbMarker->itemData(cmbMarker->currentIndex()).value<SceneLabelMarker *>();
     sceneLabel->area = chkArea->isChecked() ? txtArea->number() : 0.0;
     sceneLabel->polynomialOrder = chkPolynomialOrder->isChecked() ? txtPolynomialOrder->value() : 0;
@@ -681,8 +712,9 @@ void SceneNodeCommandEdit::undo()
     SceneNode *node = Util::scene()->getNode(m_pointNew);
     if (node)
     {
-        node->point = m_point;
-        Util::scene()->refresh();
+        Util::scene()->moveNode(node, m_point);
+        // the batch is refreshed once when it is committed
+        if (!Util::scene()->isBatch()) Util::scene()->refresh();
     }
 }
 
@@ -691,8 +723,9 @@ void SceneNodeCommandEdit::redo()
     SceneNode *node = Util::scene()->getNode(m_point);
     if (node)
     {
-        node->point = m_pointNew;
-        Util::scene()->refresh();
+        Util::scene()->moveNode(node, m_pointNew);
+        // the batch is refreshed once when it is committed
+        if (!Util::scene()->isBatch()) Util::scene()->refresh();
     }
 }
 
@@ -749,8 +782,9 @@ void SceneLabelCommandEdit::undo()
     SceneLabel *label = Util::scene()->getLabel(m_pointNew);
     if (label)
     {
-        label->point = m_point;
-        Util::scene()->refresh();
+        Util::scene()->moveLabel(label, m_point);
+        // the batch is refreshed once when it is committed
+        if (!Util::scene()->isBatch()) Util::scene()->refresh();
     }
 }
 
@@ -759,19 +793,21 @@ void SceneLabelCommandEdit::redo()
     SceneLabel *label = Util::scene()->getLabel(m_point);
     if (label)
     {
-        label->point = m_pointNew;
-        Util::scene()->refresh();
+        Util::scene()->moveLabel(label, m_pointNew);
+        // the batch is refreshed once when it is committed
+        if (!Util::scene()->isBatch()) Util::scene()->refresh();
     }
 }
 
 // Edge
 
-SceneEdgeCommandAdd::SceneEdgeCommandAdd(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, QUndoCommand *parent) : QUndoCommand(parent)
+SceneEdgeCommandAdd::SceneEdgeCommandAdd(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, double meshSize, QUndoCommand *parent) : QUndoCommand(parent)
 {
     m_pointStart = pointStart;
     m_pointEnd = pointEnd;
     m_markerName = markerName;
     m_angle = angle;
+    m_meshSize = meshSize;
 }
 
 void SceneEdgeCommandAdd::undo()
@@ -783,28 +819,33 @@ void SceneEdgeCommandAdd::redo()
 {
     SceneEdgeMarker *edgeMarker = Util::scene()->getEdgeMarker(m_markerName);
     if (edgeMarker == NULL) edgeMarker = Util::scene()->edgeMarkers[0];
-    Util::scene()->addEdge(new SceneEdge(Util::scene()->addNode(new SceneNode(m_pointStart)),
-                                         Util::scene()->addNode(new SceneNode(m_pointEnd)),
-                                         edgeMarker,
-                                         m_angle));
+    SceneEdge *edge = new SceneEdge(Util::scene()->addNode(new SceneNode(m_pointStart)),
+                                    Util::scene()->addNode(new SceneNode(m_pointEnd)),
+                                    edgeMarker,
+                                    m_angle);
+    edge->meshSize = m_meshSize;
+    Util::scene()->addEdge(edge);
 }
 
-SceneEdgeCommandRemove::SceneEdgeCommandRemove(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, QUndoCommand *parent) : QUndoCommand(parent)
+SceneEdgeCommandRemove::SceneEdgeCommandRemove(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, double meshSize, QUndoCommand *parent) : QUndoCommand(parent)
 {
     m_pointStart = pointStart;
     m_pointEnd = pointEnd;
     m_markerName = markerName;
     m_angle = angle;
+    m_meshSize = meshSize;
 }
 
 void SceneEdgeCommandRemove::undo()
 {
     SceneEdgeMarker *edgeMarker = Util::scene()->getEdgeMarker(m_markerName);
     if (edgeMarker == NULL) edgeMarker = Util::scene()->edgeMarkers[0];
-    Util::scene()->addEdge(new SceneEdge(Util::scene()->addNode(new SceneNode(m_pointStart)),
-                                         Util::scene()->addNode(new SceneNode(m_pointEnd)),
-                                         edgeMarker,
-                                         m_angle));
+    SceneEdge *edge = new SceneEdge(Util::scene()->addNode(new SceneNode(m_pointStart)),
+                                    Util::scene()->addNode(new SceneNode(m_pointEnd)),
+                                    edgeMarker,
+                                    m_angle);
+    edge->meshSize = m_meshSize;
+    Util::scene()->addEdge(edge);
 }
 
 void SceneEdgeCommandRemove::redo()
@@ -830,6 +871,7 @@ void SceneEdgeCommandEdit::undo()
         edge->nodeStart = Util::scene()->getNode(m_pointStart);
         edge->nodeEnd = Util::scene()->getNode(m_pointEnd);
         edge->angle = m_angle;
+        Util::scene()->sceneIndex()->invalidateEdges();
         Util::scene()->refresh();
     }
 }
@@ -842,6 +884,36 @@ void SceneEdgeCommandEdit::redo()
         edge->nodeStart = Util::scene()->getNode(m_pointStartNew);
         edge->nodeEnd = Util::scene()->getNode(m_pointEndNew);
         edge->angle = m_angleNew;
+        Util::scene()->sceneIndex()->invalidateEdges();
         Util::scene()->refresh();
     }
 }
+
+// Batch
+
+SceneCommandBatch::SceneCommandBatch(const QString &text, QUndoCommand *parent) : QUndoCommand(text, parent)
+{
+    m_isDone = true;
+}
+
+void SceneCommandBatch::undo()
+{
+    Util::scene()->beginBatch(text(), false);
+    QUndoCommand::undo();
+    Util::scene()->commitBatch();
+
+    m_isDone = false;
+}
+
+void SceneCommandBatch::redo()
+{
+    // first redo is called by QUndoStack::push()
+    if (m_isDone)
+        return;
+
+    Util::scene()->beginBatch(text(), false);
+    QUndoCommand::redo();
+    Util::scene()->commitBatch();
+
+    m_isDone = true;
+}
@@ -78,6 +78,7 @@ public:
     SceneNode *nodeStart;
     SceneNode *nodeEnd;
     double angle;
+    double meshSize; // target element size along the edge (0 - not set)
 
     SceneEdge(SceneNode *nodeStart, SceneNode *nodeEnd, SceneEdgeMarker *marker, double angle);
 
@@ -187,6 +188,8 @@ private:
     QPushButton *btnMarker;
     SLineEditValue *txtAngle;
     QLabel *lblLength;
+    QCheckBox *chkMeshSize;
+    SLineEditValue *txtMeshSize;
 
     void fillComboBox();
 
@@ -194,6 +197,7 @@ private slots:
     void doMarkerChanged(int index);
     void doMarkerClicked();
     void doNodeChanged();
+    void doMeshSize(int state);
 };
 
 // *************************************************************************************************************************************
@@ -316,7 +320,7 @@ private:
 class SceneEdgeCommandAdd : public QUndoCommand
 {
 public:
-    SceneEdgeCommandAdd(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, QUndoCommand *parent = 0);
+    SceneEdgeCommandAdd(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, double meshSize, QUndoCommand *parent = 0);
     void undo();
     void redo();
 
@@ -325,12 +329,13 @@ private:
     Point m_pointEnd;
     QString m_markerName;
     double m_angle;
+    double m_meshSize;
 };
 
 class SceneEdgeCommandRemove : public QUndoCommand
 {
 public:
-    SceneEdgeCommandRemove(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, QUndoCommand *parent = 0);
+    SceneEdgeCommandRemove(const Point &pointStart, const Point &pointEnd, const QString &markerName, double angle, double meshSize, QUndoCommand *parent = 0);
     void undo();
     void redo();
 
@@ -339,6 +344,7 @@ private:
     Point m_pointEnd;
     QString m_markerName;
     double m_angle;
+    double m_meshSize;
 };
 
 class SceneEdgeCommandEdit : public QUndoCommand
@@ -357,4 +363,18 @@ private:
     double m_angleNew;
 };
 
+// Batch
+
+// compound command of the geometry batch (Scene::beginBatch()), operations are done before the push
+class SceneCommandBatch : public QUndoCommand
+{
+public:
+    SceneCommandBatch(const QString &text, QUndoCommand *parent = 0);
+    void undo();
+    void redo();
+
+private:
+    bool m_isDone;
+};
+
 #endif // SCENEBASIC_H
@@ -0,0 +1,468 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "sceneindex.h"
+
+#include "scene.h"
+
+const int SCENEINDEX_MAX_ITEM_CELLS = 64; // larger items are not stored in the cells
+
+template <typename T>
+SceneIndexGrid<T>::SceneIndexGrid()
+{
+    clear(1.0);
+}
+
+template <typename T>
+void SceneIndexGrid<T>::clear(double cellSize)
+{
+    m_cellSize = cellSize;
+
+    m_minI = INT_MAX;
+    m_maxI = INT_MIN;
+    m_minJ = INT_MAX;
+    m_maxJ = INT_MIN;
+
+    m_cells.clear();
+    m_boxes.clear();
+    m_large.clear();
+}
+
+template <typename T>
+bool SceneIndexGrid<T>::isLarge(const RectPoint &box) const
+{
+    double cells = (floor(box.end.x / m_cellSize) - floor(box.start.x / m_cellSize) + 1.0) *
+                   (floor(box.end.y / m_cellSize) - floor(box.start.y / m_cellSize) + 1.0);
+
+    return (cells > SCENEINDEX_MAX_ITEM_CELLS);
+}
+
+template <typename T>
+void SceneIndexGrid<T>::insert(T *item, const RectPoint &box)
+{
+    if (m_boxes.contains(item))
+        remove(item);
+
+    m_boxes.insert(item, box);
+
+    if (isLarge(box))
+    {
+        m_large.append(item);
+        return;
+    }
+
+    for (int i = cell(box.start.x); i <= cell(box.end.x); i++)
+        for (int j = cell(box.start.y); j <= cell(box.end.y); j++)
+            m_cells[QPair<int, int>(i, j)].append(item);
+
+    m_minI = qMin(m_minI, cell(box.start.x));
+    m_maxI = qMax(m_maxI, cell(box.end.x));
+    m_minJ = qMin(m_minJ, cell(box.start.y));
+    m_maxJ = qMax(m_maxJ, cell(box.end.y));
+}
+
+template <typename T>
+void SceneIndexGrid<T>::remove(T *item)
+{
+    typename QHash<T *, RectPoint>::iterator it = m_boxes.find(item);
+    if (it == m_boxes.end())
+        return;
+
+    RectPoint box = it.value();
+    m_boxes.erase(it);
+
+    if (isLarge(box))
+    {
+        m_large.removeOne(item);
+        return;
+    }
+
+    for (int i = cell(box.start.x); i <= cell(box.end.x); i++)
+    {
+        for (int j = cell(box.start.y); j <= cell(box.end.y); j++)
+        {
+            typename QHash<QPair<int, int>, QList<T *> >::iterator itCell = m_cells.find(QPair<int, int>(i, j));
+            if (itCell == m_cells.end())
+                continue;
+
+            itCell.value().removeOne(item);
+            if (itCell.value().isEmpty())
+                m_cells.erase(itCell);
+        }
+    }
+}
+
+template <typename T>
+QList<T *> SceneIndexGrid<T>::items(const RectPoint &box) const
+{
+    QList<T *> list;
+    QSet<T *> found;
+
+    int i0 = qMax(cell(box.start.x), m_minI);
+    int i1 = qMin(cell(box.end.x), m_maxI);
+    int j0 = qMax(cell(box.start.y), m_minJ);
+    int j1 = qMin(cell(box.end.y), m_maxJ);
+
+    if (m_cells.isEmpty() || i0 > i1 || j0 > j1)
+    {
+        // large items only
+    }
+    else if ((double) (i1 - i0 + 1) * (double) (j1 - j0 + 1) > m_cells.count())
+    {
+        // large rectangle - go through the occupied cells
+        for (typename QHash<QPair<int, int>, QList<T *> >::const_iterator it = m_cells.constBegin(); it != m_cells.constEnd(); ++it)
+            if (it.key().first >= i0 && it.key().first <= i1 && it.key().second >= j0 && it.key().second <= j1)
+                foreach (T *item, it.value())
+                    found.insert(item);
+    }
+    else
+    {
+        for (int i = i0; i <= i1; i++)
+        {
+            for (int j = j0; j <= j1; j++)
+            {
+                typename QHash<QPair<int, int>, QList<T *> >::const_iterator it = m_cells.find(QPair<int, int>(i, j));
+                if (it != m_cells.constEnd())
+                    foreach (T *item, it.value())
+                        found.insert(item);
+            }
+        }
+    }
+    foreach (T *item, m_large)
+        found.insert(item);
+
+    // exact test of the boxes
+    foreach (T *item, found)
+    {
+        const RectPoint &itemBox = m_boxes[item];
+        if (!(itemBox.end.x < box.start.x || box.end.x < itemBox.start.x ||
+              itemBox.end.y < box.start.y || box.end.y < itemBox.start.y))
+            list.append(item);
+    }
+
+    return list;
+}
+
+template <typename T>
+T *SceneIndexGrid<T>::closest(const Point &point) const
+{
+    T *itemClosest = NULL;
+    double distance = CONST_DOUBLE;
+
+    foreach (T *item, m_large)
+    {
+        double itemDistance = item->distance(point);
+        if (itemDistance < distance)
+        {
+            distance = itemDistance;
+            itemClosest = item;
+        }
+    }
+
+    if (m_cells.isEmpty())
+        return itemClosest;
+
+    int ci = cell(point.x);
+    int cj = cell(point.y);
+
+    // rings of the cells around the point (clipped to the occupied cells)
+    int ringFirst = qMax(qMax(m_minI - ci, ci - m_maxI), qMax(qMax(m_minJ - cj, cj - m_maxJ), 0));
+    int ringLast = qMax(qMax(ci - m_minI, m_maxI - ci), qMax(cj - m_minJ, m_maxJ - cj));
+
+    for (int r = ringFirst; r <= ringLast; r++)
+    {
+        // items in the next rings are farther than r * cellSize
+        if (itemClosest && distance < (r - 1) * m_cellSize)
+            break;
+
+        for (int i = qMax(ci - r, m_minI); i <= qMin(ci + r, m_maxI); i++)
+        {
+            for (int j = qMax(cj - r, m_minJ); j <= qMin(cj + r, m_maxJ); j++)
+            {
+                // border of the ring only
+                if (abs(i - ci) != r && abs(j - cj) != r)
+                {
+                    j = qMin(cj + r, m_maxJ + 1) - 1;
+                    continue;
+                }
+
+                typename QHash<QPair<int, int>, QList<T *> >::const_iterator it = m_cells.find(QPair<int, int>(i, j));
+                if (it == m_cells.constEnd())
+                    continue;
+
+                foreach (T *item, it.value())
+                {
+                    double itemDistance = item->distance(point);
+                    if (itemDistance < distance)
+                    {
+                        distance = itemDistance;
+                        itemClosest = item;
+                    }
+                }
+            }
+        }
+    }
+
+    return itemClosest;
+}
+
+// *********************************************************************************************
+
+static RectPoint pointBox(const Point &point)
+{
+    return RectPoint(point, point);
+}
+
+static RectPoint edgeBox(SceneEdge *edge)
+{
+    Point start = edge->nodeStart->point;
+    Point end = edge->nodeEnd->point;
+
+    RectPoint box(Point(qMin(start.x, end.x), qMin(start.y, end.y)),
+                  Point(qMax(start.x, end.x), qMax(start.y, end.y)));
+
+    // arc is inside of the circle
+    if (edge->angle != 0)
+    {
+        Point center = edge->center();
+        double radius = edge->radius();
+
+        box.start.x = qMin(box.start.x, center.x - radius);
+        box.start.y = qMin(box.start.y, center.y - radius);
+        box.end.x = qMax(box.end.x, center.x + radius);
+        box.end.y = qMax(box.end.y, center.y + radius);
+    }
+
+    return box;
+}
+
+SceneIndex::SceneIndex(Scene *scene)
+{
+    m_scene = scene;
+
+    clear();
+}
+
+void SceneIndex::clear()
+{
+    m_cellSize = 1.0;
+    m_rebuildCount = 0;
+    m_isDirty = false;
+    m_isEdgesDirty = false;
+
+    m_nodes.clear(m_cellSize);
+    m_edges.clear(m_cellSize);
+    m_labels.clear(m_cellSize);
+}
+
+void SceneIndex::invalidate()
+{
+    m_isDirty = true;
+}
+
+void SceneIndex::invalidateEdges()
+{
+    m_isEdgesDirty = true;
+}
+
+void SceneIndex::update()
+{
+    if (m_isDirty)
+    {
+        // cell size - approximately one node in the cell
+        RectPoint rect = m_scene->boundingBox();
+        int count = qMax(m_scene->nodes.count() + m_scene->labels.count(), 1);
+
+        m_cellSize = qMax(rect.width(), rect.height()) / ceil(sqrt((double) count));
+        if (m_cellSize < EPS_ZERO)
+            m_cellSize = 1.0;
+        m_rebuildCount = count;
+
+        m_nodes.clear(m_cellSize);
+        foreach (SceneNode *node, m_scene->nodes)
+            m_nodes.insert(node, pointBox(node->point));
+
+        m_labels.clear(m_cellSize);
+        foreach (SceneLabel *label, m_scene->labels)
+            m_labels.insert(label, pointBox(label->point));
+
+        m_isDirty = false;
+        m_isEdgesDirty = true;
+    }
+}
+
+void SceneIndex::updateEdges()
+{
+    update();
+
+    if (m_isEdgesDirty)
+    {
+        m_edges.clear(m_cellSize);
+        foreach (SceneEdge *edge, m_scene->edges)
+            m_edges.insert(edge, edgeBox(edge));
+
+        m_isEdgesDirty = false;
+    }
+}
+
+void SceneIndex::checkGrowth()
+{
+    // cell size is not suitable anymore
+    if (m_nodes.count() + m_labels.count() > 2 * m_rebuildCount + 16)
+        m_isDirty = true;
+}
+
+void SceneIndex::addNode(SceneNode *node)
+{
+    if (m_isDirty)
+        return;
+
+    m_nodes.insert(node, pointBox(node->point));
+    checkGrowth();
+}
+
+void SceneIndex::removeNode(SceneNode *node)
+{
+    m_nodes.remove(node);
+}
+
+void SceneIndex::moveNode(SceneNode *node, const Point &point)
+{
+    bool isIndexed = m_nodes.contains(node);
+    Point pointPrevious = node->point;
+
+    node->point = point;
+    if (isIndexed)
+        m_nodes.insert(node, pointBox(node->point));
+
+    // edges of the node are re-inserted (their boxes contain the previous point)
+    if (!m_isDirty && !m_isEdgesDirty)
+        foreach (SceneEdge *edge, m_edges.items(pointBox(pointPrevious)))
+            if (edge->nodeStart == node || edge->nodeEnd == node)
+                m_edges.insert(edge, edgeBox(edge));
+}
+
+void SceneIndex::addEdge(SceneEdge *edge)
+{
+    if (m_isDirty || m_isEdgesDirty)
+        return;
+
+    m_edges.insert(edge, edgeBox(edge));
+}
+
+void SceneIndex::removeEdge(SceneEdge *edge)
+{
+    m_edges.remove(edge);
+}
+
+void SceneIndex::addLabel(SceneLabel *label)
+{
+    if (m_isDirty)
+        return;
+
+    m_labels.insert(label, pointBox(label->point));
+    checkGrowth();
+}
+
+void SceneIndex::removeLabel(SceneLabel *label)
+{
+    m_labels.remove(label);
+}
+
+void SceneIndex::moveLabel(SceneLabel *label, const Point &point)
+{
+    bool isIndexed = m_labels.contains(label);
+
+    label->point = point;
+    if (isIndexed)
+        m_labels.insert(label, pointBox(label->point));
+}
+
+SceneNode *SceneIndex::node(const Point &point)
+{
+    update();
+
+    RectPoint box(Point(point.x - EPS_ZERO, point.y - EPS_ZERO), Point(point.x + EPS_ZERO, point.y + EPS_ZERO));
+    foreach (SceneNode *node, m_nodes.items(box))
+        if (node->point == point)
+            return node;
+
+    return NULL;
+}
+
+SceneLabel *SceneIndex::label(const Point &point)
+{
+    update();
+
+    RectPoint box(Point(point.x - EPS_ZERO, point.y - EPS_ZERO), Point(point.x + EPS_ZERO, point.y + EPS_ZERO));
+    foreach (SceneLabel *label, m_labels.items(box))
+        if (label->point == point)
+            return label;
+
+    return NULL;
+}
+
+QList<SceneEdge *> SceneIndex::edges(const Point &point)
+{
+    updateEdges();
+
+    return m_edges.items(RectPoint(Point(point.x - EPS_ZERO, point.y - EPS_ZERO), Point(point.x + EPS_ZERO, point.y + EPS_ZERO)));
+}
+
+SceneNode *SceneIndex::closestNode(const Point &point)
+{
+    update();
+
+    return m_nodes.closest(point);
+}
+
+SceneEdge *SceneIndex::closestEdge(const Point &point)
+{
+    updateEdges();
+
+    return m_edges.closest(point);
+}
+
+SceneLabel *SceneIndex::closestLabel(const Point &point)
+{
+    update();
+
+    return m_labels.closest(point);
+}
+
+QList<SceneNode *> SceneIndex::nodes(const RectPoint &rect)
+{
+    update();
+
+    return m_nodes.items(rect);
+}
+
+QList<SceneEdge *> SceneIndex::edges(const RectPoint &rect)
+{
+    updateEdges();
+
+    return m_edges.items(rect);
+}
+
+QList<SceneLabel *> SceneIndex::labels(const RectPoint &rect)
+{
+    update();
+
+    return m_labels.items(rect);
+}
@@ -0,0 +1,121 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SCENEINDEX_H
+#define SCENEINDEX_H
+
+#include "util.h"
+
+class Scene;
+class SceneNode;
+class SceneEdge;
+class SceneLabel;
+
+// Uniform grid of buckets (sparse), items are stored in all cells overlapped by their box.
+// Items overlapping too many cells are kept in a separate list.
+template <typename T>
+class SceneIndexGrid
+{
+public:
+    SceneIndexGrid();
+
+    void clear(double cellSize);
+    void insert(T *item, const RectPoint &box);
+    void remove(T *item);
+
+    inline bool contains(T *item) const { return m_boxes.contains(item); }
+    inline int count() const { return m_boxes.count(); }
+
+    // items with the box overlapping the box (no duplicates)
+    QList<T *> items(const RectPoint &box) const;
+    // item with the minimal distance (T::distance())
+    T *closest(const Point &point) const;
+
+private:
+    double m_cellSize;
+
+    // occupied cells
+    int m_minI, m_maxI, m_minJ, m_maxJ;
+
+    QHash<QPair<int, int>, QList<T *> > m_cells;
+    QHash<T *, RectPoint> m_boxes;
+    QList<T *> m_large;
+
+    inline int cell(double x) const { return int(floor(x / m_cellSize)); }
+    bool isLarge(const RectPoint &box) const;
+};
+
+// Spatial index of the geometry (nodes, edges and labels) of the scene.
+// It is updated incrementally by the scene and rebuilt lazily when invalidated.
+class SceneIndex
+{
+public:
+    SceneIndex(Scene *scene);
+
+    void clear();
+    // rebuild before the next query
+    void invalidate();
+    // edges are rebuilt before the next query (moved nodes, edited edges)
+    void invalidateEdges();
+
+    void addNode(SceneNode *node);
+    void removeNode(SceneNode *node);
+    void moveNode(SceneNode *node, const Point &point);
+
+    void addEdge(SceneEdge *edge);
+    void removeEdge(SceneEdge *edge);
+
+    void addLabel(SceneLabel *label);
+    void removeLabel(SceneLabel *label);
+    void moveLabel(SceneLabel *label, const Point &point);
+
+    // items in the point (Point::operator==)
+    SceneNode *node(const Point &point);
+    SceneLabel *label(const Point &point);
+    // edges with the bounding box containing the point
+    QList<SceneEdge *> edges(const Point &point);
+
+    SceneNode *closestNode(const Point &point);
+    SceneEdge *closestEdge(const Point &point);
+    SceneLabel *closestLabel(const Point &point);
+
+    // candidates with the bounding box overlapping the rectangle
+    QList<SceneNode *> nodes(const RectPoint &rect);
+    QList<SceneEdge *> edges(const RectPoint &rect);
+    QList<SceneLabel *> labels(const RectPoint &rect);
+
+private:
+    Scene *m_scene;
+
+    bool m_isDirty;
+    bool m_isEdgesDirty;
+    int m_rebuildCount;
+    double m_cellSize;
+
+    SceneIndexGrid<SceneNode> m_nodes;
+    SceneIndexGrid<SceneEdge> m_edges;
+    SceneIndexGrid<SceneLabel> m_labels;
+
+    // nodes and labels (the edge queries rebuild the edges as well)
+    void update();
+    void updateEdges();
+    void checkGrowth();
+};
+
+#endif // SCENEINDEX_H
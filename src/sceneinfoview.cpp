@@ -181,6 +181,11 @@ void SceneInfoView::doInvalidated()
     // analysis
     QTreeWidgetItem *itemAnalysisType = new QTreeWidgetItem(problemInfoGeneralNode);
     itemAnalysisType->setText(0, tr("Analysis: ") + analysisTypeString(Util::scene()->problemInfo()->analysisType));
+    if (Util::scene()->problemInfo()->analysisType == AnalysisType_Transient)
+    {
+        QTreeWidgetItem *itemTimeStepMethod = new QTreeWidgetItem(problemInfoGeneralNode);
+        itemTimeStepMethod->setText(0, tr("Time step method: ") + timeStepMethodString(Util::scene()->problemInfo()->timeStepMethod));
+    }
     // linearity
     QTreeWidgetItem *itemLinearity = new QTreeWidgetItem(problemInfoGeneralNode);
     itemLinearity->setText(0, tr("Linearity: ") + linearityString(Util::scene()->problemInfo()->linearity));
@@ -18,6 +18,10 @@
 // Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
 
 #include "scenesolution.h"
+#include "movingband.h"
+#include "hermes2d/checkpoint.h"
+
+const int VIEW_CACHE_SIZE = 256 * 1024 * 1024; // memory budget of the view cache (bytes)
 
 SceneSolution::SceneSolution()
 {
@@ -25,17 +29,26 @@ SceneSolution::SceneSolution()
     m_isSolving = false;
 
     m_meshInitial = NULL;
+    m_movingBand = NULL;
     m_solutionArrayList = NULL;
     m_slnContourView = NULL;
     m_slnScalarView = NULL;
     m_slnVectorXView = NULL;
     m_slnVectorYView = NULL;   
+
+    m_linContourView = &m_linEmpty;
+    m_linScalarView = &m_linEmpty;
+    m_vecVectorView = &m_vecEmpty;
 }
 
-void SceneSolution::clear()
+void SceneSolution::clear(bool keepMesh)
 {
     m_timeStep = -1;
 
+    // view cache
+    m_scalarViewTiles.clear();
+    clearViewCache();
+
     // solution array
     if (m_solutionArrayList)
     {
@@ -47,10 +60,15 @@ void SceneSolution::clear()
     }
 
     // mesh
-    if (m_meshInitial)
+    if (!keepMesh)
     {
-        delete m_meshInitial;
-        m_meshInitial = NULL;
+        if (m_meshInitial)
+        {
+            delete m_meshInitial;
+            m_meshInitial = NULL;
+        }
+
+        setMovingBand(NULL);
     }
 
     // countour
@@ -85,20 +103,28 @@ void SceneSolution::solve(SolverMode solverMode)
     if (isSolving()) return;
 
     // clear problem
-    clear();
+    clear(solverMode == SolverMode_Solve);
+    m_solverInfo.clear();
 
     m_isSolving = true;
 
-    // save problem
-    ErrorResult result = Util::scene()->writeToFile(tempProblemFileName() + ".a2d");
-    if (result.isError())
-        result.showDialog();
+    // initial mesh is restored from the checkpoint (errors are reported by the solver)
+    if (solverMode == SolverMode_Resume)
+    {
+        Checkpoint checkpoint(Checkpoint::checkpointFileName());
+        if (checkpoint.readHeader())
+        {
+            writeScratchContent("mesh", checkpoint.meshInitial());
+            setMeshInitial(readMeshFromString(checkpoint.meshInitial()));
+        }
+    }
 
     ProgressDialog progressDialog;
-    progressDialog.appendProgressItem(new ProgressItemMesh());
-    if (solverMode == SolverMode_MeshAndSolve)
+    if ((solverMode == SolverMode_Mesh) || (solverMode == SolverMode_MeshAndSolve))
+        progressDialog.appendProgressItem(new ProgressItemMesh());
+    if ((solverMode == SolverMode_MeshAndSolve) || (solverMode == SolverMode_Solve) || (solverMode == SolverMode_Resume))
     {
-        progressDialog.appendProgressItem(new ProgressItemSolve());
+        progressDialog.appendProgressItem(new ProgressItemSolve(solverMode == SolverMode_Resume));
         progressDialog.appendProgressItem(new ProgressItemProcessView());
     }
 
@@ -109,27 +135,27 @@ void SceneSolution::solve(SolverMode solverMode)
         emit solved();
     }
 
-    // delete temp file
-    if (Util::scene()->problemInfo()->fileName == tempProblemFileName() + ".a2d")
-    {
-        QFile::remove(Util::scene()->problemInfo()->fileName);
-        Util::scene()->problemInfo()->fileName = "";
-    }
-
     m_isSolving = false;
 }
 
+void SceneSolution::setMovingBand(MovingBand *movingBand)
+{
+    if (m_movingBand)
+        delete m_movingBand;
+
+    m_movingBand = movingBand;
+}
+
 void SceneSolution::loadMeshInitial(QDomElement *element)
 {
     QDomText text = element->childNodes().at(0).toText();
 
-    // write content (saved mesh)
-    QString fileName = tempProblemFileName() + ".mesh";
+    // saved mesh (in memory)
     QByteArray content;
     content.append(text.nodeValue());
-    writeStringContentByteArray(fileName, QByteArray::fromBase64(content));
+    writeScratchContent("mesh", QByteArray::fromBase64(content));
 
-    Mesh *mesh = readMeshFromFile(tempProblemFileName() + ".mesh");
+    Mesh *mesh = readMeshFromString(readScratchContent("mesh"));
 
     setMeshInitial(mesh);
 }
@@ -158,7 +184,7 @@ void SceneSolution::loadSolution(QDomElement *element)
         Util::scene()->problemInfo()->initialCondition.evaluate(true);
 
         SolutionArray *solutionArray = new SolutionArray();
-        solutionArray->order = new Orderizer();
+        solutionArray->order = QSharedPointer<Orderizer>(new Orderizer());
         solutionArray->sln = new Solution();
         solutionArray->sln->set_const(Util::scene()->sceneSolution()->meshInitial(), Util::scene()->problemInfo()->initialCondition.number);
         solutionArray->adaptiveError = 0.0;
@@ -309,6 +335,10 @@ void SceneSolution::setSolutionArrayList(QList<SolutionArray *> *solutionArrayLi
 
     m_solutionArrayList = solutionArrayList;
 
+    // cached views belong to the old solutions
+    m_scalarViewTiles.clear();
+    clearViewCache();
+
     // if (!isSolving())
     setTimeStep(timeStepCount() - 1);
 }
@@ -320,9 +350,6 @@ void SceneSolution::setTimeStep(int timeStep, bool showViewProgress)
     m_timeStep = timeStep;
     if (!isSolved()) return;
 
-    if (Util::scene()->problemInfo()->hermes()->vectorPhysicFieldVariable() != PhysicFieldVariable_Undefined)
-        m_vec.process_solution(sln(), H2D_FN_DX_0, sln(), H2D_FN_DY_0, H2D_EPS_NORMAL);
-
     emit timeStepChanged(showViewProgress);
 }
 
@@ -341,7 +368,39 @@ double SceneSolution::time()
     return 0.0;
 }
 
-void SceneSolution::setSlnContourView(ViewScalarFilter *slnScalarView)
+void SceneSolution::timeDerivative(double *coeffs)
+{
+    for (int i = 0; i < 3; i++)
+        coeffs[i] = 0.0;
+
+    if (isSolved() && m_timeStep > 0)
+    {
+        int numberOfSolution = Util::scene()->problemInfo()->hermes()->numberOfSolution();
+
+        SolutionArray *actual = m_solutionArrayList->value(m_timeStep * numberOfSolution);
+        SolutionArray *previous = m_solutionArrayList->value((m_timeStep - 1) * numberOfSolution);
+        if (!actual)
+            return;
+
+        if (actual->derivative[0] != 0.0)
+        {
+            // the first step is implicit Euler (derivative[2] is zero)
+            for (int i = 0; i < 3; i++)
+                coeffs[i] = actual->derivative[i];
+            return;
+        }
+
+        // solution without the coefficients (older file) - implicit Euler
+        double timeStepLength = Util::scene()->problemInfo()->timeStep.number;
+        if (previous && actual->time > previous->time)
+            timeStepLength = actual->time - previous->time;
+
+        coeffs[0] = 1.0 / timeStepLength;
+        coeffs[1] = - 1.0 / timeStepLength;
+    }
+}
+
+void SceneSolution::setSlnContourView(ViewScalarFilter *slnScalarView, const ViewCacheKey &key)
 {
     if (m_slnContourView)
     {
@@ -350,11 +409,23 @@ void SceneSolution::setSlnContourView(ViewScalarFilter *slnScalarView)
     }
     
     m_slnContourView = slnScalarView;
-    m_linContourView.process_solution(m_slnContourView);
+
+    m_linContourView = viewCache(key);
+    if (!m_linContourView)
+    {
+        m_linContourView = new Linearizer();
+        m_linContourView->set_num_threads(QThread::idealThreadCount());
+        m_linContourView->process_solution(m_slnContourView, H2D_FN_VAL_0, key.tolerance);
+
+        appendViewCache(key, m_linContourView);
+    }
 }
 
-void SceneSolution::setSlnScalarView(ViewScalarFilter *slnScalarView)
+void SceneSolution::setSlnScalarView(ViewScalarFilter *slnScalarView, const ViewCacheKey &key)
 {
+    // tiles use the old filter
+    m_scalarViewTiles.clear();
+
     if (m_slnScalarView)
     {
         delete m_slnScalarView;
@@ -362,16 +433,27 @@ void SceneSolution::setSlnScalarView(ViewScalarFilter *slnScalarView)
     }
     
     m_slnScalarView = slnScalarView;
-    m_linScalarView.process_solution(m_slnScalarView, H2D_FN_VAL_0);
+
+    m_linScalarView = viewCache(key);
+    if (m_linScalarView)
+    {
+        m_scalarViewTiles.setFilter(m_slnScalarView, qMax(fabs(m_linScalarView->get_min_value()),
+                                                          fabs(m_linScalarView->get_max_value())), key.tolerance);
+        return;
+    }
+
+    m_linScalarView = new Linearizer();
+    m_linScalarView->set_num_threads(QThread::idealThreadCount());
+    m_linScalarView->process_solution(m_slnScalarView, H2D_FN_VAL_0, key.tolerance);
 
     // deformed shape
     if (Util::scene()->problemInfo()->physicField() == PhysicField_Elasticity)
     {
-        double3* linVert = m_linScalarView.get_vertices();
+        double3* linVert = m_linScalarView->get_vertices();
 
         double min =  CONST_DOUBLE;
         double max = -CONST_DOUBLE;
-        for (int i = 0; i < m_linScalarView.get_num_vertices(); i++)
+        for (int i = 0; i < m_linScalarView->get_num_vertices(); i++)
         {
             double x = linVert[i][0];
             double y = linVert[i][1];
@@ -388,7 +470,7 @@ void SceneSolution::setSlnScalarView(ViewScalarFilter *slnScalarView)
         RectPoint rect = Util::scene()->boundingBox();
         double k = qMax(rect.width(), rect.height()) / qMax(min, max) / 15.0;
 
-        for (int i = 0; i < m_linScalarView.get_num_vertices(); i++)
+        for (int i = 0; i < m_linScalarView->get_num_vertices(); i++)
         {
             double x = linVert[i][0];
             double y = linVert[i][1];
@@ -400,9 +482,15 @@ void SceneSolution::setSlnScalarView(ViewScalarFilter *slnScalarView)
             linVert[i][1] += k*dy;
         }
     }
+
+    appendViewCache(key, m_linScalarView);
+
+    // view dependent refinement (same range as the global linearization)
+    m_scalarViewTiles.setFilter(m_slnScalarView, qMax(fabs(m_linScalarView->get_min_value()),
+                                                      fabs(m_linScalarView->get_max_value())), key.tolerance);
 }
 
-void SceneSolution::setSlnVectorView(ViewScalarFilter *slnVectorXView, ViewScalarFilter *slnVectorYView)
+void SceneSolution::setSlnVectorView(ViewScalarFilter *slnVectorXView, ViewScalarFilter *slnVectorYView, const ViewCacheKey &key)
 {
     if (m_slnVectorXView)
     {
@@ -418,7 +506,16 @@ void SceneSolution::setSlnVectorView(ViewScalarFilter *slnVectorXView, ViewScala
     m_slnVectorXView = slnVectorXView;
     m_slnVectorYView = slnVectorYView;
     
-    m_vecVectorView.process_solution(m_slnVectorXView, H2D_FN_VAL_0, m_slnVectorYView, H2D_FN_VAL_0, H2D_EPS_LOW);
+
+    m_vecVectorView = static_cast<Vectorizer *>(viewCache(key));
+    if (!m_vecVectorView)
+    {
+        m_vecVectorView = new Vectorizer();
+        m_vecVectorView->set_num_threads(QThread::idealThreadCount());
+        m_vecVectorView->process_solution(m_slnVectorXView, H2D_FN_VAL_0, m_slnVectorYView, H2D_FN_VAL_0, key.tolerance);
+
+        appendViewCache(key, m_vecVectorView);
+    }
 }
 
 void SceneSolution::processRangeContour()
@@ -427,7 +524,7 @@ void SceneSolution::processRangeContour()
     {
         ViewScalarFilter *viewScalarFilter = Util::scene()->problemInfo()->hermes()->viewScalarFilter(sceneView()->sceneViewSettings().contourPhysicFieldVariable,
                                                                                                       PhysicFieldVariableComp_Scalar);
-        setSlnContourView(viewScalarFilter);
+        setSlnContourView(viewScalarFilter, viewCacheKey(ViewCacheType_Contour));
         emit processedRangeContour();
     }
 }
@@ -438,7 +535,7 @@ void SceneSolution::processRangeScalar()
     {
         ViewScalarFilter *viewScalarFilter = Util::scene()->problemInfo()->hermes()->viewScalarFilter(sceneView()->sceneViewSettings().scalarPhysicFieldVariable,
                                                                                                       sceneView()->sceneViewSettings().scalarPhysicFieldVariableComp);
-        setSlnScalarView(viewScalarFilter);
+        setSlnScalarView(viewScalarFilter, viewCacheKey(ViewCacheType_Scalar));
         emit processedRangeScalar();
     }
 }
@@ -453,7 +550,149 @@ void SceneSolution::processRangeVector()
         ViewScalarFilter *viewVectorYFilter = Util::scene()->problemInfo()->hermes()->viewScalarFilter(sceneView()->sceneViewSettings().vectorPhysicFieldVariable,
                                                                                                        PhysicFieldVariableComp_Y);
 
-        setSlnVectorView(viewVectorXFilter, viewVectorYFilter);
+        setSlnVectorView(viewVectorXFilter, viewVectorYFilter, viewCacheKey(ViewCacheType_Vector));
         emit processedRangeVector();
     }
 }
+
+ViewCacheKey SceneSolution::viewCacheKey(ViewCacheType type)
+{
+    ViewCacheKey key;
+    key.type = type;
+    key.timeStep = m_timeStep;
+
+    switch (type)
+    {
+    case ViewCacheType_Contour:
+        key.physicFieldVariable = sceneView()->sceneViewSettings().contourPhysicFieldVariable;
+        key.physicFieldVariableComp = PhysicFieldVariableComp_Scalar;
+        key.tolerance = H2D_EPS_NORMAL;
+        break;
+    case ViewCacheType_Scalar:
+        key.physicFieldVariable = sceneView()->sceneViewSettings().scalarPhysicFieldVariable;
+        key.physicFieldVariableComp = sceneView()->sceneViewSettings().scalarPhysicFieldVariableComp;
+        key.tolerance = H2D_EPS_NORMAL;
+        break;
+    case ViewCacheType_Vector:
+        key.physicFieldVariable = sceneView()->sceneViewSettings().vectorPhysicFieldVariable;
+        key.physicFieldVariableComp = PhysicFieldVariableComp_Undefined;
+        key.tolerance = H2D_EPS_LOW;
+        break;
+    }
+
+    return key;
+}
+
+bool SceneSolution::isViewCached(ViewCacheType type)
+{
+    ViewCacheKey key = viewCacheKey(type);
+    for (int i = 0; i < m_viewCache.count(); i++)
+        if (m_viewCache[i].key == key)
+            return true;
+
+    return false;
+}
+
+Linearizer *SceneSolution::viewCache(const ViewCacheKey &key)
+{
+    for (int i = 0; i < m_viewCache.count(); i++)
+    {
+        if (m_viewCache[i].key == key)
+        {
+            // most recently used
+            m_viewCache.move(i, 0);
+            return m_viewCache[0].linearizer;
+        }
+    }
+
+    return NULL;
+}
+
+void SceneSolution::appendViewCache(const ViewCacheKey &key, Linearizer *linearizer)
+{
+    ViewCacheItem item;
+    item.key = key;
+    item.linearizer = linearizer;
+    item.contours = NULL;
+    item.glyphs = NULL;
+    item.size = linearizer->get_num_triangles() * (sizeof(int3) + sizeof(int)) +
+            linearizer->get_num_vertices() * ((key.type == ViewCacheType_Vector) ? sizeof(double4) : sizeof(double3));
+    m_viewCache.prepend(item);
+
+    int size = 0;
+    for (int i = 0; i < m_viewCache.count(); i++)
+        size += m_viewCache[i].size;
+
+    // drop the least recently used views (the current ones are kept)
+    for (int i = m_viewCache.count() - 1; i >= 0 && size > VIEW_CACHE_SIZE; i--)
+    {
+        Linearizer *linearizer = m_viewCache[i].linearizer;
+        if (linearizer == m_linContourView || linearizer == m_linScalarView || linearizer == m_vecVectorView)
+            continue;
+
+        size -= m_viewCache[i].size;
+        delete linearizer;
+        if (m_viewCache[i].contours)
+            delete m_viewCache[i].contours;
+        if (m_viewCache[i].glyphs)
+            delete m_viewCache[i].glyphs;
+        m_viewCache.removeAt(i);
+    }
+}
+
+void SceneSolution::clearViewCache()
+{
+    for (int i = 0; i < m_viewCache.count(); i++)
+    {
+        delete m_viewCache[i].linearizer;
+        if (m_viewCache[i].contours)
+            delete m_viewCache[i].contours;
+        if (m_viewCache[i].glyphs)
+            delete m_viewCache[i].glyphs;
+    }
+    m_viewCache.clear();
+
+    m_linContourView = &m_linEmpty;
+    m_linScalarView = &m_linEmpty;
+    m_vecVectorView = &m_vecEmpty;
+}
+
+Contours &SceneSolution::contours()
+{
+    for (int i = 0; i < m_viewCache.count(); i++)
+    {
+        ViewCacheItem &item = m_viewCache[i];
+        if (item.linearizer != m_linContourView)
+            continue;
+
+        // iso-lines are cached with the contour view
+        if (!item.contours)
+            item.contours = new Contours();
+        if (item.contours->count() != Util::config()->contoursCount)
+            item.contours->process(m_linContourView, Util::config()->contoursCount);
+
+        return *item.contours;
+    }
+
+    return m_contoursEmpty;
+}
+
+VectorGlyphs &SceneSolution::vectorGlyphs()
+{
+    for (int i = 0; i < m_viewCache.count(); i++)
+    {
+        ViewCacheItem &item = m_viewCache[i];
+        if (item.linearizer != m_vecVectorView)
+            continue;
+
+        // vectors are cached with the vector view
+        if (!item.glyphs)
+            item.glyphs = new VectorGlyphs();
+        if (item.glyphs->count() != Util::config()->vectorCount)
+            item.glyphs->process(m_vecVectorView, Util::scene()->boundingBox(), Util::config()->vectorCount);
+
+        return *item.glyphs;
+    }
+
+    return m_glyphsEmpty;
+}
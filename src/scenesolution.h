@@ -24,14 +24,53 @@
 #include "hermes2d.h"
 #include "scene.h"
 #include "scenemarker.h"
+#include "scalarviewtiles.h"
+#include "contours.h"
+#include "vectorglyphs.h"
+#include "solverinfo.h"
 
 class Scene;
 class SceneLabelMarker;
 
 class ViewScalarFilter;
+class MovingBand;
 
 struct SolutionArray;
 
+enum ViewCacheType
+{
+    ViewCacheType_Contour,
+    ViewCacheType_Scalar,
+    ViewCacheType_Vector
+};
+
+// view product (linearizer or vectorizer) of one time step
+struct ViewCacheKey
+{
+    ViewCacheType type;
+    int timeStep;
+    PhysicFieldVariable physicFieldVariable;
+    PhysicFieldVariableComp physicFieldVariableComp;
+    double tolerance;
+
+    inline bool operator==(const ViewCacheKey &key) const
+    {
+        return (type == key.type && timeStep == key.timeStep &&
+                physicFieldVariable == key.physicFieldVariable &&
+                physicFieldVariableComp == key.physicFieldVariableComp &&
+                tolerance == key.tolerance);
+    }
+};
+
+struct ViewCacheItem
+{
+    ViewCacheKey key;
+    Linearizer *linearizer;
+    Contours *contours; // iso-lines of the contour view
+    VectorGlyphs *glyphs; // grid of vectors of the vector view
+    int size; // memory (bytes)
+};
+
 class Solution;
 class Linearizer;
 class Vectorizer;
@@ -45,7 +84,7 @@ class SceneSolution : public QObject
 public:
     SceneSolution();
 
-    void clear();
+    void clear(bool keepMesh = false);
     void loadMeshInitial(QDomElement *element);
     void saveMeshInitial(QDomDocument *doc, QDomElement *element);
     void loadSolution(QDomElement *element);
@@ -61,26 +100,41 @@ public:
     inline int timeStep() { return m_timeStep; }
     int timeStepCount();
     double time();
+    // time derivative of the actual step (the same formula as the time stepping method)
+    //   du/dt = coeffs[0] u(n) + coeffs[1] u(n-1) + coeffs[2] u(n-2)
+    void timeDerivative(double *coeffs);
 
     bool isSolved() { return (m_timeStep != -1); }
     bool isMeshed() { return m_meshInitial; }
     bool isSolving() { return m_isSolving; }
 
+    // moving band (rotor positions)
+    inline MovingBand *movingBand() { return m_movingBand; }
+    void setMovingBand(MovingBand *movingBand);
+
     // contour
     inline ViewScalarFilter *slnContourView() { return m_slnContourView; }
-    void setSlnContourView(ViewScalarFilter *slnScalarView);
-    inline Linearizer &linContourView() { return m_linContourView; }
+    void setSlnContourView(ViewScalarFilter *slnScalarView, const ViewCacheKey &key);
+    inline Linearizer &linContourView() { return *m_linContourView; }
+    Contours &contours();
 
     // scalar view
     inline ViewScalarFilter *slnScalarView() { return m_slnScalarView; }
-    void setSlnScalarView(ViewScalarFilter *slnScalarView);
-    inline Linearizer &linScalarView() { return m_linScalarView; }
+    void setSlnScalarView(ViewScalarFilter *slnScalarView, const ViewCacheKey &key);
+    inline Linearizer &linScalarView() { return *m_linScalarView; }
+    inline ScalarViewTiles *scalarViewTiles() { return &m_scalarViewTiles; }
 
     // vector view
-    void setSlnVectorView(ViewScalarFilter *slnVectorXView, ViewScalarFilter *slnVectorYView);
+    void setSlnVectorView(ViewScalarFilter *slnVectorXView, ViewScalarFilter *slnVectorYView, const ViewCacheKey &key);
     inline ViewScalarFilter *slnVectorViewX() { return m_slnVectorXView; }
     inline ViewScalarFilter *slnVectorViewY() { return m_slnVectorYView; }
-    inline Vectorizer &vecVectorView() { return m_vecVectorView; }
+    inline Vectorizer &vecVectorView() { return *m_vecVectorView; }
+    VectorGlyphs &vectorGlyphs();
+
+    // view cache (keeps recently viewed time steps)
+    ViewCacheKey viewCacheKey(ViewCacheType type);
+    bool isViewCached(ViewCacheType type);
+    void clearViewCache();
 
     // order view
     Orderizer &ordView();
@@ -89,6 +143,7 @@ public:
     double adaptiveError();
     int adaptiveSteps();
     inline int setTimeElapsed(int timeElapsed) { m_timeElapsed = timeElapsed; }
+    inline SolverInfo &solverInfo() { return m_solverInfo; }
 
     int findTriangleInMesh(Mesh *mesh, const Point &point);
     int findTriangleInVectorizer(const Vectorizer &vecVectorView, const Point &point);
@@ -109,6 +164,7 @@ signals:
 
 private:
     int m_timeElapsed;
+    SolverInfo m_solverInfo;
     bool m_isSolving;
 
     // general solution array
@@ -117,20 +173,30 @@ private:
 
     // contour
     ViewScalarFilter *m_slnContourView; // scalar view solution
-    Linearizer m_linContourView;
+    Linearizer *m_linContourView;
 
     // scalar view
     ViewScalarFilter *m_slnScalarView; // scalar view solution
-    Linearizer m_linScalarView; // linealizer for scalar view
+    Linearizer *m_linScalarView; // linealizer for scalar view
+    ScalarViewTiles m_scalarViewTiles; // view dependent refinement of the scalar view
 
     // vector view
     ViewScalarFilter *m_slnVectorXView; // vector view solution - x
     ViewScalarFilter *m_slnVectorYView; // vector view solution - y
-    Vectorizer m_vecVectorView; // vectorizer for vector view
+    Vectorizer *m_vecVectorView; // vectorizer for vector view
+
+    // view cache (most recently used first)
+    QList<ViewCacheItem> m_viewCache;
+    Linearizer m_linEmpty;
+    Vectorizer m_vecEmpty;
+    Contours m_contoursEmpty;
+    VectorGlyphs m_glyphsEmpty;
 
     Mesh *m_meshInitial; // linearizer only for mesh (on empty solution)
+    MovingBand *m_movingBand;
 
-    Vectorizer m_vec;
+    Linearizer *viewCache(const ViewCacheKey &key);
+    void appendViewCache(const ViewCacheKey &key, Linearizer *linearizer);
 };
 
 #endif // SCENESOLUTION_H
@@ -97,6 +97,7 @@ SceneView::SceneView(QWidget *parent): QGLWidget(QGLFormat(QGL::SampleBuffers),
     connect(m_scene->sceneSolution(), SIGNAL(processedRangeScalar()), this, SLOT(processedRangeScalar()));
     connect(m_scene->sceneSolution(), SIGNAL(processedRangeVector()), this, SLOT(processedRangeVector()));
     connect(m_scene->sceneSolution(), SIGNAL(meshed()), this, SLOT(clearGLLists()));
+    connect(m_scene->sceneSolution()->scalarViewTiles(), SIGNAL(refined()), this, SLOT(doScalarViewRefined()));
 
     connect(m_scene, SIGNAL(invalidated()), this, SLOT(doInvalidated()));
     connect(m_scene, SIGNAL(defaultValues()), this, SLOT(doDefaultValues()));
@@ -461,6 +462,14 @@ void SceneView::clearGLLists()
     m_listModel = -1;
 }
 
+void SceneView::doScalarViewRefined()
+{
+    if (m_listScalarField != -1) glDeleteLists(m_listScalarField, 1);
+    m_listScalarField = -1;
+
+    updateGL();
+}
+
 // paint *****************************************************************************************************************************
 
 void SceneView::paintBackground()
@@ -1132,6 +1141,11 @@ void SceneView::paintScalarField()
 
     loadProjection2d(true);
 
+    // visible area and size of the pixel for the view dependent refinement
+    RectPoint viewport(Point(m_offset2d.x - aspect()/m_scale2d, m_offset2d.y - 1.0/m_scale2d),
+                       Point(m_offset2d.x + aspect()/m_scale2d, m_offset2d.y + 1.0/m_scale2d));
+    m_scene->sceneSolution()->scalarViewTiles()->setViewport(viewport, 2.0/(m_scale2d*contextHeight()));
+
     if (m_listScalarField == -1)
     {
         qDebug() << "SceneView::paintScalarField(), min = " << m_sceneViewSettings.scalarRangeMin << ", max = " << m_sceneViewSettings.scalarRangeMax;
@@ -1145,13 +1159,6 @@ void SceneView::paintScalarField()
         if (fabs(m_sceneViewSettings.scalarRangeMax - m_sceneViewSettings.scalarRangeMin) < EPS_ZERO)
             irange = 1.0;
 
-        m_scene->sceneSolution()->linScalarView().lock_data();
-
-        double3* linVert = m_scene->sceneSolution()->linScalarView().get_vertices();
-        int3* linTris = m_scene->sceneSolution()->linScalarView().get_triangles();
-        Point point[3];
-        double value[3];
-
         // set texture for coloring
         glEnable(GL_TEXTURE_1D);
         glBindTexture(GL_TEXTURE_1D, 1);
@@ -1163,33 +1170,19 @@ void SceneView::paintScalarField()
         glTranslated(m_texShift, 0.0, 0.0);
         glScaled(m_texScale, 0.0, 0.0);
 
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_scene->sceneSolution()->linScalarView().get_num_triangles(); i++)
+        // coarse triangles of the refined tiles are skipped (base linearization matches the tile borders)
+        ScalarViewTiles *tiles = m_scene->sceneSolution()->scalarViewTiles();
+        if (tiles->base())
         {
-            for (int j = 0; j < 3; j++)
-            {
-                point[j].x = linVert[linTris[i][j]][0];
-                point[j].y = linVert[linTris[i][j]][1];
-                value[j]   = linVert[linTris[i][j]][2];
-            }
-
-            if (!m_sceneViewSettings.scalarRangeAuto)
-            {
-                double avgValue = (value[0] + value[1] + value[2]) / 3.0;
-                if (avgValue < m_sceneViewSettings.scalarRangeMin || avgValue > m_sceneViewSettings.scalarRangeMax)
-                    continue;
-            }
-
-            for (int j = 0; j < 3; j++)
-            {
-                if (Util::config()->scalarRangeLog)
-                    glTexCoord1d(log10(1.0 + (Util::config()->scalarRangeBase-1.0)*(value[j] - m_sceneViewSettings.scalarRangeMin) * irange)/log10(Util::config()->scalarRangeBase));
-                else
-                    glTexCoord1d((value[j] - m_sceneViewSettings.scalarRangeMin) * irange);
-                glVertex2d(point[j].x, point[j].y);
-            }
+            paintScalarFieldTriangles(*tiles->base(), irange, tiles);
+            for (int i = 0; i < tiles->count(); i++)
+                if (tiles->tile(i)->linearizer)
+                    paintScalarFieldTriangles(*tiles->tile(i)->linearizer, irange);
+        }
+        else
+        {
+            paintScalarFieldTriangles(m_scene->sceneSolution()->linScalarView(), irange);
         }
-        glEnd();
 
         glDisable(GL_POLYGON_OFFSET_FILL);
         glDisable(GL_TEXTURE_1D);
@@ -1199,8 +1192,6 @@ void SceneView::paintScalarField()
         glLoadIdentity();
         glMatrixMode(GL_MODELVIEW);
 
-        m_scene->sceneSolution()->linScalarView().unlock_data();
-
         glEndList();
 
         glCallList(m_listScalarField);
@@ -1211,6 +1202,50 @@ void SceneView::paintScalarField()
     }
 }
 
+void SceneView::paintScalarFieldTriangles(Linearizer &linearizer, double irange, ScalarViewTiles *tiles)
+{
+    linearizer.lock_data();
+
+    double3* linVert = linearizer.get_vertices();
+    int3* linTris = linearizer.get_triangles();
+    int* linElem = linearizer.get_triangle_elements();
+    Point point[3];
+    double value[3];
+
+    glBegin(GL_TRIANGLES);
+    for (int i = 0; i < linearizer.get_num_triangles(); i++)
+    {
+        if (tiles && linElem && tiles->isRefined(linElem[i]))
+            continue;
+
+        for (int j = 0; j < 3; j++)
+        {
+            point[j].x = linVert[linTris[i][j]][0];
+            point[j].y = linVert[linTris[i][j]][1];
+            value[j]   = linVert[linTris[i][j]][2];
+        }
+
+        if (!m_sceneViewSettings.scalarRangeAuto)
+        {
+            double avgValue = (value[0] + value[1] + value[2]) / 3.0;
+            if (avgValue < m_sceneViewSettings.scalarRangeMin || avgValue > m_sceneViewSettings.scalarRangeMax)
+                continue;
+        }
+
+        for (int j = 0; j < 3; j++)
+        {
+            if (Util::config()->scalarRangeLog)
+                glTexCoord1d(log10(1.0 + (Util::config()->scalarRangeBase-1.0)*(value[j] - m_sceneViewSettings.scalarRangeMin) * irange)/log10(Util::config()->scalarRangeBase));
+            else
+                glTexCoord1d((value[j] - m_sceneViewSettings.scalarRangeMin) * irange);
+            glVertex2d(point[j].x, point[j].y);
+        }
+    }
+    glEnd();
+
+    linearizer.unlock_data();
+}
+
 void SceneView::paintScalarField3D()
 {
     if (!m_isSolutionPrepared) return;
@@ -1717,30 +1752,10 @@ void SceneView::paintContours()
         m_listContours = glGenLists(1);
         glNewList(m_listContours, GL_COMPILE);
 
-        m_scene->sceneSolution()->linContourView().lock_data();
-
-        double3* tvert = m_scene->sceneSolution()->linContourView().get_vertices();
-        int3* tris = m_scene->sceneSolution()->linContourView().get_triangles();
+        // iso-lines (cached with the contour view)
+        const Contours &contours = m_scene->sceneSolution()->contours();
 
-        // transform variable
-        double rangeMin =  CONST_DOUBLE;
-        double rangeMax = -CONST_DOUBLE;
-
-        double3* vert = new double3[m_scene->sceneSolution()->linContourView().get_num_vertices()];
-        for (int i = 0; i < m_scene->sceneSolution()->linContourView().get_num_vertices(); i++)
-        {
-            vert[i][0] = tvert[i][0];
-            vert[i][1] = tvert[i][1];
-            vert[i][2] = tvert[i][2];
-
-            if (vert[i][2] > rangeMax) rangeMax = tvert[i][2];
-            if (vert[i][2] < rangeMin) rangeMin = tvert[i][2];
-        }
-
-        qDebug() << "SceneView::paintContours(), min = " << rangeMin << ", max = " << rangeMax;
-
-        // value range
-        double step = (rangeMax-rangeMin)/Util::config()->contoursCount;
+        qDebug() << "SceneView::paintContours(), min = " << contours.rangeMin() << ", max = " << contours.rangeMax();
 
         // draw contours
         glLineWidth(1.0);
@@ -1748,19 +1763,15 @@ void SceneView::paintContours()
                   Util::config()->colorContours.greenF(),
                   Util::config()->colorContours.blueF());
 
-        glBegin(GL_LINES);
-        for (int i = 0; i < m_scene->sceneSolution()->linContourView().get_num_triangles(); i++)
+        for (int i = 0; i < contours.polylines().count(); i++)
         {
-            if (finite(vert[tris[i][0]][2]) && finite(vert[tris[i][1]][2]) && finite(vert[tris[i][2]][2]))
-            {
-                paintContoursTri(vert, &tris[i], step);
-            }
-        }
-        glEnd();
-
-        delete vert;
+            const ContourPolyline &polyline = contours.polylines().at(i);
 
-        m_scene->sceneSolution()->linContourView().unlock_data();
+            glBegin(polyline.isClosed ? GL_LINE_LOOP : GL_LINE_STRIP);
+            for (int j = 0; j < polyline.points.count(); j++)
+                glVertex2d(polyline.points[j].x, polyline.points[j].y);
+            glEnd();
+        }
 
         glEndList();
 
@@ -1772,53 +1783,6 @@ void SceneView::paintContours()
     }
 }
 
-void SceneView::paintContoursTri(double3* vert, int3* tri, double step)
-{
-    // sort the vertices by their value, keep track of the permutation sign
-    int i, idx[3], perm = 0;
-    memcpy(idx, tri, sizeof(idx));
-    for (i = 0; i < 2; i++)
-    {
-        if (vert[idx[0]][2] > vert[idx[1]][2]) { std::swap(idx[0], idx[1]); perm++; }
-        if (vert[idx[1]][2] > vert[idx[2]][2]) { std::swap(idx[1], idx[2]); perm++; }
-    }
-    if (fabs(vert[idx[0]][2] - vert[idx[2]][2]) < 1e-3 * fabs(step)) return;
-
-    // get the first (lowest) contour value
-    double val = vert[idx[0]][2];
-
-    double y = ceil(val / step);
-    if (y < val / step) y + 1.0;
-    val = y * step;
-
-    int l1 = 0, l2 = 1;
-    int r1 = 0, r2 = 2;
-    while (val < vert[idx[r2]][2])
-    {
-        double ld = vert[idx[l2]][2] - vert[idx[l1]][2];
-        double rd = vert[idx[r2]][2] - vert[idx[r1]][2];
-
-        // draw a slice of the triangle
-        while (val < vert[idx[l2]][2])
-        {
-            double lt = (val - vert[idx[l1]][2]) / ld;
-            double rt = (val - vert[idx[r1]][2]) / rd;
-
-            double x1 = (1.0 - lt) * vert[idx[l1]][0] + lt * vert[idx[l2]][0];
-            double y1 = (1.0 - lt) * vert[idx[l1]][1] + lt * vert[idx[l2]][1];
-            double x2 = (1.0 - rt) * vert[idx[r1]][0] + rt * vert[idx[r2]][0];
-            double y2 = (1.0 - rt) * vert[idx[r1]][1] + rt * vert[idx[r2]][1];
-
-            if (perm & 1) { glVertex2d(x1, y1); glVertex2d(x2, y2); }
-            else { glVertex2d(x2, y2); glVertex2d(x1, y1); }
-
-            val += step;
-        }
-        l1 = 1;
-        l2 = 2;
-    }
-}
-
 void SceneView::paintVectors()
 {
     if (!m_isSolutionPrepared) return;
@@ -1836,127 +1800,69 @@ void SceneView::paintVectors()
         qDebug() << "SceneView::paintVectors(), min = " << vectorRangeMin << ", max = " << vectorRangeMax;
 
         double irange = 1.0 / (vectorRangeMax - vectorRangeMin);
-        if (fabs(vectorRangeMin - vectorRangeMax) < EPS_ZERO) return;
+        if (fabs(vectorRangeMin - vectorRangeMax) < EPS_ZERO)
+        {
+            glEndList();
+            return;
+        }
 
-        RectPoint rect = m_scene->boundingBox();
-        double gs = (rect.width() + rect.height()) / Util::config()->vectorCount;
+        // interpolated vectors (cached with the vector view)
+        const VectorGlyphs &vectorGlyphs = m_scene->sceneSolution()->vectorGlyphs();
+        const QVector<VectorGlyph> &glyphs = vectorGlyphs.glyphs();
+        double gs = vectorGlyphs.gridStep();
 
-        // paint
-        m_scene->sceneSolution()->vecVectorView().lock_data();
+        // packed geometry (one triangle per vector)
+        QVector<double> vertices(6 * glyphs.count());
+        QVector<float> colors(9 * glyphs.count());
+        for (int i = 0; i < glyphs.count(); i++)
+        {
+            const Point &point = glyphs[i].point;
 
-        double4* vecVert = m_scene->sceneSolution()->vecVectorView().get_vertices();
-        int3* vecTris = m_scene->sceneSolution()->vecVectorView().get_triangles();
+            double value = sqrt(sqr(glyphs[i].dx) + sqr(glyphs[i].dy));
+            double angle = atan2(glyphs[i].dy, glyphs[i].dx);
 
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            double dm;
+            if (Util::config()->vectorProportional)
+                dm = fabs((value - vectorRangeMin) * irange) * Util::config()->vectorScale * gs;
+            else
+                dm = fabs(Util::config()->vectorScale * gs);
 
-        glBegin(GL_TRIANGLES);
-        for (int i = 0; i < m_scene->sceneSolution()->vecVectorView().get_num_triangles(); i++)
-        {
-            Point a(vecVert[vecTris[i][0]][0], vecVert[vecTris[i][0]][1]);
-            Point b(vecVert[vecTris[i][1]][0], vecVert[vecTris[i][1]][1]);
-            Point c(vecVert[vecTris[i][2]][0], vecVert[vecTris[i][2]][1]);
-
-            RectPoint r;
-            r.start = Point(qMin(qMin(a.x, b.x), c.x), qMin(qMin(a.y, b.y), c.y));
-            r.end = Point(qMax(qMax(a.x, b.x), c.x), qMax(qMax(a.y, b.y), c.y));
-
-            // double area
-            double area2 = a.x * (b.y - c.y) + b.x * (c.y - a.y) + c.x * (a.y - b.y);
-
-            // plane equation
-            double aa = b.x*c.y - c.x*b.y;
-            double ab = c.x*a.y - a.x*c.y;
-            double ac = a.x*b.y - b.x*a.y;
-            double ba = b.y - c.y;
-            double bb = c.y - a.y;
-            double bc = a.y - b.y;
-            double ca = c.x - b.x;
-            double cb = a.x - c.x;
-            double cc = b.x - a.x;
-
-            double ax = (aa * vecVert[vecTris[i][0]][2] + ab * vecVert[vecTris[i][1]][2] + ac * vecVert[vecTris[i][2]][2]) / area2;
-            double bx = (ba * vecVert[vecTris[i][0]][2] + bb * vecVert[vecTris[i][1]][2] + bc * vecVert[vecTris[i][2]][2]) / area2;
-            double cx = (ca * vecVert[vecTris[i][0]][2] + cb * vecVert[vecTris[i][1]][2] + cc * vecVert[vecTris[i][2]][2]) / area2;
-
-            double ay = (aa * vecVert[vecTris[i][0]][3] + ab * vecVert[vecTris[i][1]][3] + ac * vecVert[vecTris[i][2]][3]) / area2;
-            double by = (ba * vecVert[vecTris[i][0]][3] + bb * vecVert[vecTris[i][1]][3] + bc * vecVert[vecTris[i][2]][3]) / area2;
-            double cy = (ca * vecVert[vecTris[i][0]][3] + cb * vecVert[vecTris[i][1]][3] + cc * vecVert[vecTris[i][2]][3]) / area2;
-
-            for (int j = floor(r.start.x / gs); j < ceil(r.end.x / gs); j++)
+            // color
+            float color[3];
+            if (Util::config()->vectorColor)
             {
-                for (int k = floor(r.start.y / gs); k < ceil(r.end.y / gs); k++)
-                {
-                    Point point(j*gs, k*gs);
-                    if (k % 2 == 0) point.x += gs/2.0;
-
-                    // find in triangle
-                    bool inTriangle = true;
-
-                    for (int l = 0; l < 3; l++)
-                    {
-                        int p = l + 1;
-                        if (p == 3)
-                            p = 0;
-
-                        double z = (vecVert[vecTris[i][p]][0] - vecVert[vecTris[i][l]][0]) * (point.y - vecVert[vecTris[i][l]][1]) -
-                                   (vecVert[vecTris[i][p]][1] - vecVert[vecTris[i][l]][1]) * (point.x - vecVert[vecTris[i][l]][0]);
-
-                        if (z < 0)
-                        {
-                            inTriangle = false;
-                            break;
-                        }
-                    }
-
-                    if (inTriangle)
-                    {
-                        // view
-                        double dx = ax + bx * point.x + cx * point.y;
-                        double dy = ay + by * point.x + cy * point.y;
-
-                        double value = sqrt(sqr(dx) + sqr(dy));
-                        double angle = atan2(dy, dx);
-
-                        if (Util::config()->vectorProportional)
-                        {
-                            dx = ((value - vectorRangeMin) * irange) * Util::config()->vectorScale * gs * cos(angle);
-                            dy = ((value - vectorRangeMin) * irange) * Util::config()->vectorScale * gs * sin(angle);
-                        }
-                        else
-                        {
-                            dx = Util::config()->vectorScale * gs * cos(angle);
-                            dy = Util::config()->vectorScale * gs * sin(angle);
-                        }
+                color[0] = color[1] = color[2] = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
+            }
+            else
+            {
+                color[0] = Util::config()->colorVectors.redF();
+                color[1] = Util::config()->colorVectors.greenF();
+                color[2] = Util::config()->colorVectors.blueF();
+            }
+            for (int j = 0; j < 3; j++)
+                memcpy(colors.data() + 9*i + 3*j, color, sizeof(color));
 
-                        double dm = sqrt(sqr(dx) + sqr(dy));
+            vertices[6*i + 0] = point.x + dm/5.0 * cos(angle - M_PI_2);
+            vertices[6*i + 1] = point.y + dm/5.0 * sin(angle - M_PI_2);
+            vertices[6*i + 2] = point.x + dm/5.0 * cos(angle + M_PI_2);
+            vertices[6*i + 3] = point.y + dm/5.0 * sin(angle + M_PI_2);
+            vertices[6*i + 4] = point.x + dm     * cos(angle);
+            vertices[6*i + 5] = point.y + dm     * sin(angle);
+        }
 
-                        // color
-                        if (Util::config()->vectorColor)
-                        {
-                            double color = 0.7 - 0.7 * (value - vectorRangeMin) * irange;
-                            glColor3f(color, color, color);
-                        }
-                        else
-                        {
-                            glColor3f(Util::config()->colorVectors.redF(),
-                                      Util::config()->colorVectors.greenF(),
-                                      Util::config()->colorVectors.blueF());
-                        }
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-                        glVertex2d(point.x + dm/5.0 * cos(angle - M_PI_2), point.y + dm/5.0 * sin(angle - M_PI_2));
-                        glVertex2d(point.x + dm/5.0 * cos(angle + M_PI_2), point.y + dm/5.0 * sin(angle + M_PI_2));
-                        glVertex2d(point.x + dm     * cos(angle),          point.y + dm     * sin(angle));
-                    }
-                }
-            }
-        }
-        glEnd();
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_DOUBLE, 0, vertices.constData());
+        glColorPointer(3, GL_FLOAT, 0, colors.constData());
+        glDrawArrays(GL_TRIANGLES, 0, 3 * glyphs.count());
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
 
         glDisable(GL_POLYGON_OFFSET_FILL);
 
-        m_scene->sceneSolution()->vecVectorView().unlock_data();
-
         glEndList();
 
         glCallList(m_listVectors);
@@ -2511,7 +2417,8 @@ void SceneView::mousePressEvent(QMouseEvent *event)
                             if (edgeAdded == edge) m_scene->undoStack()->push(new SceneEdgeCommandAdd(edge->nodeStart->point,
                                                                                                       edge->nodeEnd->point,
                                                                                                       edge->marker->name,
-                                                                                                      edge->angle));
+                                                                                                      edge->angle,
+                                                                                                      edge->meshSize));
                         }
 
                         m_nodeLast->isSelected = false;
@@ -3005,16 +2912,19 @@ void SceneView::timeStepChanged(bool showViewProgress)
 
     if (!Util::scene()->sceneSolution()->isSolving())
     {
-        if (showViewProgress)
+        ProgressItemProcessView *progressItemProcessView = new ProgressItemProcessView();
+
+        // all visible views are cached
+        if (showViewProgress && progressItemProcessView->steps() > 0)
         {
             ProgressDialog progressDialog;
-            progressDialog.appendProgressItem(new ProgressItemProcessView());
+            progressDialog.appendProgressItem(progressItemProcessView);
             progressDialog.run();
         }
         else
         {
-            ProgressItemProcessView progressItemProcessView;
-            progressItemProcessView.run();
+            progressItemProcessView->run();
+            delete progressItemProcessView;
         }
     }
 
@@ -3207,79 +3117,40 @@ void SceneView::selectRegion(const Point &start, const Point &end)
 {
     m_scene->selectNone();
 
+    RectPoint rect(start, end);
+
     switch (m_sceneMode)
     {
     case SceneMode_OperateOnNodes:
-        foreach (SceneNode *node, m_scene->nodes)
-            if (node->point.x >= start.x && node->point.x <= end.x && node->point.y >= start.y && node->point.y <= end.y)
-                node->isSelected = true;
+        foreach (SceneNode *node, m_scene->sceneIndex()->nodes(rect))
+            node->isSelected = true;
         break;
     case SceneMode_OperateOnEdges:
-        foreach (SceneEdge *edge, m_scene->edges)
+        foreach (SceneEdge *edge, m_scene->sceneIndex()->edges(rect))
             if (edge->nodeStart->point.x >= start.x && edge->nodeStart->point.x <= end.x && edge->nodeStart->point.y >= start.y && edge->nodeStart->point.y <= end.y &&
                 edge->nodeEnd->point.x >= start.x && edge->nodeEnd->point.x <= end.x && edge->nodeEnd->point.y >= start.y && edge->nodeEnd->point.y <= end.y)
                 edge->isSelected = true;
         break;
     case SceneMode_OperateOnLabels:
-        foreach (SceneLabel *label, m_scene->labels)
-            if (label->point.x >= start.x && label->point.x <= end.x && label->point.y >= start.y && label->point.y <= end.y)
-                label->isSelected = true;
+        foreach (SceneLabel *label, m_scene->sceneIndex()->labels(rect))
+            label->isSelected = true;
         break;
     }
 }
 
 SceneNode *SceneView::findClosestNode(const Point &point)
 {
-    SceneNode *nodeClosest = NULL;
-
-    double distance = CONST_DOUBLE;
-    foreach (SceneNode *node, m_scene->nodes)
-    {
-        double nodeDistance = node->distance(point);
-        if (node->distance(point) < distance)
-        {
-            distance = nodeDistance;
-            nodeClosest = node;
-        }
-    }
-
-    return nodeClosest;
+    return m_scene->sceneIndex()->closestNode(point);
 }
 
 SceneEdge *SceneView::findClosestEdge(const Point &point)
 {
-    SceneEdge *edgeClosest = NULL;
-
-    double distance = CONST_DOUBLE;
-    foreach (SceneEdge *edge, m_scene->edges)
-    {
-        double edgeDistance = edge->distance(point);
-        if (edge->distance(point) < distance)
-        {
-            distance = edgeDistance;
-            edgeClosest = edge;
-        }
-    }
-
-    return edgeClosest;
+    return m_scene->sceneIndex()->closestEdge(point);
 }
 
 SceneLabel *SceneView::findClosestLabel(const Point &point)
 {
-    SceneLabel *labelClosest = NULL;
-
-    double distance = CONST_DOUBLE;
-    foreach (SceneLabel *label, m_scene->labels)
-    {
-        double labelDistance = label->distance(point);
-        if (label->distance(point) < distance)
-        {
-            distance = labelDistance;
-            labelClosest = label;
-        }
-    }
-
-    return labelClosest;
+    return m_scene->sceneIndex()->closestLabel(point);
 }
 
 void SceneView::drawArc(const Point &point, double r, double startAngle, double arcAngle, int segments)
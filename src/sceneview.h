@@ -242,11 +242,11 @@ private:
     void paintInitialMesh();
 
     void paintContours(); // paint scalar field contours
-    void paintContoursTri(double3* vert, int3* tri, double step);
     void paintVectors(); // paint vector field vectors
     void paintSolutionMesh();
 
     void paintScalarField(); // paint scalar field surface
+    void paintScalarFieldTriangles(Linearizer &linearizer, double irange, ScalarViewTiles *tiles = NULL);
     void paintScalarField3D(); // paint scalar field 3d surface
     void paintScalarField3DSolid(); // paint scalar field 3d solid
     void paintScalarFieldColorBar(double min, double max);
@@ -288,6 +288,7 @@ private slots:
     void doShowGroup(QAction *action);
     void doPostprocessorModeGroup(QAction *action);
     void clearGLLists();
+    void doScalarViewRefined();
 };
 
 #endif // SCENEVIEW_H
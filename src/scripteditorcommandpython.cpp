@@ -26,6 +26,9 @@
 #include "scene.h"
 #include "scenemarker.h"
 #include "scripteditordialog.h"
+#include "parametersweep.h"
+#include "movingband.h"
+#include "hermes2d/checkpoint.h"
 
 // FIX ********************************************************************************************************************************************************************
 // Terible, is it possible to write this code better???
@@ -76,7 +79,7 @@ char *pythonInput(char *str)
 char *pythonMeshFileName()
 {
     if (Util::scene()->sceneSolution()->isMeshed())
-        return const_cast<char*>(QString(tempProblemFileName() + ".mesh").toStdString().c_str());
+        return const_cast<char*>(spillScratchContent("mesh").toStdString().c_str());
     else
         throw invalid_argument(QObject::tr("Problem is not meshed.").toStdString());
 }
@@ -214,6 +217,56 @@ void pythonSaveDocument(char *str)
         throw invalid_argument(result.message().toStdString());
 }
 
+// discretization(numberofrefinements, polynomialorder)
+void pythonDiscretization(int numberofrefinements, int polynomialorder)
+{
+    // numberofrefinements
+    if (numberofrefinements < 0)
+        throw out_of_range(QObject::tr("Number of refinements '%1' is out of range.").arg(numberofrefinements).toStdString());
+
+    // polynomialorder
+    if (polynomialorder < 1 || polynomialorder > 10)
+        throw out_of_range(QObject::tr("Polynomial order '%1' is out of range.").arg(polynomialorder).toStdString());
+
+    Util::scene()->problemInfo()->numberOfRefinements = numberofrefinements;
+    Util::scene()->problemInfo()->polynomialOrder = polynomialorder;
+
+    // solution does not correspond to the discretization
+    Util::scene()->sceneSolution()->clear();
+}
+
+// timestepmethod(method, tolerance = 1.0)
+void pythonTimeStepMethod(char *method, double tolerance)
+{
+    // method
+    TimeStepMethod timeStepMethod = timeStepMethodFromStringKey(QString(method));
+    if (timeStepMethod == TimeStepMethod_Undefined)
+        throw invalid_argument(QObject::tr("Time step method '%1' is not implemented.").arg(QString(method)).toStdString());
+
+    // tolerance
+    if (tolerance <= 0)
+        throw out_of_range(QObject::tr("Time step tolerance '%1' is out of range.").arg(tolerance).toStdString());
+
+    Util::scene()->problemInfo()->timeStepMethod = timeStepMethod;
+    Util::scene()->problemInfo()->timeStepTolerance = tolerance;
+
+    // solution does not correspond to the time steps
+    Util::scene()->sceneSolution()->clear();
+}
+
+// matrixsolver(solver)
+void pythonMatrixSolver(char *solver)
+{
+    MatrixCommonSolverType matrixCommonSolverType = matrixCommonSolverTypeFromStringKey(QString(solver));
+    if (matrixCommonSolverType == MatrixCommonSolverType_Undefined)
+        throw invalid_argument(QObject::tr("Matrix solver '%1' is not implemented.").arg(QString(solver)).toStdString());
+
+    Util::scene()->problemInfo()->matrixCommonSolverType = matrixCommonSolverType;
+
+    // solution does not correspond to the solver
+    Util::scene()->sceneSolution()->clear();
+}
+
 // addnode(x, y)
 void pythonAddNode(double x, double y)
 {
@@ -232,12 +285,15 @@ void pythonDeleteNodePoint(double x, double y)
     Util::scene()->removeNode(Util::scene()->getNode(Point(x, y)));
 }
 
-// addedge(x1, y1, x2, y2, angle = 0, marker = "none")
-void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, char *marker)
+// addedge(x1, y1, x2, y2, angle = 0, marker = "none", meshsize = 0)
+void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, char *marker, double meshSize)
 {
     if (angle > 180.0 || angle < 0.0)
         throw out_of_range(QObject::tr("Angle '%1' is out of range.").arg(angle).toStdString());
 
+    if (meshSize < 0.0)
+        throw out_of_range(QObject::tr("Mesh size '%1' is out of range.").arg(meshSize).toStdString());
+
     SceneEdgeMarker *edgeMarker = Util::scene()->getEdgeMarker(QString(marker));
     if (!edgeMarker)
         throw invalid_argument(QObject::tr("Marker '%1' is not defined.").arg(marker).toStdString());
@@ -247,7 +303,9 @@ void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, cha
     // end node
     SceneNode *nodeEnd = Util::scene()->addNode(new SceneNode(Point(x2, y2)));
 
-    Util::scene()->addEdge(new SceneEdge(nodeStart, nodeEnd, edgeMarker, angle));
+    SceneEdge *edge = new SceneEdge(nodeStart, nodeEnd, edgeMarker, angle);
+    edge->meshSize = meshSize;
+    Util::scene()->addEdge(edge);
 }
 
 void pythonDeleteEdge(int index)
@@ -284,6 +342,21 @@ void pythonDeleteLabelPoint(double x, double y)
     Util::scene()->removeLabel(Util::scene()->getLabel(Point(x, y)));
 }
 
+// beginbatch()
+void pythonBeginBatch()
+{
+    Util::scene()->beginBatch(QObject::tr("Script"));
+}
+
+// commitbatch()
+void pythonCommitBatch()
+{
+    if (!Util::scene()->isBatch())
+        throw invalid_argument(QObject::tr("Batch is not open.").toStdString());
+
+    Util::scene()->commitBatch();
+}
+
 // addboundary(name, type, value, ...)
 static PyObject *pythonAddBoundary(PyObject *self, PyObject *args)
 {
@@ -544,6 +617,66 @@ void pythonSolve()
     }
 }
 
+// resume()
+void pythonSolveResume()
+{
+    if (Util::scene()->problemInfo()->analysisType != AnalysisType_Transient)
+        throw invalid_argument(QObject::tr("Only transient solve can be resumed.").toStdString());
+
+    Checkpoint checkpoint(Checkpoint::checkpointFileName());
+    if (!checkpoint.readHeader())
+        throw invalid_argument(checkpoint.error().toStdString());
+
+    Util::scene()->sceneSolution()->solve(SolverMode_Resume);
+    if (Util::scene()->sceneSolution()->isSolved())
+    {
+        sceneView()->actSceneModePostprocessor->trigger();
+        Util::scene()->refresh();
+    }
+}
+
+// movingband(x, y, rinner, router)
+void pythonMovingBand(double x, double y, double radiusInner, double radiusOuter)
+{
+    if (!Util::scene()->sceneSolution()->isMeshed())
+        throw invalid_argument(QObject::tr("Problem is not meshed.").toStdString());
+
+    MovingBand *movingBand = new MovingBand(readScratchContent("mesh"), Point(x, y), radiusInner, radiusOuter);
+    if (!movingBand->isValid())
+    {
+        QString error = movingBand->error();
+        delete movingBand;
+        throw invalid_argument(error.toStdString());
+    }
+
+    Util::scene()->sceneSolution()->setMovingBand(movingBand);
+}
+
+// solverotor(angle)
+int pythonSolveRotor(double angle)
+{
+    MovingBand *movingBand = Util::scene()->sceneSolution()->movingBand();
+    if (!movingBand)
+        throw invalid_argument(QObject::tr("Moving band is not defined.").toStdString());
+
+    QByteArray mesh = movingBand->mesh(angle);
+    if (mesh.isEmpty())
+        throw invalid_argument(movingBand->error().toStdString());
+
+    // rotor and stator meshes are kept, only the band is deformed or re-triangulated
+    writeScratchContent("mesh", mesh);
+    Util::scene()->sceneSolution()->setMeshInitial(readMeshFromString(mesh));
+
+    Util::scene()->sceneSolution()->solve(SolverMode_Solve);
+    if (Util::scene()->sceneSolution()->isSolved())
+    {
+        sceneView()->actSceneModePostprocessor->trigger();
+        Util::scene()->refresh();
+    }
+
+    return movingBand->remeshCount();
+}
+
 // zoombestfit()
 void pythonZoomBestFit()
 {
@@ -736,6 +869,42 @@ static PyObject *pythonVolumeIntegral(PyObject *self, PyObject *args)
     return NULL;
 }
 
+// solveinfo()
+static PyObject *pythonSolveInfo(PyObject *self, PyObject *args)
+{
+    if (Util::scene()->sceneSolution()->isSolved())
+    {
+        SolverInfo &solverInfo = Util::scene()->sceneSolution()->solverInfo();
+
+        // PyDict_SetItemString() does not steal the reference of the value
+        PyObject *dict = PyDict_New();
+        PyObject *value;
+        for (int i = 0; i < solverInfo.phases().count(); i++)
+        {
+            value = Py_BuildValue("d", solverInfo.phases()[i].time);
+            PyDict_SetItemString(dict, solverInfo.path(i).toStdString().c_str(), value);
+            Py_DECREF(value);
+        }
+        for (int i = 0; i < solverInfo.counters().count(); i++)
+        {
+            value = Py_BuildValue("d", solverInfo.counters()[i].second);
+            PyDict_SetItemString(dict, solverInfo.counters()[i].first.toStdString().c_str(), value);
+            Py_DECREF(value);
+        }
+        // norm of the solution (checksum for comparison of the runs)
+        value = Py_BuildValue("d", calc_norm(Util::scene()->sceneSolution()->sln(), H2D_H1_NORM));
+        PyDict_SetItemString(dict, "norm", value);
+        Py_DECREF(value);
+
+        return dict;
+    }
+    else
+    {
+        PyErr_SetString(PyExc_RuntimeError, QObject::tr("Problem is not solved.").toStdString().c_str());
+    }
+    return NULL;
+}
+
 // showscalar(type = { "none", "scalar", "scalar3d", "order" }, variable, component, rangemin, rangemax)
 void pythonShowScalar(char *type, char *variable, char *component, int rangemin, int rangemax)
 {
@@ -850,6 +1019,111 @@ void pythonSaveImage(char *str, int w, int h)
         throw invalid_argument(result.message().toStdString());
 }
 
+// savecontours(filename)
+void pythonSaveContours(char *str)
+{
+    if (!Util::scene()->sceneSolution()->isSolved())
+        throw invalid_argument(QObject::tr("Problem is not solved.").toStdString());
+
+    // contour view is processed only if it is shown
+    Util::scene()->sceneSolution()->processRangeContour();
+
+    ErrorResult result = Util::scene()->sceneSolution()->contours().exportToFile(QString(str));
+    if (result.isError())
+        throw invalid_argument(result.message().toStdString());
+}
+
+// result = sweep(script, [{"name" : value, ...}, ...], workers, timeout)
+static PyObject *pythonSweep(PyObject *self, PyObject *args)
+{
+    char *script = NULL;
+    PyObject *parameters = NULL;
+    int workers = 0;
+    int timeout = 0;
+    if (PyArg_ParseTuple(args, "sO|ii", &script, &parameters, &workers, &timeout))
+    {
+        if (!PyList_Check(parameters))
+        {
+            PyErr_SetString(PyExc_TypeError, QObject::tr("Parameters must be a list of dictionaries.").toStdString().c_str());
+            return NULL;
+        }
+
+        ParameterSweep parameterSweep(QString(script), workers, timeout);
+        for (int i = 0; i < PyList_Size(parameters); i++)
+        {
+            PyObject *dict = PyList_GetItem(parameters, i);
+            if (!PyDict_Check(dict))
+            {
+                PyErr_SetString(PyExc_TypeError, QObject::tr("Parameters must be a list of dictionaries.").toStdString().c_str());
+                return NULL;
+            }
+
+            // name = repr(value)
+            QString assignments;
+            PyObject *key, *value;
+            Py_ssize_t pos = 0;
+            while (PyDict_Next(dict, &pos, &key, &value))
+            {
+                PyObject *repr = PyObject_Repr(value);
+                if (!PyString_Check(key) || !repr)
+                {
+                    Py_XDECREF(repr);
+                    PyErr_SetString(PyExc_TypeError, QObject::tr("Parameter names must be strings.").toStdString().c_str());
+                    return NULL;
+                }
+                assignments.append(QString("%1 = %2\n").arg(PyString_AsString(key)).arg(PyString_AsString(repr)));
+                Py_DECREF(repr);
+            }
+
+            parameterSweep.appendRun(assignments);
+        }
+
+        parameterSweep.run();
+
+        // result table
+        PyObject *globals = PyDict_New();
+        PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+
+        PyObject *list = PyList_New(0);
+        foreach (SweepRun sweepRun, parameterSweep.runs())
+        {
+            PyObject *result = NULL;
+            if (!sweepRun.result.isEmpty())
+            {
+                result = PyRun_String(sweepRun.result.toStdString().c_str(), Py_eval_input, globals, globals);
+                if (!result)
+                {
+                    PyErr_Clear();
+                    result = Py_BuildValue("s", sweepRun.result.toStdString().c_str());
+                }
+            }
+            else
+            {
+                Py_INCREF(Py_None);
+                result = Py_None;
+            }
+
+            PyObject *item = PyDict_New();
+            PyDict_SetItemString(item, "parameters", PyList_GetItem(parameters, sweepRun.index));
+            PyDict_SetItemString(item, "result", result);
+            PyObject *error = Py_BuildValue("s", sweepRun.error.toStdString().c_str());
+            PyDict_SetItemString(item, "error", error);
+            PyObject *time = Py_BuildValue("d", sweepRun.elapsedTime / 1000.0);
+            PyDict_SetItemString(item, "time", time);
+            Py_DECREF(result);
+            Py_DECREF(error);
+            Py_DECREF(time);
+
+            PyList_Append(list, item);
+            Py_DECREF(item);
+        }
+        Py_DECREF(globals);
+
+        return list;
+    }
+    return NULL;
+}
+
 // print stdout
 PyObject* pythonCaptureStdout(PyObject* self, PyObject* pArgs)
 {
@@ -873,7 +1147,9 @@ static PyMethodDef pythonMethods[] =
     {"selectlabel", pythonSelectLabel, METH_VARARGS, "selectlabel(index, ...)"},
     {"pointresult", pythonPointResult, METH_VARARGS, "pointresult(x, y)"},
     {"volumeintegral", pythonVolumeIntegral, METH_VARARGS, "volumeintegral(index, ...)"},
+    {"solveinfo", pythonSolveInfo, METH_VARARGS, "solveinfo()"},
     {"surfaceintegral", pythonSurfaceIntegral, METH_VARARGS, "surfaceintegral(index, ...)"},
+    {"sweep", pythonSweep, METH_VARARGS, "sweep(script, parameters, workers = 0, timeout = 0)"},
     {"capturestdout", pythonCaptureStdout, METH_VARARGS, "stdout"},
     {NULL, NULL, 0, NULL}
 };
@@ -1002,6 +1278,10 @@ ScriptResult PythonEngine::runPythonScript(const QString &script, const QString
     }
     Py_DECREF(Py_None);
 
+    // batches left open by the script
+    while (Util::scene()->isBatch())
+        Util::scene()->commitBatch();
+
     m_isRunning = false;
     Util::scene()->refresh();
     sceneView()->doInvalidated();
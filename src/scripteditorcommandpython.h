@@ -71,9 +71,12 @@ void pythonNewDocument(char *name, char *type, char *physicfield,
                        char *analysistype, double timestep, double totaltime, double initialcondition);
 void pythonOpenDocument(char *str);
 void pythonSaveDocument(char *str);
+void pythonDiscretization(int numberofrefinements, int polynomialorder);
+void pythonTimeStepMethod(char *method, double tolerance);
+void pythonMatrixSolver(char *solver);
 
 void pythonAddNode(double x, double y);
-void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, char *marker);
+void pythonAddEdge(double x1, double y1, double x2, double y2, double angle, char *marker, double meshSize);
 void pythonAddLabel(double x, double y, double area, int polynomialOrder, char *marker);
 
 void pythonDeleteNode(int index);
@@ -83,6 +86,9 @@ void pythonDeleteEdgePoint(double x1, double y1, double x2, double y2, double an
 void pythonDeleteLabel(int index);
 void pythonDeleteLabelPoint(double x, double y);
 
+void pythonBeginBatch();
+void pythonCommitBatch();
+
 void pythonSelectNone();
 void pythonSelectAll();
 
@@ -97,6 +103,9 @@ void pythonDeleteSelection();
 
 void pythonMesh();
 void pythonSolve();
+void pythonSolveResume();
+void pythonMovingBand(double x, double y, double radiusInner, double radiusOuter);
+int pythonSolveRotor(double angle);
 
 void pythonZoomBestFit();
 void pythonZoomIn();
@@ -118,5 +127,6 @@ void pythonSetTimeStep(int timestep);
 int pythonTimeStepCount();
 
 void pythonSaveImage(char *str, int w, int h);
+void pythonSaveContours(char *str);
 
 #endif // SCRIPTEDITORCOMMANDPYTHON_H
@@ -122,13 +122,16 @@ QString createPythonFromModel()
         str += "# edges\n";
         for (int i = 0; i<Util::scene()->edges.count(); i++)
         {
-            str += QString("addedge(%1, %2, %3, %4, %5, \"%6\")").
+            str += QString("addedge(%1, %2, %3, %4, %5, \"%6\"").
                    arg(Util::scene()->edges[i]->nodeStart->point.x).
                    arg(Util::scene()->edges[i]->nodeStart->point.y).
                    arg(Util::scene()->edges[i]->nodeEnd->point.x).
                    arg(Util::scene()->edges[i]->nodeEnd->point.y).
                    arg(Util::scene()->edges[i]->angle).
-                   arg(Util::scene()->edges[i]->marker->name) + "\n";
+                   arg(Util::scene()->edges[i]->marker->name);
+            if (Util::scene()->edges[i]->meshSize > 0.0)
+                str += QString(", %1").arg(Util::scene()->edges[i]->meshSize);
+            str += ")\n";
         }
         str += "\n";
     }
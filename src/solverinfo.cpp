@@ -0,0 +1,130 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+
+#include "solverinfo.h"
+
+SolverInfo::SolverInfo()
+{
+    clear();
+}
+
+void SolverInfo::clear()
+{
+    m_phases.clear();
+    m_counters.clear();
+    m_running.clear();
+    m_time.clear();
+}
+
+int SolverInfo::phaseIndex(const QString &name)
+{
+    int parent = m_running.isEmpty() ? -1 : m_running.last();
+
+    for (int i = 0; i < m_phases.count(); i++)
+        if ((m_phases[i].parent == parent) && (m_phases[i].name == name))
+            return i;
+
+    SolverPhase phase;
+    phase.name = name;
+    phase.parent = parent;
+    phase.level = m_running.count();
+    phase.count = 0;
+    phase.time = 0.0;
+    m_phases.append(phase);
+
+    return m_phases.count() - 1;
+}
+
+void SolverInfo::start(const QString &name)
+{
+    m_running.append(phaseIndex(name));
+
+    QTime time;
+    time.start();
+    m_time.append(time);
+}
+
+void SolverInfo::stop()
+{
+    if (m_running.isEmpty())
+        return;
+
+    SolverPhase &phase = m_phases[m_running.takeLast()];
+    phase.count++;
+    phase.time += m_time.takeLast().elapsed() / 1000.0;
+}
+
+void SolverInfo::addPhase(const QString &name, double time)
+{
+    SolverPhase &phase = m_phases[phaseIndex(name)];
+    phase.count++;
+    phase.time += time;
+}
+
+void SolverInfo::setCounter(const QString &name, double value)
+{
+    for (int i = 0; i < m_counters.count(); i++)
+    {
+        if (m_counters[i].first == name)
+        {
+            m_counters[i].second = value;
+            return;
+        }
+    }
+
+    m_counters.append(QPair<QString, double>(name, value));
+}
+
+QString SolverInfo::path(int index) const
+{
+    QString name = m_phases[index].name;
+    for (int i = m_phases[index].parent; i != -1; i = m_phases[i].parent)
+        name = m_phases[i].name + "/" + name;
+
+    return name;
+}
+
+void SolverInfo::appendPhase(QString &out, int parent) const
+{
+    for (int i = 0; i < m_phases.count(); i++)
+    {
+        if (m_phases[i].parent != parent)
+            continue;
+
+        QString name = QString(2 * m_phases[i].level, ' ') + m_phases[i].name;
+        if (m_phases[i].count > 1)
+            name += QString(" (%1x)").arg(m_phases[i].count);
+
+        out += QString("%1 %2 s\n").arg(name, -36).arg(m_phases[i].time, 10, 'f', 3);
+
+        appendPhase(out, i);
+    }
+}
+
+QString SolverInfo::toString() const
+{
+    QString out;
+    appendPhase(out, -1);
+
+    for (int i = 0; i < m_counters.count(); i++)
+        out += QString("%1 %2\n").arg(m_counters[i].first, -36).arg(m_counters[i].second, 10, 'g', 6);
+
+    return out;
+}
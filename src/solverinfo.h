@@ -0,0 +1,70 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef SOLVERINFO_H
+#define SOLVERINFO_H
+
+#include "util.h"
+
+// phase of the solution (time in seconds)
+struct SolverPhase
+{
+    QString name;
+    int parent; // index of the parent phase (-1 for the top level)
+    int level;
+    int count;
+    double time;
+};
+
+// Phases and counters of the last solve (mesh, assembly, matrix solver, adaptivity, ...).
+// Phases are nested, repeated phases (adaptivity or time steps) are accumulated.
+class SolverInfo
+{
+public:
+    SolverInfo();
+
+    void clear();
+
+    void start(const QString &name);
+    void stop();
+    // phase measured elsewhere (e.g. factorization inside the matrix solver), child of the running phase
+    void addPhase(const QString &name, double time);
+
+    void setCounter(const QString &name, double value);
+
+    inline QList<SolverPhase> phases() const { return m_phases; }
+    inline QList<QPair<QString, double> > counters() const { return m_counters; }
+
+    // full name of the phase (e.g. "solve/assembly")
+    QString path(int index) const;
+    QString toString() const;
+
+private:
+    QList<SolverPhase> m_phases;
+    QList<QPair<QString, double> > m_counters;
+
+    // running phases
+    QList<int> m_running;
+    QList<QTime> m_time;
+
+    int phaseIndex(const QString &name);
+    void appendPhase(QString &out, int parent) const;
+};
+
+#endif // SOLVERINFO_H
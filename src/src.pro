@@ -13,6 +13,9 @@ DEFINES += VERSION_GIT=376
 DEFINES += VERSION_YEAR=2010
 DEFINES += VERSION_MONTH=07
 DEFINES += VERSION_DAY=02
+# hermes2d call stack tracing and profile (same as in hermes2d.pro)
+DEFINES += H2D_CALLSTACK
+# DEFINES += H2D_PROFILE
 
 # backup
 # VERSION_GIT=$$system(git log --pretty=format:%h | wc -l)
@@ -42,6 +45,8 @@ SOURCES += util.cpp \
     hermes2d/hermes_current.cpp \
     hermes2d/hermes_elasticity.cpp \
     hermes2d/hermes_flow.cpp \
+    hermes2d/timestepping.cpp \
+    hermes2d/checkpoint.cpp \
     localvalueview.cpp \
     surfaceintegralview.cpp \
     volumeintegralview.cpp \
@@ -73,7 +78,15 @@ SOURCES += util.cpp \
     tooltipview.cpp \
     scenebasicselectdialog.cpp \
     logdialog.cpp \
-    datatabledialog.cpp
+    datatabledialog.cpp \
+    parametersweep.cpp \
+    scalarviewtiles.cpp \
+    contours.cpp \
+    vectorglyphs.cpp \
+    sceneindex.cpp \
+    meshsizefield.cpp \
+    movingband.cpp \
+    solverinfo.cpp
 HEADERS += util.h \
     scene.h \
     gui.h \
@@ -85,6 +98,8 @@ HEADERS += util.h \
     hermes2d/hermes_current.h \
     hermes2d/hermes_elasticity.h \
     hermes2d/hermes_flow.h \
+    hermes2d/timestepping.h \
+    hermes2d/checkpoint.h \
     localvalueview.h \
     surfaceintegralview.h \
     volumeintegralview.h \
@@ -114,7 +129,15 @@ HEADERS += util.h \
     tooltipview.h \
     scenebasicselectdialog.h \
     logdialog.h \
-    datatabledialog.h
+    datatabledialog.h \
+    parametersweep.h \
+    scalarviewtiles.h \
+    contours.h \
+    vectorglyphs.h \
+    sceneindex.h \
+    meshsizefield.h \
+    movingband.h \
+    solverinfo.h
 INCLUDEPATH += . \
     dxflib
 OTHER_FILES += python/agros2d.pyx \
@@ -156,6 +179,7 @@ win32-g++ {
     LIBS += -lpthread
     LIBS += -lqwt
     LIBS += -lpython26
+    LIBS += -lpsapi
 }
 macx-g++ { 
     INCLUDEPATH += /opt/local/include
@@ -21,6 +21,14 @@
 #include "scene.h"
 #include "scripteditordialog.h"
 
+#ifdef Q_WS_WIN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 static QHash<PhysicField, QString> physicFieldList;
 static QHash<PhysicFieldVariable, QString> physicFieldVariableList;
 static QHash<PhysicFieldVariableComp, QString> physicFieldVariableCompList;
@@ -29,6 +37,7 @@ static QHash<SceneViewPostprocessorShow, QString> sceneViewPostprocessorShowList
 static QHash<AdaptivityType, QString> adaptivityTypeList;
 static QHash<AnalysisType, QString> analysisTypeList;
 static QHash<MatrixCommonSolverType, QString> matrixCommonSolverTypeList;
+static QHash<TimeStepMethod, QString> timeStepMethodList;
 
 QString analysisTypeToStringKey(AnalysisType analysisType) { return analysisTypeList[analysisType]; }
 AnalysisType analysisTypeFromStringKey(const QString &analysisType) { return analysisTypeList.key(analysisType); }
@@ -54,6 +63,9 @@ AdaptivityType adaptivityTypeFromStringKey(const QString &adaptivityType) { retu
 QString matrixCommonSolverTypeToStringKey(MatrixCommonSolverType matrixCommonSolverType) { return matrixCommonSolverTypeList[matrixCommonSolverType]; }
 MatrixCommonSolverType matrixCommonSolverTypeFromStringKey(const QString &matrixCommonSolverType) { return matrixCommonSolverTypeList.key(matrixCommonSolverType); }
 
+QString timeStepMethodToStringKey(TimeStepMethod timeStepMethod) { return timeStepMethodList[timeStepMethod]; }
+TimeStepMethod timeStepMethodFromStringKey(const QString &timeStepMethod) { return timeStepMethodList.key(timeStepMethod); }
+
 void initLists()
 {
     analysisTypeList.insert(AnalysisType_Undefined, "");
@@ -185,6 +197,13 @@ void initLists()
     matrixCommonSolverTypeList.insert(MatrixCommonSolverType_SparseLib_GeneralizedMinimumResidual, "sparselib_gmres");
     matrixCommonSolverTypeList.insert(MatrixCommonSolverType_SparseLib_QuasiMinimalResidual, "sparselib_qmr");
     matrixCommonSolverTypeList.insert(MatrixCommonSolverType_SparseLib_RichardsonIterativeRefinement, "sparselib_rir");
+    matrixCommonSolverTypeList.insert(MatrixCommonSolverType_SaddlePoint, "saddlepoint");
+
+    // TIMESTEPMETHOD
+    timeStepMethodList.insert(TimeStepMethod_Undefined, "");
+    timeStepMethodList.insert(TimeStepMethod_Fixed, "fixed");
+    timeStepMethodList.insert(TimeStepMethod_BDF2, "bdf2");
+    timeStepMethodList.insert(TimeStepMethod_BDF2Adaptive, "bdf2adaptive");
 }
 
 QString physicFieldVariableString(PhysicFieldVariable physicFieldVariable)
@@ -684,12 +703,30 @@ QString matrixCommonSolverTypeString(MatrixCommonSolverType matrixSolverType)
         return QObject::tr("SparseLib++ QMR");
     case MatrixCommonSolverType_SparseLib_RichardsonIterativeRefinement:
         return QObject::tr("SparseLib++ RIR");
+    case MatrixCommonSolverType_SaddlePoint:
+        return QObject::tr("Block saddle point (GMRES)");
     default:
         std::cerr << "SolverMatrix type '" + QString::number(matrixSolverType).toStdString() + "' is not implemented. matrixSolverTypeString(MatrixSolverType matrixSolverType)" << endl;
         throw;
     }
 }
 
+QString timeStepMethodString(TimeStepMethod timeStepMethod)
+{
+    switch (timeStepMethod)
+    {
+    case TimeStepMethod_Fixed:
+        return QObject::tr("Implicit Euler");
+    case TimeStepMethod_BDF2:
+        return QObject::tr("BDF2");
+    case TimeStepMethod_BDF2Adaptive:
+        return QObject::tr("BDF2 (adaptive step)");
+    default:
+        std::cerr << "Time step method '" + QString::number(timeStepMethod).toStdString() + "' is not implemented. timeStepMethodString(TimeStepMethod timeStepMethod)" << endl;
+        throw;
+    }
+}
+
 void fillComboBoxPhysicField(QComboBox *cmbPhysicField)
 {
     cmbPhysicField->clear();
@@ -823,9 +860,23 @@ QString datadir()
 
 QString tempProblemDir()
 {
-    QDir(QDir::temp().absolutePath()).mkpath("agros2d/" + QString::number(QApplication::applicationPid()));
+    static QString root;
+    if (root.isEmpty())
+    {
+        // AGROS2D_TEMP, tmpfs (linux) or system temp
+        root = QString(getenv("AGROS2D_TEMP"));
+#ifdef Q_WS_X11
+        if (root.isEmpty() && QFileInfo("/dev/shm").isDir() && QFileInfo("/dev/shm").isWritable())
+            root = "/dev/shm";
+#endif
+        if (root.isEmpty())
+            root = QDir::temp().absolutePath();
+    }
 
-    return QString("%1/agros2d/%2").arg(QDir::temp().absolutePath()).arg(QApplication::applicationPid());
+    // instances are separated by pid
+    QDir(root).mkpath("agros2d/" + QString::number(QApplication::applicationPid()));
+
+    return QString("%1/agros2d/%2").arg(root).arg(QApplication::applicationPid());
 }
 
 QString tempProblemFileName()
@@ -833,6 +884,88 @@ QString tempProblemFileName()
     return tempProblemDir() + "/temp";
 }
 
+QString triangleBinary()
+{
+    QString triangleBinary = "triangle";
+    if (QFile::exists(QApplication::applicationDirPath() + QDir::separator() + "triangle.exe"))
+        triangleBinary = "\"" + QApplication::applicationDirPath() + QDir::separator() + "triangle.exe\"";
+    if (QFile::exists(QApplication::applicationDirPath() + QDir::separator() + "triangle"))
+        triangleBinary = QApplication::applicationDirPath() + QDir::separator() + "triangle";
+
+    return triangleBinary;
+}
+
+double peakMemoryUsage()
+{
+#ifdef Q_WS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize / 1024.0 / 1024.0;
+    return 0.0;
+#else
+#ifdef Q_OS_LINUX
+    // high water mark, it can be reset by writing "5" to /proc/self/clear_refs (ru_maxrss cannot)
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly))
+    {
+        // kilobytes
+        QByteArray line;
+        while (!(line = file.readLine()).isEmpty())
+            if (line.startsWith("VmHWM:"))
+                return line.mid(6).trimmed().split(' ').first().toDouble() / 1024.0;
+    }
+#endif
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0.0;
+#ifdef Q_WS_MAC
+    // bytes
+    return usage.ru_maxrss / 1024.0 / 1024.0;
+#else
+    // kilobytes
+    return usage.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+static QMap<QString, QByteArray> scratchContent;
+static QMutex scratchMutex;
+
+void writeScratchContent(const QString &name, const QByteArray &content)
+{
+    QMutexLocker locker(&scratchMutex);
+    scratchContent[name] = content;
+}
+
+QByteArray readScratchContent(const QString &name)
+{
+    QMutexLocker locker(&scratchMutex);
+    return scratchContent.value(name);
+}
+
+bool scratchContains(const QString &name)
+{
+    QMutexLocker locker(&scratchMutex);
+    return scratchContent.contains(name);
+}
+
+void removeScratchContent(const QString &name)
+{
+    QMutexLocker locker(&scratchMutex);
+    scratchContent.remove(name);
+    QFile::remove(tempProblemFileName() + "." + name);
+}
+
+QString spillScratchContent(const QString &name)
+{
+    QString fileName = tempProblemFileName() + "." + name;
+    if (scratchContains(name))
+        writeStringContentByteArray(fileName, readScratchContent(name));
+
+    return fileName;
+}
+
 QTime milisecondsToTime(int ms)
 {
     // store the current ms remaining
@@ -95,6 +95,21 @@ QString tempProblemDir();
 // get temp filename
 QString tempProblemFileName();
 
+// triangle executable (application directory or path)
+QString triangleBinary();
+
+// peak memory usage of the process (MB), on Linux since the last reset of the high water mark
+double peakMemoryUsage();
+
+// in-memory scratch for intermediate files (key is the suffix, e.g. "mesh")
+void writeScratchContent(const QString &name, const QByteArray &content);
+QByteArray readScratchContent(const QString &name);
+bool scratchContains(const QString &name);
+void removeScratchContent(const QString &name);
+
+// write scratch content to tempProblemFileName() + "." + name
+QString spillScratchContent(const QString &name);
+
 // convert time in ms to QTime
 QTime milisecondsToTime(int ms);
 
@@ -331,7 +346,9 @@ private:
 enum SolverMode
 {
     SolverMode_Mesh,
-    SolverMode_MeshAndSolve
+    SolverMode_MeshAndSolve,
+    SolverMode_Solve, // current mesh is kept
+    SolverMode_Resume // transient solve continues from the checkpoint
 };
 
 enum MatrixCommonSolverType
@@ -347,7 +364,8 @@ enum MatrixCommonSolverType
     MatrixCommonSolverType_SparseLib_Chebyshev,
     MatrixCommonSolverType_SparseLib_GeneralizedMinimumResidual,
     MatrixCommonSolverType_SparseLib_QuasiMinimalResidual,
-    MatrixCommonSolverType_SparseLib_RichardsonIterativeRefinement
+    MatrixCommonSolverType_SparseLib_RichardsonIterativeRefinement,
+    MatrixCommonSolverType_SaddlePoint
 };
 
 enum ProblemType
@@ -372,6 +390,14 @@ enum AnalysisType
     AnalysisType_Harmonic
 };
 
+enum TimeStepMethod
+{
+    TimeStepMethod_Undefined,
+    TimeStepMethod_Fixed, // implicit Euler
+    TimeStepMethod_BDF2,
+    TimeStepMethod_BDF2Adaptive
+};
+
 enum AdaptivityType
 {
     AdaptivityType_Undefined = 1000,
@@ -585,6 +611,7 @@ QString problemTypeString(ProblemType problemType);
 QString linearityString(Linearity problemLinearity);
 QString adaptivityTypeString(AdaptivityType adaptivityType);
 QString matrixCommonSolverTypeString(MatrixCommonSolverType matrixCommonSolverType);
+QString timeStepMethodString(TimeStepMethod timeStepMethod);
 
 // keys
 void initLists();
@@ -619,4 +646,7 @@ AdaptivityType adaptivityTypeFromStringKey(const QString &adaptivityType);
 QString matrixCommonSolverTypeToStringKey(MatrixCommonSolverType matrixCommonSolverType);
 MatrixCommonSolverType matrixCommonSolverTypeFromStringKey(const QString &matrixCommonSolverType);
 
+QString timeStepMethodToStringKey(TimeStepMethod timeStepMethod);
+TimeStepMethod timeStepMethodFromStringKey(const QString &timeStepMethod);
+
 #endif // UTIL_H
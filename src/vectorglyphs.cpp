@@ -0,0 +1,156 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#include "vectorglyphs.h"
+
+VectorGlyphs::VectorGlyphs()
+{
+    clear();
+}
+
+void VectorGlyphs::clear()
+{
+    m_count = 0;
+    m_gridStep = 0.0;
+
+    m_glyphs.clear();
+}
+
+void VectorGlyphs::process(Vectorizer *vectorizer, const RectPoint &rect, int count)
+{
+    clear();
+    m_count = count;
+
+    RectPoint box = rect;
+    if (count < 1 || box.width() + box.height() <= 0.0)
+        return;
+
+    // grid step, odd rows are shifted by gs/2
+    double gs = (box.width() + box.height()) / count;
+    m_gridStep = gs;
+
+    vectorizer->lock_data();
+
+    double4* vecVert = vectorizer->get_vertices();
+    int3* vecTris = vectorizer->get_triangles();
+    int nv = vectorizer->get_num_vertices();
+    int nt = vectorizer->get_num_triangles();
+
+    if (nt == 0)
+    {
+        vectorizer->unlock_data();
+        return;
+    }
+
+    // grid over the vertices
+    double minX =  CONST_DOUBLE;
+    double maxX = -CONST_DOUBLE;
+    double minY =  CONST_DOUBLE;
+    double maxY = -CONST_DOUBLE;
+    for (int i = 0; i < nv; i++)
+    {
+        minX = qMin(minX, vecVert[i][0]);
+        maxX = qMax(maxX, vecVert[i][0]);
+        minY = qMin(minY, vecVert[i][1]);
+        maxY = qMax(maxY, vecVert[i][1]);
+    }
+
+    int jmin = floor(minX / gs) - 1;
+    int kmin = floor(minY / gs);
+    int nj = ceil(maxX / gs) - jmin + 1;
+    int nk = ceil(maxY / gs) - kmin + 1;
+
+    // index of the triangle containing the grid point
+    QVector<int> pointTriangle(nj * nk, -1);
+    for (int i = 0; i < nt; i++)
+    {
+        Point a(vecVert[vecTris[i][0]][0], vecVert[vecTris[i][0]][1]);
+        Point b(vecVert[vecTris[i][1]][0], vecVert[vecTris[i][1]][1]);
+        Point c(vecVert[vecTris[i][2]][0], vecVert[vecTris[i][2]][1]);
+
+        double x0 = qMin(qMin(a.x, b.x), c.x);
+        double x1 = qMax(qMax(a.x, b.x), c.x);
+        double y0 = qMin(qMin(a.y, b.y), c.y);
+        double y1 = qMax(qMax(a.y, b.y), c.y);
+
+        // grid points in the bounding box (most of the triangles have none)
+        for (int k = qMax(int(ceil(y0 / gs)), kmin); k <= qMin(int(floor(y1 / gs)), kmin + nk - 1); k++)
+        {
+            double shift = (k % 2 == 0) ? gs/2.0 : 0.0;
+            for (int j = qMax(int(ceil((x0 - shift) / gs)), jmin); j <= qMin(int(floor((x1 - shift) / gs)), jmin + nj - 1); j++)
+            {
+                int index = (k - kmin) * nj + (j - jmin);
+                if (pointTriangle[index] != -1)
+                    continue;
+
+                Point point(j*gs + shift, k*gs);
+
+                // find in triangle
+                bool inTriangle = true;
+                for (int l = 0; l < 3; l++)
+                {
+                    int p = (l + 1) % 3;
+
+                    double z = (vecVert[vecTris[i][p]][0] - vecVert[vecTris[i][l]][0]) * (point.y - vecVert[vecTris[i][l]][1]) -
+                               (vecVert[vecTris[i][p]][1] - vecVert[vecTris[i][l]][1]) * (point.x - vecVert[vecTris[i][l]][0]);
+
+                    if (z < 0)
+                    {
+                        inTriangle = false;
+                        break;
+                    }
+                }
+
+                if (inTriangle)
+                    pointTriangle[index] = i;
+            }
+        }
+    }
+
+    // interpolation (plane equation)
+    for (int index = 0; index < pointTriangle.count(); index++)
+    {
+        int i = pointTriangle[index];
+        if (i == -1)
+            continue;
+
+        int k = index / nj + kmin;
+        int j = index % nj + jmin;
+        Point point(j*gs + ((k % 2 == 0) ? gs/2.0 : 0.0), k*gs);
+
+        Point a(vecVert[vecTris[i][0]][0], vecVert[vecTris[i][0]][1]);
+        Point b(vecVert[vecTris[i][1]][0], vecVert[vecTris[i][1]][1]);
+        Point c(vecVert[vecTris[i][2]][0], vecVert[vecTris[i][2]][1]);
+
+        // double area
+        double area2 = a.x * (b.y - c.y) + b.x * (c.y - a.y) + c.x * (a.y - b.y);
+
+        double aa = (b.x*c.y - c.x*b.y + (b.y - c.y) * point.x + (c.x - b.x) * point.y) / area2;
+        double ab = (c.x*a.y - a.x*c.y + (c.y - a.y) * point.x + (a.x - c.x) * point.y) / area2;
+        double ac = (a.x*b.y - b.x*a.y + (a.y - b.y) * point.x + (b.x - a.x) * point.y) / area2;
+
+        VectorGlyph glyph;
+        glyph.point = point;
+        glyph.dx = aa * vecVert[vecTris[i][0]][2] + ab * vecVert[vecTris[i][1]][2] + ac * vecVert[vecTris[i][2]][2];
+        glyph.dy = aa * vecVert[vecTris[i][0]][3] + ab * vecVert[vecTris[i][1]][3] + ac * vecVert[vecTris[i][2]][3];
+        m_glyphs.append(glyph);
+    }
+
+    vectorizer->unlock_data();
+}
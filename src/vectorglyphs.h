@@ -0,0 +1,55 @@
+// This file is part of Agros2D.
+//
+// Agros2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Agros2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Agros2D.  If not, see <http://www.gnu.org/licenses/>.
+//
+// hp-FEM group (http://hpfem.org/)
+// University of Nevada, Reno (UNR) and University of West Bohemia, Pilsen
+// Email: agros2d@googlegroups.com, home page: http://hpfem.org/agros2d/
+
+#ifndef VECTORGLYPHS_H
+#define VECTORGLYPHS_H
+
+#include "util.h"
+#include "hermes2d.h"
+
+// interpolated vector in the grid point
+struct VectorGlyph
+{
+    Point point;
+    double dx;
+    double dy;
+};
+
+// Vectors of the vector view in the points of a regular (staggered) grid.
+// Every grid point is mapped to one containing triangle of the vectorizer.
+class VectorGlyphs
+{
+public:
+    VectorGlyphs();
+
+    void clear();
+    void process(Vectorizer *vectorizer, const RectPoint &rect, int count);
+
+    inline int count() const { return m_count; }
+    inline double gridStep() const { return m_gridStep; }
+    inline const QVector<VectorGlyph> &glyphs() const { return m_glyphs; }
+
+private:
+    int m_count;
+    double m_gridStep;
+
+    QVector<VectorGlyph> m_glyphs;
+};
+
+#endif // VECTORGLYPHS_H
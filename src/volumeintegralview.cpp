@@ -33,6 +33,7 @@ void VolumeIntegralValue::calculate()
 
     quad = &g_quad_2d_std;
 
+    sln3 = NULL;
     initSolutions();
 
     sln1->set_quad_2d(quad);
@@ -52,6 +53,8 @@ void VolumeIntegralValue::calculate()
                     sln1->set_active_element(e);
                     if (sln2)
                         sln2->set_active_element(e);
+                    if (sln3)
+                        sln3->set_active_element(e);
 
                     ru = sln1->get_refmap();
 
@@ -82,6 +85,13 @@ void VolumeIntegralValue::calculate()
                         sln2->get_dx_dy_values(dudx2, dudy2);
                     }
 
+                    // solution 3
+                    if (sln3)
+                    {
+                        sln3->set_quad_order(o, H2D_FN_VAL);
+                        value3 = sln3->get_fn_values();
+                    }
+
                     update_limit_table(e->get_mode());
 
                     // cross section
@@ -30,7 +30,7 @@ protected:
     Element *e;
 
     double *x, *y;
-    double *value1, *value2;
+    double *value1, *value2, *value3;
     double *dudx1, *dudy1, *dudx2, *dudy2;
 
     Quad2D *quad;
@@ -40,6 +40,8 @@ protected:
 
     Solution *sln1;
     Solution *sln2;
+    // values only (u(n-2) of the transient problem)
+    Solution *sln3;
 
     void calculate();
     virtual void calculateVariables(int i) = 0;